@@ -0,0 +1,98 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmarks/shared.hpp"
+#include "flatbuffers/flatbuffers.h"
+#include "touca/core/deserialize.hpp"
+#include "touca/core/string_table.hpp"
+#include "touca/core/testcase.hpp"
+#include "touca/impl/schema.hpp"
+
+namespace {
+
+/**
+ * Number of values captured for each testcase by `make_testcases`, of
+ * which 70 percent are scalars and 10 percent are arrays of scalars.
+ */
+constexpr unsigned values_per_testcase = 100;
+
+std::vector<touca::Testcase> make_testcases(const std::size_t count) {
+  std::vector<touca::Testcase> testcases;
+  testcases.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    touca::Testcase testcase("acme", "students", "1.0",
+                             "testcase-" + std::to_string(i));
+    for (auto j = 0u; j < 10; ++j) {
+      const auto key = "key-" + std::to_string(j);
+      const auto value = static_cast<std::int64_t>(i * j);
+      testcase.check(key + "-bool", touca::data_point::boolean(value % 2 == 0));
+      testcase.check(key + "-int", touca::data_point::number_signed(-value));
+      testcase.check(key + "-uint", touca::data_point::number_unsigned(j));
+      testcase.check(key + "-float",
+                     touca::data_point::number_float(value / 3.0f));
+      testcase.check(key + "-double",
+                     touca::data_point::number_double(value / 7.0));
+      testcase.check(key + "-count", touca::data_point::number_signed(value));
+      testcase.check(key + "-ratio",
+                     touca::data_point::number_double(value / 9.0));
+      testcase.check(key + "-string",
+                     touca::data_point::string(std::to_string(value)));
+      const auto& name = touca::data_point::string("point-" + key);
+      testcase.check(key + "-object",
+                     touca::object("point").add("x", value).add("name", name));
+      touca::array elements;
+      for (auto k = 0; k < 8; ++k) {
+        elements.add(touca::data_point::number_signed(value + k));
+      }
+      testcase.check(key + "-array", elements);
+    }
+    testcases.push_back(std::move(testcase));
+  }
+  return testcases;
+}
+
+void decode(const std::vector<std::uint8_t>& content) {
+  const auto& messages = touca::fbs::GetMessages(content.data());
+  const touca::detail::StringTable strings(messages);
+  for (const auto&& buffer : *messages->messages()) {
+    const auto& message =
+        flatbuffers::GetRoot<touca::fbs::Message>(buffer->buf()->data());
+    touca::deserialize_testcase(message, strings);
+  }
+}
+
+void run(const std::string& name, const touca::BinaryFormat format,
+         const std::vector<touca::Testcase>& testcases,
+         const std::size_t concurrency = 1) {
+  const auto rounds = 5u;
+  std::vector<std::uint8_t> content;
+  const auto encode = measure_ms(rounds, [&] {
+    content = touca::Testcase::serialize(testcases, format, concurrency);
+  });
+  const auto decode_time = measure_ms(rounds, [&] { decode(content); });
+  const auto values =
+      static_cast<double>(testcases.size()) * values_per_testcase;
+  std::cout << name << ": " << content.size() << " bytes, "
+            << content.size() / values << " bytes per value, encode "
+            << values / encode / 1000.0 << " M values/s, decode "
+            << values / decode_time / 1000.0 << " M values/s" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  const auto count = 1 < argc ? std::stoul(argv[1]) : 1000ul;
+  const auto& testcases = make_testcases(count);
+  std::cout << "testcases: " << count << ", values per testcase: "
+            << values_per_testcase << std::endl;
+  run("v1", touca::BinaryFormat::V1, testcases);
+  run("v2", touca::BinaryFormat::V2, testcases);
+  run("v3", touca::BinaryFormat::V3, testcases);
+  run("v3 (all threads)", touca::BinaryFormat::V3, testcases, 0);
+  return EXIT_SUCCESS;
+}
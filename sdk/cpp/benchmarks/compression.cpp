@@ -0,0 +1,59 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmarks/shared.hpp"
+#include "touca/core/compression.hpp"
+#include "touca/core/testcase.hpp"
+
+namespace {
+
+std::vector<touca::Testcase> make_testcases(const std::size_t count) {
+  std::vector<touca::Testcase> testcases;
+  testcases.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    touca::Testcase testcase("acme", "students", "1.0",
+                             "testcase-" + std::to_string(i));
+    for (auto j = 0; j < 50; ++j) {
+      const auto key = "key-" + std::to_string(j);
+      testcase.check(key, touca::data_point::string("value-" +
+                                                    std::to_string(i * j)));
+      testcase.add_metric(key, static_cast<unsigned>(i + j));
+    }
+    testcases.push_back(std::move(testcase));
+  }
+  return testcases;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (!touca::detail::has_compression()) {
+    std::cerr << "this build of touca does not support compression"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  const auto count = 1 < argc ? std::stoul(argv[1]) : 1000ul;
+  const auto rounds = 10u;
+
+  const auto& content = touca::Testcase::serialize(make_testcases(count));
+  std::vector<std::uint8_t> compressed;
+  const auto encode = measure_ms(rounds, [&] {
+    compressed = touca::detail::compress(content.data(), content.size());
+  });
+  const auto decode = measure_ms(rounds, [&] {
+    touca::detail::decompress(compressed.data(), compressed.size());
+  });
+
+  std::cout << "testcases:         " << count << '\n'
+            << "uncompressed size: " << content.size() << " bytes\n"
+            << "compressed size:   " << compressed.size() << " bytes\n"
+            << "size ratio:        "
+            << static_cast<double>(content.size()) / compressed.size() << '\n'
+            << "compress time:     " << encode << " ms\n"
+            << "decompress time:   " << decode << " ms" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,18 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <chrono>
+
+/**
+ * Average wall-clock time of running a given function, in milliseconds.
+ */
+template <typename Func>
+double measure_ms(const unsigned rounds, Func func) {
+  const auto tic = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < rounds; ++i) {
+    func();
+  }
+  const auto toc = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(toc - tic).count() / rounds;
+}
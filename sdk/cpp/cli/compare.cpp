@@ -5,7 +5,6 @@
 #include "cxxopts.hpp"
 #include "operations.hpp"
 #include "touca/core/comparison.hpp"
-#include "touca/core/deserialize.hpp"
 #include "touca/core/filesystem.hpp"
 
 bool CompareOperation::parse_impl(int argc, char* argv[]) {
@@ -44,8 +43,7 @@ bool CompareOperation::parse_impl(int argc, char* argv[]) {
 
 bool CompareOperation::run_impl() const {
   try {
-    const auto& res = touca::compare(touca::deserialize_file(_src),
-                                     touca::deserialize_file(_dst));
+    const auto& res = touca::compare_files(_src, _dst);
     fmt::print(stdout, "{}\n", res.json());
     return true;
   } catch (const std::exception& ex) {
@@ -0,0 +1,137 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "cxxopts.hpp"
+#include "operations.hpp"
+#include "touca/core/deserialize.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/json_reader.hpp"
+#include "touca/core/json_writer.hpp"
+#include "touca/core/reader.hpp"
+
+namespace {
+
+/**
+ * Format of a given result file, as indicated by its extension, or an
+ * empty string if the format cannot be told.
+ */
+std::string find_format(const std::string& path) {
+  const auto& extension = touca::filesystem::path(path).extension().string();
+  if (extension == ".bin") {
+    return "bin";
+  }
+  if (extension == ".json") {
+    return "json";
+  }
+  if (extension == ".ndjson") {
+    return "ndjson";
+  }
+  return "";
+}
+
+bool is_format(const std::string& format) {
+  return format == "bin" || format == "json" || format == "ndjson";
+}
+
+}  // namespace
+
+bool ConvertOperation::parse_impl(int argc, char* argv[]) {
+  cxxopts::Options options("touca_cli --mode=convert");
+  // clang-format off
+    options.add_options("main")
+        ("src", "result file to convert, use - to read from standard input", cxxopts::value<std::string>())
+        ("out", "file to write converted results to, use - to write to standard output", cxxopts::value<std::string>())
+        ("from", "format of the result file: bin, json or ndjson. inferred from its extension by default", cxxopts::value<std::string>())
+        ("to", "format to convert to: bin, json or ndjson. inferred from the extension of the output file by default", cxxopts::value<std::string>());
+  // clang-format on
+  options.allow_unrecognised_options();
+  const auto& result = options.parse(argc, argv);
+  if (!result.count("src") || !result.count("out")) {
+    print_error("source and output files must be provided\n");
+    fmt::print(stdout, "{}\n", options.help());
+    return false;
+  }
+  _src = result["src"].as<std::string>();
+  _out = result["out"].as<std::string>();
+  _from = result.count("from") ? result["from"].as<std::string>()
+                               : find_format(_src);
+  _to = result.count("to") ? result["to"].as<std::string>() : find_format(_out);
+  if (!is_format(_from) || !is_format(_to)) {
+    print_error("formats must be one of bin, json or ndjson\n");
+    return false;
+  }
+  if (_src != "-" && !touca::filesystem::is_regular_file(_src)) {
+    print_error(touca::detail::format("file `{}` does not exist\n", _src));
+    return false;
+  }
+  return true;
+}
+
+bool ConvertOperation::run_impl() const {
+  using callback_t = std::function<void(const touca::Testcase&)>;
+  const auto& read = [this](const callback_t& callback) {
+    if (_from == "bin" && _src == "-") {
+      touca::for_each_testcase(std::cin, callback);
+    } else if (_from == "bin") {
+      touca::for_each_testcase(_src, callback);
+    } else if (_src == "-") {
+      touca::for_each_json_testcase(std::cin, callback);
+    } else {
+      touca::for_each_json_testcase(_src, callback);
+    }
+  };
+
+  // the binary format stores all testcases under a single root, so the
+  // output is built in memory before it is written.
+
+  if (_to == "bin") {
+    std::vector<touca::Testcase> testcases;
+    read([&testcases](const touca::Testcase& testcase) {
+      testcases.push_back(testcase);
+    });
+    auto content =
+        touca::Testcase::serialize(testcases, touca::BinaryFormat::V1, 0);
+    touca::append_index(content);
+    if (_out != "-") {
+      touca::detail::save_binary_file(_out, content);
+    } else if (std::fwrite(content.data(), 1, content.size(), stdout) !=
+               content.size()) {
+      throw touca::detail::runtime_error("failed to write output");
+    }
+    return true;
+  }
+
+  const auto layout = _to == "ndjson"
+                          ? touca::detail::JsonWriter::Layout::Lines
+                          : touca::detail::JsonWriter::Layout::Array;
+  std::FILE* file = stdout;
+  if (_out != "-") {
+    touca::detail::create_parent_directory(_out);
+    file = std::fopen(_out.c_str(), "wb");
+    if (!file) {
+      throw touca::detail::runtime_error(
+          touca::detail::format("failed to write file {}", _out));
+    }
+  }
+  try {
+    touca::detail::JsonWriter writer(file, layout);
+    read([&writer](const touca::Testcase& testcase) {
+      writer.write(testcase);
+    });
+    writer.finish();
+  } catch (...) {
+    if (file != stdout) {
+      std::fclose(file);
+    }
+    throw;
+  }
+  if (file != stdout && std::fclose(file) != 0) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("failed to write file {}", _out));
+  }
+  return true;
+}
@@ -0,0 +1,197 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "cxxopts.hpp"
+#include "operations.hpp"
+#include "touca/client/detail/client.hpp"
+#include "touca/core/compression.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/reader.hpp"
+#include "touca/core/writer.hpp"
+
+namespace {
+
+/**
+ * Finds the index and the number of shards of a result file written by a
+ * shard of the test runner, from its name `shard-<index>-of-<count>.bin`.
+ */
+bool parse_shard_name(const std::string& name, unsigned& index,
+                      unsigned& count) {
+  int end = 0;
+  return std::sscanf(name.c_str(), "shard-%u-of-%u.bin%n", &index, &count,
+                     &end) == 2 &&
+         static_cast<std::size_t>(end) == name.size();
+}
+
+/**
+ * Lists result files to merge, replacing each given directory with the
+ * shard result files it contains, in the order of their index.
+ */
+std::vector<std::string> list_files(const std::vector<std::string>& sources) {
+  std::vector<std::string> files;
+  for (const auto& source : sources) {
+    if (!touca::filesystem::is_directory(source)) {
+      files.push_back(source);
+      continue;
+    }
+    std::map<std::pair<unsigned, unsigned>, std::string> shards;
+    for (const auto& entry : touca::filesystem::directory_iterator(source)) {
+      unsigned index = 0;
+      unsigned count = 0;
+      if (touca::filesystem::is_regular_file(entry.path()) &&
+          parse_shard_name(entry.path().filename().string(), index, count)) {
+        shards[std::make_pair(count, index)] = entry.path().string();
+      }
+    }
+    for (const auto& kvp : shards) {
+      files.push_back(kvp.second);
+    }
+  }
+  return files;
+}
+
+/**
+ * Describes shards that are missing from a given list of shard result
+ * files, or returns an empty string if the list covers all shards.
+ */
+std::string find_missing_shards(const std::vector<std::string>& files) {
+  std::map<unsigned, std::set<unsigned>> shards;
+  for (const auto& file : files) {
+    unsigned index = 0;
+    unsigned count = 0;
+    const auto& name = touca::filesystem::path(file).filename().string();
+    if (parse_shard_name(name, index, count)) {
+      shards[count].insert(index);
+    }
+  }
+  if (1 < shards.size()) {
+    return "result files belong to runs with different numbers of shards";
+  }
+  std::string missing;
+  for (const auto& kvp : shards) {
+    for (auto i = 0U; i < kvp.first; ++i) {
+      if (!kvp.second.count(i)) {
+        missing += missing.empty() ? "" : ", ";
+        missing += std::to_string(i);
+      }
+    }
+  }
+  if (missing.empty()) {
+    return "";
+  }
+  return touca::detail::format("results of shards {} of {} are missing",
+                               missing, shards.begin()->first);
+}
+
+}  // namespace
+
+bool MergeOperation::parse_impl(int argc, char* argv[]) {
+  cxxopts::Options options("touca_cli --mode=merge");
+  // clang-format off
+    options.add_options("main")
+        ("src", "result files to merge, or directories of result files written by shards of the test runner", cxxopts::value<std::vector<std::string>>())
+        ("out", "file to write merged results to", cxxopts::value<std::string>())
+        ("allow-missing", "merge results even if results of some shards are missing", cxxopts::value<bool>()->default_value("false"))
+        ("binary-format", "binary format to write merged results in: v1, v2 or v3", cxxopts::value<std::string>()->default_value("v1"))
+        ("compress", "compress merged results", cxxopts::value<bool>()->default_value("false"));
+  // clang-format on
+  options.allow_unrecognised_options();
+  const auto& result = options.parse(argc, argv);
+  if (!result.count("src") || !result.count("out")) {
+    print_error("source and output files must be provided\n");
+    fmt::print(stdout, "{}\n", options.help());
+    return false;
+  }
+  _src = result["src"].as<std::vector<std::string>>();
+  _out = result["out"].as<std::string>();
+  _allow_missing = result["allow-missing"].as<bool>();
+  _binary_format = result["binary-format"].as<std::string>();
+  _compress = result["compress"].as<bool>();
+  if (_binary_format != "v1" && _binary_format != "v2" &&
+      _binary_format != "v3") {
+    print_error("binary format must be one of v1, v2 or v3\n");
+    return false;
+  }
+  if (_compress && !touca::detail::has_compression()) {
+    print_error("this build does not support compression\n");
+    return false;
+  }
+  for (const auto& src : _src) {
+    if (!touca::filesystem::exists(src)) {
+      print_error(touca::detail::format("file `{}` does not exist\n", src));
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MergeOperation::run_impl() const {
+  const auto& files = list_files(_src);
+  if (files.empty()) {
+    print_error("found no result files to merge\n");
+    return false;
+  }
+  const auto& missing = find_missing_shards(files);
+  if (!missing.empty() && !_allow_missing) {
+    print_error(touca::detail::format("{}\n", missing));
+    return false;
+  }
+
+  // testcases are copied from each file into the output as they are
+  // stored, so that merging does not hold their decoded content in
+  // memory. a testcase that is found in more than one file is kept as it
+  // was first found. shards of the same run never share testcases, so
+  // this only happens when results of different runs are merged.
+  std::unordered_set<std::string> names;
+  std::size_t duplicates = 0;
+  std::int64_t keys = 0;
+  std::int64_t metrics = 0;
+  std::int64_t duration = 0;
+  const auto& add = [&](touca::detail::MessagesMerger& merger) {
+    for (const auto& file : files) {
+      std::size_t count = 0;
+      const touca::detail::MappedFile content(file);
+      merger.add(content.data(), content.size(),
+                 [&](const touca::TestcaseView& testcase) {
+                   ++count;
+                   if (!names.insert(testcase.metadata().describe()).second) {
+                     ++duplicates;
+                     return false;
+                   }
+                   keys += testcase.result_keys().size();
+                   for (const auto& key : testcase.metric_keys()) {
+                     ++metrics;
+                     duration += testcase.metric(key);
+                   }
+                   return true;
+                 });
+      fmt::print(stdout, "{}: {} testcases\n", file, count);
+    }
+  };
+  touca::ClientOptions options;
+  options.binary_format = _binary_format;
+  options.compress = _compress;
+  touca::ClientImpl client;
+  client.set_client_options(options);
+  const auto testcases = client.save_merged(_out, add);
+
+  fmt::print(stdout, "\nFiles:      {}\n", files.size());
+  fmt::print(stdout, "Testcases:  {}\n", testcases);
+  if (duplicates != 0) {
+    fmt::print(stdout, "Duplicates: {}\n", duplicates);
+  }
+  fmt::print(stdout, "Results:    {}\n", keys);
+  fmt::print(stdout, "Metrics:    {} ({} ms)\n", metrics, duration);
+  fmt::print(stdout, "Output:     {}\n", _out);
+  if (!missing.empty()) {
+    print_error(touca::detail::format("\n{}\n", missing));
+  }
+  return true;
+}
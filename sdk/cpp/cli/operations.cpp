@@ -16,6 +16,8 @@ void print_error(const std::string& msg) {
 Operation::Command Operation::find_mode(const std::string& name) {
   const std::unordered_map<std::string, Operation::Command> modes{
       {"compare", Operation::Command::compare},
+      {"convert", Operation::Command::convert},
+      {"merge", Operation::Command::merge},
       {"view", Operation::Command::view}};
   return modes.count(name) ? modes.at(name) : Operation::Command::unknown;
 }
@@ -24,6 +26,8 @@ std::shared_ptr<Operation> Operation::make(const Operation::Command& mode) {
   using func_t = std::function<std::shared_ptr<Operation>()>;
   std::map<Operation::Command, func_t> ops{
       {Operation::Command::compare, &std::make_shared<CompareOperation>},
+      {Operation::Command::convert, &std::make_shared<ConvertOperation>},
+      {Operation::Command::merge, &std::make_shared<MergeOperation>},
       {Operation::Command::view, &std::make_shared<ViewOperation>}};
   if (!ops.count(mode)) {
     print_error(touca::detail::format("operation not implemented: {}\n", mode));
@@ -5,9 +5,10 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 struct Operation {
-  enum class Command { compare, unknown, view };
+  enum class Command { compare, convert, merge, unknown, view };
 
   static Command find_mode(const std::string& name);
 
@@ -45,6 +46,23 @@ struct ViewOperation : public Operation {
 
  private:
   std::string _src;
+  std::vector<std::string> _testcases;
+  std::vector<std::string> _keys;
+  bool _stream = false;
+  bool _ndjson = false;
+};
+
+struct ConvertOperation : public Operation {
+ protected:
+  bool parse_impl(int argc, char* argv[]) override;
+
+  bool run_impl() const override;
+
+ private:
+  std::string _src;
+  std::string _out;
+  std::string _from;
+  std::string _to;
 };
 
 struct CompareOperation : public Operation {
@@ -58,4 +76,18 @@ struct CompareOperation : public Operation {
   std::string _dst;
 };
 
+struct MergeOperation : public Operation {
+ protected:
+  bool parse_impl(int argc, char* argv[]) override;
+
+  bool run_impl() const override;
+
+ private:
+  std::vector<std::string> _src;
+  std::string _out;
+  bool _allow_missing = false;
+  std::string _binary_format;
+  bool _compress = false;
+};
+
 void print_error(const std::string& msg);
@@ -1,15 +1,42 @@
 // Copyright 2022 Touca, Inc. Subject to Apache-2.0 License.
 
+#include <algorithm>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
 #include "cxxopts.hpp"
 #include "operations.hpp"
 #include "touca/core/deserialize.hpp"
 #include "touca/core/filesystem.hpp"
+#include "touca/core/json_writer.hpp"
+#include "touca/core/reader.hpp"
+
+namespace {
+
+void print_testcases(const touca::ElementsMap& elements_map,
+                     const touca::detail::JsonWriter::Layout layout) {
+  touca::detail::JsonWriter writer(stdout, layout);
+  for (const auto& item : elements_map) {
+    writer.write(*item.second);
+  }
+  writer.finish();
+  if (layout == touca::detail::JsonWriter::Layout::Array) {
+    fmt::print(stdout, "\n");
+  }
+}
+
+}  // namespace
 
 bool ViewOperation::parse_impl(int argc, char* argv[]) {
   cxxopts::Options options("touca_cli --mode=view");
   // clang-format off
     options.add_options("main")
-        ("src", "result file to view in json format", cxxopts::value<std::string>());
+        ("src", "result file to view in json format", cxxopts::value<std::string>())
+        ("testcase", "only show the given testcases", cxxopts::value<std::vector<std::string>>())
+        ("key", "only show the given results", cxxopts::value<std::vector<std::string>>())
+        ("stream", "read testcases one at a time, use - as src to read from standard input", cxxopts::value<bool>()->default_value("false"))
+        ("ndjson", "print one testcase per line", cxxopts::value<bool>()->default_value("false"));
   // clang-format on
   options.allow_unrecognised_options();
   const auto& result = options.parse(argc, argv);
@@ -19,6 +46,21 @@ bool ViewOperation::parse_impl(int argc, char* argv[]) {
     return false;
   }
   _src = result["src"].as<std::string>();
+  if (result.count("testcase")) {
+    _testcases = result["testcase"].as<std::vector<std::string>>();
+  }
+  if (result.count("key")) {
+    _keys = result["key"].as<std::vector<std::string>>();
+  }
+  _stream = result["stream"].as<bool>();
+  _ndjson = result["ndjson"].as<bool>();
+  if (_stream && !_keys.empty()) {
+    print_error("option --key is not supported with --stream\n");
+    return false;
+  }
+  if (_stream && _src == "-") {
+    return true;
+  }
   if (!touca::filesystem::is_regular_file(_src)) {
     print_error(touca::detail::format("file `{}` does not exist\n", _src));
     return false;
@@ -27,9 +69,68 @@ bool ViewOperation::parse_impl(int argc, char* argv[]) {
 }
 
 bool ViewOperation::run_impl() const {
+  using metrics_map_t =
+      std::unordered_map<std::string, touca::detail::number_unsigned_t>;
+  const auto layout = _ndjson ? touca::detail::JsonWriter::Layout::Lines
+                             : touca::detail::JsonWriter::Layout::Array;
   try {
-    const auto& elements_map = touca::deserialize_file(_src);
-    fmt::print(stdout, "{}\n", elements_map_to_json(elements_map));
+    if (_stream) {
+      // print each testcase as soon as it is read, so that we can view
+      // files that do not fit in memory.
+      touca::detail::JsonWriter writer(stdout, layout);
+      const auto& print = [this, &writer](const touca::Testcase& testcase) {
+        if (!_testcases.empty() &&
+            std::find(_testcases.begin(), _testcases.end(),
+                      testcase.metadata().testcase) == _testcases.end()) {
+          return;
+        }
+        writer.write(testcase);
+      };
+      if (_src == "-") {
+        touca::for_each_testcase(std::cin, print);
+      } else {
+        touca::for_each_testcase(_src, print);
+      }
+      writer.finish();
+      if (!_ndjson) {
+        fmt::print(stdout, "\n");
+      }
+      return true;
+    }
+    if (_testcases.empty() && _keys.empty()) {
+      // decode testcases on as many threads as the hardware supports.
+      print_testcases(touca::deserialize_file(_src, 0), layout);
+      return true;
+    }
+    // avoid decoding the entire file when only parts of it are requested.
+    const touca::ResultFile file(_src);
+    std::vector<touca::TestcaseView> views;
+    if (_testcases.empty()) {
+      for (std::size_t i = 0; i < file.size(); ++i) {
+        views.push_back(file.at(i));
+      }
+    }
+    for (const auto& name : _testcases) {
+      views.push_back(file.testcase(name));
+    }
+    touca::ElementsMap elements_map;
+    for (const auto& view : views) {
+      if (_keys.empty()) {
+        elements_map.emplace(view.name(),
+                             std::make_shared<touca::Testcase>(view.decode()));
+        continue;
+      }
+      touca::ResultsMap results;
+      for (const auto& key : _keys) {
+        if (view.has_result(key)) {
+          results.emplace(key, view.result(key));
+        }
+      }
+      const auto& testcase = std::make_shared<touca::Testcase>(
+          view.metadata(), results, metrics_map_t{});
+      elements_map.emplace(view.name(), testcase);
+    }
+    print_testcases(elements_map, layout);
     return true;
   } catch (const std::exception& ex) {
     print_error(
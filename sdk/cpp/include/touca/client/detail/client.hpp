@@ -2,6 +2,10 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
 
@@ -12,6 +16,9 @@
 #include "touca/extra/logger.hpp"
 
 namespace touca {
+namespace detail {
+class MessagesMerger;
+}  // namespace detail
 
 /**
  * @enum DataFormat
@@ -41,6 +48,16 @@ class TOUCA_CLIENT_API ClientImpl {
 
   void forget_testcase(const std::string& name);
 
+  /**
+   * Removes a testcase from this client and hands it over to the caller,
+   * so that its results can be saved or submitted on another thread while
+   * the client captures results of other testcases.
+   *
+   * @return the testcase, or `nullptr` if no testcase with the given name
+   *         is declared.
+   */
+  std::shared_ptr<Testcase> release_testcase(const std::string& name);
+
   void check(const std::string& key, const data_point& value);
 
   void assume(const std::string& key, const data_point& value);
@@ -59,8 +76,43 @@ class TOUCA_CLIENT_API ClientImpl {
             const std::vector<std::string>& testcases, const DataFormat format,
             const bool overwrite) const;
 
+  /**
+   * Saves the given testcases, which need not be declared in this client,
+   * to a file in the given format.
+   */
+  void save(const touca::filesystem::path& path,
+            const std::vector<Testcase>& testcases,
+            const DataFormat format) const;
+
+  /**
+   * Produces the content that `save` would write to a file for the given
+   * testcases, without writing it to disk.
+   */
+  std::string dump(const std::vector<Testcase>& testcases,
+                   const DataFormat format) const;
+
+  /**
+   * Saves the testcases that a given function adds to a merger into a
+   * file in binary format, in the binary format and with the compression
+   * used by `save`, without holding their decoded content in memory.
+   *
+   * @return number of testcases saved to the file
+   */
+  std::size_t save_merged(
+      const touca::filesystem::path& path,
+      const std::function<void(touca::detail::MessagesMerger&)>& add) const;
+
   Post::Status post(const Post::Options& options = {}) const;
 
+  /**
+   * Submits the given testcases, which need not be declared in this
+   * client, to the server. Unlike `post`, this function does not touch
+   * testcases declared in this client and is safe to call on another
+   * thread while results of other testcases are being captured.
+   */
+  Post::Status submit(const std::vector<Testcase>& testcases,
+                      const Post::Options& options = {}) const;
+
   void seal() const;
 
   /**
@@ -82,6 +134,8 @@ class TOUCA_CLIENT_API ClientImpl {
 
   bool has_last_testcase() const;
 
+  std::shared_ptr<Testcase> find_last_testcase() const;
+
   std::vector<Testcase> find_testcases(
       const std::vector<std::string>& names) const;
 
@@ -91,6 +145,15 @@ class TOUCA_CLIENT_API ClientImpl {
   void save_flatbuffers(const touca::filesystem::path& path,
                         const std::vector<Testcase>& testcases) const;
 
+  /**
+   * Saves serialized testcases to a file along with their index,
+   * compressing them if instructed to do so.
+   */
+  void save_binary(const touca::filesystem::path& path,
+                   const std::uint8_t* data, const std::size_t size) const;
+
+  BinaryFormat find_binary_format() const;
+
   void notify_loggers(const touca::logger::Level severity,
                       const std::string& msg) const;
 
@@ -103,6 +166,36 @@ class TOUCA_CLIENT_API ClientImpl {
       touca::detail::make_unique<DefaultTransport>();
   std::unordered_map<std::thread::id, std::string> _threadMap;
   std::vector<std::shared_ptr<touca::logger>> _loggers;
+
+  /**
+   * Guards the set of declared testcases and the testcase most recently
+   * declared by each thread, so that testcases may be declared and
+   * captured on multiple threads at once.
+   */
+  mutable std::mutex _mutex;
 };
 
+namespace detail {
+/** see ClientImpl::release_testcase */
+std::shared_ptr<Testcase> release_testcase(const std::string& name);
+
+/** see ClientImpl::save */
+void save_testcases(const touca::filesystem::path& path,
+                    const std::vector<Testcase>& testcases,
+                    const DataFormat format);
+
+/** see ClientImpl::dump */
+std::string dump_testcases(const std::vector<Testcase>& testcases,
+                           const DataFormat format);
+
+/** see ClientImpl::save_merged */
+std::size_t save_merged_testcases(
+    const touca::filesystem::path& path,
+    const std::function<void(touca::detail::MessagesMerger&)>& add);
+
+/** see ClientImpl::submit */
+Post::Status submit_testcases(const std::vector<Testcase>& testcases,
+                              const Post::Options& options);
+}  // namespace detail
+
 }  // namespace touca
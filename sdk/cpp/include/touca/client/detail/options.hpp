@@ -2,12 +2,15 @@
 
 #pragma once
 
+#include <cstddef>
 #include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "touca/core/filesystem.hpp"
 #include "touca/core/transport.hpp"
+#include "touca/lib_api.hpp"
 
 namespace touca {
 
@@ -96,10 +99,57 @@ struct ClientOptions {
    * functions such as `touca::check` will affect the newly declared test case.
    */
   bool concurrency = true;
+
+  /**
+   * Compresses test results when storing them in binary format and when
+   * submitting them to the Touca server.
+   *
+   * Compressed result files are detected and decompressed automatically
+   * when they are read. Submissions are compressed using HTTP content
+   * encoding `deflate`. Has no effect if the library is built without
+   * zlib. Defaults to `false`.
+   */
+  bool compress = false;
+
+  /**
+   * Revision of the binary format used for storing test results on disk.
+   *
+   * Format `"v2"` stores keys, object names and short string values once
+   * per result file, which makes files smaller and faster to decode.
+   * Format `"v3"` additionally stores numbers and booleans inline rather
+   * than in tables of their own, and arrays of numbers or booleans as
+   * typed vectors. Result files of any format can be read by this
+   * library. Test results submitted to the Touca server always use
+   * format `"v1"`, so saved and submitted results share the encoding of
+   * each testcase only when this format is `"v1"`. Defaults to `"v1"`.
+   */
+  std::string binary_format = "v1";
 };
 
 #ifdef TOUCA_INCLUDE_RUNNER
 
+/**
+ * Function that sets its argument to the next test case and returns `true`,
+ * or returns `false` when there are no more test cases.
+ */
+using TestcaseGenerator = std::function<bool(std::string&)>;
+
+/**
+ * Function that makes a new generator of test cases, starting from the
+ * first test case, each time it is called.
+ */
+using TestcaseSource = std::function<TestcaseGenerator()>;
+
+/**
+ * Input of a test case, as loaded by `WorkflowOptions::loader`.
+ */
+struct TestcaseInput {
+  /** Loaded input, to be passed to the workflow callback. */
+  std::shared_ptr<void> value;
+  /** Approximate number of bytes of memory that the loaded input takes. */
+  std::size_t size;
+};
+
 /**
  * Configuration options that can be set for individual test workflows when
  * calling the high-level API function `touca::workflow()`.
@@ -130,12 +180,101 @@ struct WorkflowOptions {
    * baseline version of this suite.
    */
   std::vector<std::string> testcases;
+
+  /**
+   * Source of test cases to be given one by one to the test workflow, as an
+   * alternative to `testcases` for suites with too many test cases to list
+   * upfront. The test runner pulls test cases from this source as it needs
+   * them, so that memory use does not grow with the inputs and results of
+   * test cases. Only the names of test cases pulled so far are kept, to
+   * skip test cases that the source hands out more than once. Takes
+   * precedence over `testcases` when set.
+   *
+   * @see `touca::testcases_from_file()`
+   * @see `touca::testcases_from_directory()`
+   */
+  TestcaseSource testcase_source;
+
+  /**
+   * Function to call once before running the first test case of this
+   * workflow, to prepare resources that all test cases need. When test
+   * cases run in separate worker processes, this function runs in the test
+   * runner process before any worker process starts, so that each worker
+   * process starts with a copy of the prepared resources.
+   */
+  std::function<void()> setup;
+
+  /**
+   * Function to call once after the last test case of this workflow, to
+   * release resources prepared by `setup`. When test cases run in separate
+   * worker processes, this function runs in the test runner process.
+   */
+  std::function<void()> teardown;
+
+  /**
+   * Function to call once in each worker thread or worker process, before
+   * it runs its first test case, to prepare resources that may not be
+   * shared between workers. When test cases run one after the other, this
+   * function is called once, after `setup`. If this function throws, the
+   * test cases of that worker are reported as failed.
+   */
+  std::function<void()> worker_setup;
+
+  /**
+   * Function to call with each test case to load its input, such as the
+   * content of an input file, before the test case runs. When option
+   * `prefetch` of the test runner is set, this function is called ahead
+   * of time for upcoming test cases on a pool of threads, so that loading
+   * the input of a test case overlaps with running earlier test cases.
+   * The loaded input is released once its test case has run.
+   *
+   * @see `touca::workflow<Input>()` that sets this function and receives
+   *      the loaded input in the workflow callback.
+   */
+  std::function<TestcaseInput(const std::string&)> loader;
+
+  /**
+   * Function that returns a fingerprint of the input of a given test case,
+   * such as a hash of the content of its input files. When option
+   * `cache_directory` of the test runner is set, test cases whose
+   * fingerprint and code version match those of a previous run are not
+   * run again. Their results are reused from that run instead. May be
+   * called from multiple threads when test cases run at the same time.
+   */
+  std::function<std::string(const std::string&)> fingerprint;
 };
 
 struct Workflow : public WorkflowOptions {
   std::function<void(const std::string&)> callback;
+  /** Called instead of `callback` with the input loaded by `loader`. */
+  std::function<void(const std::string&, TestcaseInput&)> input_callback;
 };
 
+/**
+ * Makes a source of test cases that reads a given file one line at a time,
+ * with each non-empty line naming a test case.
+ *
+ * @param path path to a file with one test case per line
+ * @return source that throws `touca::detail::runtime_error` when called if
+ *         the file cannot be read
+ */
+TOUCA_CLIENT_API TestcaseSource testcases_from_file(const std::string& path);
+
+/**
+ * Makes a source of test cases named after the regular files in a given
+ * directory whose names match a given pattern, in which `*` matches any
+ * sequence of characters and `?` matches any single character. Files are
+ * listed in the order in which the filesystem lists them.
+ *
+ * @param directory path to the directory to list
+ * @param pattern pattern that file names should match
+ * @return source that throws `touca::detail::runtime_error` when called if
+ *         the directory cannot be read
+ */
+TOUCA_CLIENT_API TestcaseSource
+testcases_from_directory(const std::string& directory,
+                         const std::string& pattern = "*");
+
 /**
  * Configuration options supported by the built-in test runner.
  */
@@ -161,6 +300,31 @@ struct RunnerOptions : public ClientOptions {
    */
   bool overwrite_results = false;
 
+  /**
+   * Store the test results and captured output of all test cases of a given
+   * version into a single append-only segment file `touca.seg` with an index
+   * `touca.idx`, instead of a separate directory of files for each test case.
+   */
+  bool consolidate_results = false;
+
+  /**
+   * Path to a directory in which to keep the test results of test cases of
+   * workflows that set `WorkflowOptions::fingerprint`, so that later runs
+   * can reuse them. A test case whose fingerprint and code version match a
+   * kept entry is not run: its kept results and output are saved and
+   * submitted as if it had run. Only results of test cases that ran
+   * without errors are kept. Caching is disabled when this option is
+   * empty, which is the default.
+   */
+  std::string cache_directory;
+
+  /**
+   * Identifier of the version of the code under test, such as a hash of
+   * its source files, that invalidates kept test results when it changes.
+   * Defaults to the version of the workflow.
+   */
+  std::string code_version;
+
   /**
    * Do not use ANSI colors when reporting the test progress in the standard
    * output.
@@ -173,6 +337,23 @@ struct RunnerOptions : public ClientOptions {
    */
   bool redirect_output = true;
 
+  /**
+   * When capturing the standard output and standard error of the code under
+   * test, capture content written to their file descriptors, such as
+   * content printed by C libraries via `printf`, instead of content printed
+   * to `std::cout` and `std::cerr`. Since file descriptors are shared by all
+   * threads of a process, this option requires test cases to run one after
+   * the other or in separate worker processes. Not supported on Windows.
+   */
+  bool capture_descriptors = false;
+
+  /**
+   * Maximum number of bytes of the standard output, and of the standard
+   * error, to capture for each test case. Content beyond this limit is
+   * discarded. Defaults to `0`, which captures all content.
+   */
+  unsigned output_limit = 0;
+
   /**
    * Indicates whether to generate a copy of the standard output of the test
    * into a `Console.log` file.
@@ -206,6 +387,13 @@ struct RunnerOptions : public ClientOptions {
    */
   std::vector<std::string> testcases;
 
+  /**
+   * Path to a file with one test case per line, to feed to all the
+   * registered workflows instead of `testcases`. The file is read as test
+   * cases are run, instead of being loaded into memory upfront.
+   */
+  std::string testcase_file;
+
   /**
    * Limits the test to running the specified workflow as opposed to all the
    * registered workflows.
@@ -217,6 +405,97 @@ struct RunnerOptions : public ClientOptions {
    */
   std::vector<Workflow> workflows;
 
+  /**
+   * Number of testcases to run at the same time, each on its own thread.
+   * Defaults to `1`, which runs testcases one after the other. Set to `0`
+   * to use as many threads as the hardware supports.
+   *
+   * When testcases run at the same time, the workflow callback must be
+   * safe to call from multiple threads. Progress is still reported, and
+   * results are still saved and submitted, in the order of testcases.
+   */
+  unsigned jobs = 1;
+
+  /**
+   * Run test cases that took longest in previous runs first, so that test
+   * cases that run at the same time finish at about the same time instead
+   * of leaving a single worker to run a long test case at the end. Test
+   * cases that have not run before are assumed to take as long as an
+   * average test case. Durations are kept in file `touca.durations` in the
+   * directory of the suite in `output_directory`. Has no effect on the
+   * order of test cases pulled from `WorkflowOptions::testcase_source`.
+   */
+  bool longest_first = false;
+
+  /**
+   * Maximum number of seconds to spend running test cases of a workflow.
+   * Based on the durations of previous runs, test cases that are not
+   * expected to fit in this budget are skipped, favoring running as many
+   * test cases as possible. Test cases that have not started once the
+   * budget is spent are skipped as well. Defaults to `0`, which sets no
+   * limit.
+   */
+  unsigned time_budget = 0;
+
+  /**
+   * Number of shards to split the test cases of each workflow into, so
+   * that they can be run on separate machines with no coordination. Test
+   * cases are assigned to shards based on a stable hash of their name,
+   * so every machine that runs the same set of test cases agrees on the
+   * shard of each test case. Defaults to `0`, which runs all test cases.
+   *
+   * Each shard writes the results of its test cases into file
+   * `shard-<index>-of-<count>.bin` in the result directory of the
+   * workflow, which `touca_cli --mode=merge` combines into a single
+   * result file. This file is made of the results saved for each test
+   * case, including test cases skipped since an earlier run had already
+   * processed them, so this option requires `save_binary`.
+   */
+  unsigned shard_count = 0;
+
+  /**
+   * Zero-based index of the shard of test cases to run, when
+   * `shard_count` is set.
+   */
+  unsigned shard_index = 0;
+
+  /**
+   * Run each testcase in a separate worker process, with up to `jobs`
+   * worker processes running at the same time, so that a testcase that
+   * crashes is reported as failed instead of ending the test. Since each
+   * worker process has its own copy of the code under test, the workflow
+   * callback does not need to be safe to call from multiple threads.
+   * Only supported on platforms that provide `fork()`.
+   */
+  bool isolate_testcases = false;
+
+  /**
+   * Number of test cases that each worker process runs before it exits and
+   * a new worker process takes its place, when `isolate_testcases` is set.
+   * Set to `1` to run every test case in a fresh copy of the test runner
+   * process, as it was after the setup of the workflow. Defaults to `0`,
+   * which keeps worker processes until all test cases have run.
+   */
+  unsigned testcases_per_process = 0;
+
+  /**
+   * Number of upcoming test cases whose input is loaded ahead of time, for
+   * workflows that set `WorkflowOptions::loader`. Input is loaded on up to
+   * as many threads as the hardware supports. Defaults to `0`, which loads
+   * the input of each test case just before it runs. Has no effect when
+   * `isolate_testcases` is set, since worker processes load the input of
+   * their own test cases.
+   */
+  unsigned prefetch = 0;
+
+  /**
+   * Maximum number of megabytes of memory that input loaded ahead of time
+   * may take, as reported by `TestcaseInput::size`. Input of upcoming test
+   * cases is not loaded ahead of time while this limit is reached.
+   * Defaults to `0`, which sets no limit.
+   */
+  unsigned prefetch_memory = 0;
+
   /** Submits test results asynchronously if set. */
   bool submit_async = false;
 
@@ -9,10 +9,15 @@
 #include <unordered_map>
 
 #include "rapidjson/fwd.h"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/string_table.hpp"
 #include "touca/core/testcase.hpp"
 #include "touca/core/types.hpp"
 
 namespace touca {
+namespace fbs {
+struct Message;
+}  // namespace fbs
 
 /**
  * @enum touca::MatchType
@@ -73,6 +78,19 @@ class TOUCA_CLIENT_API TestcaseComparison {
 
   explicit TestcaseComparison(const Testcase& src, const Testcase& dst);
 
+  /**
+   * Compares two testcases directly from their serialized representation,
+   * without decoding their captured values into `data_point` objects.
+   * Produces the same output as comparing the decoded testcases.
+   *
+   * @param srcStrings shared strings of the file that stores `src`
+   * @param dstStrings shared strings of the file that stores `dst`
+   */
+  explicit TestcaseComparison(
+      const fbs::Message& src, const fbs::Message& dst,
+      const touca::detail::StringTable& srcStrings = {},
+      const touca::detail::StringTable& dstStrings = {});
+
   rapidjson::Value json(RJAllocator& allocator) const;
 
   Overview overview() const;
@@ -86,8 +104,6 @@ class TOUCA_CLIENT_API TestcaseComparison {
   void init_cellar(const MetricsMap& src, const MetricsMap& dst,
                    Cellar& result);
 
-  void init_metadata(const Testcase& tc, Testcase::Metadata& meta);
-
   // metadata
   Testcase::Metadata _srcMeta;
   Testcase::Metadata _dstMeta;
@@ -95,9 +111,9 @@ class TOUCA_CLIENT_API TestcaseComparison {
   Cellar _assumptions;
   Cellar _results;
   Cellar _metrics;
-  // pointers to testcases we are comparing
-  const Testcase& _src;
-  const Testcase& _dst;
+  // total duration of common metrics of the testcases we are comparing
+  std::int32_t _metricsDurationCommonSrc = 0;
+  std::int32_t _metricsDurationCommonDst = 0;
 };
 
 /**
@@ -130,6 +146,22 @@ TOUCA_CLIENT_API TestcaseComparison compare(const Testcase& src,
 TOUCA_CLIENT_API ElementsMapComparison compare(const ElementsMap& src,
                                                const ElementsMap& dst);
 
+/**
+ * @brief compares two result files in binary format.
+ *
+ * @details Maps both files into memory and compares their testcases directly
+ *          on the serialized data, without decoding the captured values of
+ *          the common testcases. Produces the same output as comparing the
+ *          output of `deserialize_file` for the two files.
+ *
+ * @param src path to the result file to compare
+ * @param dst path to the result file to compare against
+ * @throw touca::detail::runtime_error if either file is invalid
+ */
+TOUCA_CLIENT_API ElementsMapComparison
+compare_files(const touca::filesystem::path& src,
+              const touca::filesystem::path& dst);
+
 TOUCA_CLIENT_API std::map<std::string, data_point> flatten(
     const data_point& input);
 
@@ -0,0 +1,65 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <vector>
+
+#include "touca/lib_api.hpp"
+
+namespace touca {
+namespace detail {
+
+/** Whether this build of the library supports compression. */
+TOUCA_CLIENT_API bool has_compression();
+
+/**
+ * Whether the given content, or its first four bytes, starts with the
+ * magic of our compressed container.
+ *
+ * A compressed container starts with the four-byte magic "TCZ1", followed
+ * by the size of the uncompressed content as a little-endian uint64 and a
+ * zlib stream of that content.
+ */
+TOUCA_CLIENT_API bool is_compressed(const std::uint8_t* data,
+                                    const std::size_t size);
+
+/**
+ * @throw touca::detail::runtime_error if the library is built without
+ *        support for compression
+ */
+TOUCA_CLIENT_API std::vector<std::uint8_t> compress(const std::uint8_t* data,
+                                                    const std::size_t size);
+
+/**
+ * @throw touca::detail::runtime_error if the content is not a valid
+ *        compressed container or if the library is built without support
+ *        for compression
+ */
+TOUCA_CLIENT_API std::vector<std::uint8_t> decompress(
+    const std::uint8_t* data, const std::size_t size);
+
+/**
+ * Compresses the given content into a zlib stream without the container
+ * header, as expected for HTTP requests with `Content-Encoding: deflate`.
+ */
+TOUCA_CLIENT_API std::vector<std::uint8_t> zlib_compress(
+    const std::uint8_t* data, const std::size_t size);
+
+/**
+ * Creates a stream buffer that decompresses the zlib stream that follows
+ * the container header in a given input stream, as it is being read.
+ *
+ * @param input stream positioned right after the container header
+ */
+TOUCA_CLIENT_API std::unique_ptr<std::streambuf> make_inflating_streambuf(
+    std::istream& input);
+
+/** size of the header of compressed containers */
+constexpr std::size_t compressed_header_size = 12;
+
+}  // namespace detail
+}  // namespace touca
@@ -2,24 +2,112 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <iosfwd>
 #include <vector>
 
 #include "touca/core/filesystem.hpp"
+#include "touca/core/string_table.hpp"
 #include "touca/core/testcase.hpp"
 
 namespace touca {
 class data_point;
 namespace fbs {
+struct Message;
 struct TypeWrapper;
 }  // namespace fbs
 
-data_point TOUCA_CLIENT_API deserialize_value(const fbs::TypeWrapper* ptr);
+/**
+ * Reads a serialized scalar value of a given type, whether it is stored
+ * in a table of its own or inline, as in binary format v3.
+ *
+ * @tparam T one of the scalar types of `touca::detail`
+ * @param ptr serialized value of type `T`
+ */
+template <typename T>
+T deserialize_scalar(const fbs::TypeWrapper* ptr);
+
+template <>
+TOUCA_CLIENT_API touca::detail::boolean_t
+deserialize_scalar<touca::detail::boolean_t>(const fbs::TypeWrapper* ptr);
+
+template <>
+TOUCA_CLIENT_API touca::detail::number_signed_t
+deserialize_scalar<touca::detail::number_signed_t>(
+    const fbs::TypeWrapper* ptr);
+
+template <>
+TOUCA_CLIENT_API touca::detail::number_unsigned_t
+deserialize_scalar<touca::detail::number_unsigned_t>(
+    const fbs::TypeWrapper* ptr);
+
+template <>
+TOUCA_CLIENT_API touca::detail::number_float_t
+deserialize_scalar<touca::detail::number_float_t>(const fbs::TypeWrapper* ptr);
+
+template <>
+TOUCA_CLIENT_API touca::detail::number_double_t
+deserialize_scalar<touca::detail::number_double_t>(
+    const fbs::TypeWrapper* ptr);
+
+/**
+ * @param ptr serialized value
+ * @param strings shared strings of the result file that stores the value
+ */
+data_point TOUCA_CLIENT_API
+deserialize_value(const fbs::TypeWrapper* ptr,
+                  const touca::detail::StringTable& strings = {});
+
+Testcase::Metadata TOUCA_CLIENT_API
+deserialize_metadata(const fbs::Message* message);
+
+/**
+ * @param message serialized testcase
+ * @param strings shared strings of the result file that stores the
+ *        testcase
+ */
+Testcase TOUCA_CLIENT_API
+deserialize_testcase(const fbs::Message* message,
+                     const touca::detail::StringTable& strings = {});
 
 Testcase TOUCA_CLIENT_API
 deserialize_testcase(const std::vector<std::uint8_t>& buffer);
 
-ElementsMap TOUCA_CLIENT_API
-deserialize_file(const touca::filesystem::path& path);
+/**
+ * Loads all testcases stored in a given result file in binary format.
+ *
+ * @param path path to the result file
+ * @param concurrency number of threads to use for verifying and decoding
+ *        testcases. `0` uses as many threads as the hardware supports.
+ * @throw touca::detail::runtime_error if the file is invalid
+ */
+ElementsMap TOUCA_CLIENT_API deserialize_file(
+    const touca::filesystem::path& path, const std::size_t concurrency = 1);
+
+/**
+ * Reads testcases stored in a given result file in binary format one at a
+ * time, without loading the entire file into memory. Content is read
+ * forward-only, so the input may also be a pipe. Compressed content is
+ * decompressed as it is read.
+ *
+ * Testcases are passed to the callback in the order in which their data
+ * is laid out in the file, which is not necessarily the order in which
+ * they were serialized.
+ *
+ * @param input stream of serialized test results, opened in binary mode
+ * @param callback function to call with each decoded testcase
+ * @throw touca::detail::runtime_error if the input is invalid
+ */
+TOUCA_CLIENT_API void for_each_testcase(
+    std::istream& input, const std::function<void(const Testcase&)>& callback);
+
+/**
+ * @see for_each_testcase(std::istream&, ...)
+ */
+TOUCA_CLIENT_API void for_each_testcase(
+    const touca::filesystem::path& path,
+    const std::function<void(const Testcase&)>& callback);
 
 }  // namespace touca
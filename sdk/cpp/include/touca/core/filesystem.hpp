@@ -29,9 +29,12 @@ namespace filesystem = ghc::filesystem;
 }
 #endif
 
+#include <cstddef>
+#include <cstdint>
 #include <ios>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "fmt/core.h"
@@ -78,8 +81,54 @@ TOUCA_CLIENT_API std::string load_text_file(
 TOUCA_CLIENT_API void save_text_file(const std::string& path,
                                      const std::string& content);
 
+/**
+ * Creates the directory in which a file with the given path should be
+ * stored, if it does not already exist.
+ *
+ * @throw touca::detail::runtime_error if the directory cannot be created
+ */
+TOUCA_CLIENT_API void create_parent_directory(const std::string& path);
+
 TOUCA_CLIENT_API void save_binary_file(const std::string& path,
                                        const std::vector<uint8_t>& content);
 
+/**
+ * Saves the given pieces of binary content to a file, one after the
+ * other, without concatenating them in memory first.
+ *
+ * @param pieces pointer to and size of each piece of content
+ */
+TOUCA_CLIENT_API void save_binary_file(
+    const std::string& path,
+    const std::vector<std::pair<const std::uint8_t*, std::size_t>>& pieces);
+
+/**
+ * Read-only view of the content of a file that is mapped into memory.
+ *
+ * On platforms that support `mmap`, pages of the file are loaded lazily by
+ * the operating system as they are accessed. On other platforms, we fall
+ * back to loading the entire content of the file into memory.
+ */
+class TOUCA_CLIENT_API MappedFile {
+ public:
+  /**
+   * @param path path to the file whose content should be mapped
+   * @throw touca::detail::runtime_error if the file cannot be opened
+   */
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const std::uint8_t* data() const noexcept { return _data; }
+  std::size_t size() const noexcept { return _size; }
+
+ private:
+  const std::uint8_t* _data = nullptr;
+  std::size_t _size = 0;
+  std::string _fallback;
+};
+
 }  // namespace detail
 }  // namespace touca
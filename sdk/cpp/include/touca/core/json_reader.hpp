@@ -0,0 +1,40 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <functional>
+#include <istream>
+
+#include "touca/core/filesystem.hpp"
+#include "touca/core/testcase.hpp"
+#include "touca/lib_api.hpp"
+
+namespace touca {
+
+/**
+ * Calls a given function with each testcase stored in JSON format, in
+ * either of the layouts written by `touca::detail::JsonWriter`: a single
+ * array of testcases as in `touca.json` result files, or one testcase per
+ * line. The input is parsed as it is read, one testcase at a time, so
+ * memory use does not depend on the size of the input.
+ *
+ * Values are read into their native types. Since JSON does not tell
+ * integer types apart, integers are read as signed numbers unless they
+ * are too large, and other numbers are read as doubles. Values that were
+ * written as strings by older versions of the SDK are read as strings.
+ *
+ * @param input stream of test results in JSON format
+ * @param callback function to call with each decoded testcase
+ * @throw touca::detail::runtime_error if the input is invalid
+ */
+TOUCA_CLIENT_API void for_each_json_testcase(
+    std::istream& input, const std::function<void(const Testcase&)>& callback);
+
+/**
+ * @see for_each_json_testcase(std::istream&, ...)
+ */
+TOUCA_CLIENT_API void for_each_json_testcase(
+    const touca::filesystem::path& path,
+    const std::function<void(const Testcase&)>& callback);
+
+}  // namespace touca
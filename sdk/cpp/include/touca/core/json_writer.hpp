@@ -0,0 +1,83 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "touca/core/testcase.hpp"
+#include "touca/lib_api.hpp"
+
+namespace touca {
+namespace detail {
+
+/**
+ * Writes testcases in JSON format as they are handed over, with results,
+ * assertions and metrics stored as native JSON values rather than as
+ * strings. Content is buffered in a fixed amount of memory, regardless of
+ * the number and size of the testcases.
+ */
+class TOUCA_CLIENT_API JsonWriter {
+ public:
+  enum class Layout : std::uint8_t {
+    /** a single array of testcases, as in `touca.json` result files */
+    Array,
+    /** one testcase per line, also known as NDJSON */
+    Lines
+  };
+
+  /**
+   * @param file stream to write to, which remains owned by the caller
+   * @param layout how testcases should be laid out in the output
+   */
+  explicit JsonWriter(std::FILE* file, const Layout layout = Layout::Array);
+
+  /**
+   * @param text string to append the output to
+   * @param layout how testcases should be laid out in the output
+   */
+  explicit JsonWriter(std::string& text, const Layout layout = Layout::Array);
+
+  /**
+   * Hands over any content that is still buffered, so that output written
+   * so far is not lost if `finish` is not called, such as when writing is
+   * interrupted by an exception. The output is then left incomplete.
+   */
+  ~JsonWriter();
+
+  /**
+   * @throw touca::detail::runtime_error if the output cannot be written
+   */
+  void write(const Testcase& testcase);
+
+  /**
+   * Completes the output and hands over any content that is still
+   * buffered. Should be called once, after all testcases are written.
+   *
+   * @throw touca::detail::runtime_error if the output cannot be written
+   */
+  void finish();
+
+ private:
+  struct Impl;
+
+  void write_value(const data_point& value);
+
+  std::unique_ptr<Impl> _impl;
+};
+
+/**
+ * Saves a given list of testcases in JSON format in a file with the given
+ * path, without holding the entire content in memory.
+ *
+ * @throw touca::detail::runtime_error if the file cannot be written
+ */
+TOUCA_CLIENT_API void save_json_file(
+    const std::string& path, const std::vector<Testcase>& testcases,
+    const JsonWriter::Layout layout = JsonWriter::Layout::Array);
+
+}  // namespace detail
+}  // namespace touca
@@ -0,0 +1,77 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace touca {
+namespace detail {
+
+/**
+ * Number of threads to use when the caller asks for a given level of
+ * concurrency, with `0` meaning as many threads as the hardware supports.
+ */
+inline std::size_t thread_count(const std::size_t concurrency) {
+  if (concurrency != 0) {
+    return concurrency;
+  }
+  const auto hardware = std::thread::hardware_concurrency();
+  return hardware == 0 ? 1 : hardware;
+}
+
+/**
+ * Calls a given function once for each index in range `[0, count)` using
+ * up to `concurrency` threads, including the calling thread. Indices are
+ * handed out one at a time so that uneven workloads are balanced across
+ * threads. If any call throws, remaining indices are skipped and the
+ * first exception is rethrown once all threads have finished.
+ */
+template <typename Function>
+void parallel_for(const std::size_t count, const std::size_t concurrency,
+                  Function&& function) {
+  const auto threads = std::min(thread_count(concurrency), count);
+  if (threads <= 1) {
+    for (std::size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+  std::atomic<std::size_t> next(0);
+  std::atomic<bool> failed(false);
+  std::exception_ptr error;
+  std::mutex mutex;
+  const auto worker = [&]() {
+    for (auto i = next++; i < count && !failed; i = next++) {
+      try {
+        function(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (std::size_t i = 1; i < threads; ++i) {
+    pool.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : pool) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace detail
+}  // namespace touca
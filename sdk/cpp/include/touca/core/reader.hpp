@@ -0,0 +1,163 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "touca/core/filesystem.hpp"
+#include "touca/core/string_table.hpp"
+#include "touca/core/testcase.hpp"
+#include "touca/lib_api.hpp"
+
+namespace touca {
+namespace fbs {
+struct Index;
+struct IndexEntry;
+struct Message;
+}  // namespace fbs
+
+/**
+ * Read-only view of a single testcase stored in a result file.
+ *
+ * Unlike `Testcase`, a view does not own any data. It refers to the
+ * serialized content of the testcase and decodes values only when they
+ * are accessed. A view remains valid for as long as the `ResultFile` it
+ * was obtained from.
+ */
+class TOUCA_CLIENT_API TestcaseView {
+ public:
+  /**
+   * @param message serialized content of the testcase
+   * @param entry optional index of the results of this testcase, used for
+   *        finding results by name without scanning all of them
+   * @param strings optional shared strings of the file that stores the
+   *        testcase
+   */
+  explicit TestcaseView(const fbs::Message* message,
+                        const fbs::IndexEntry* entry = nullptr,
+                        const touca::detail::StringTable* strings = nullptr);
+
+  /** name of this testcase */
+  std::string name() const;
+
+  Testcase::Metadata metadata() const;
+
+  /** names of all results captured for this testcase, in stored order */
+  std::vector<std::string> result_keys() const;
+
+  bool has_result(const std::string& key) const;
+
+  /**
+   * Decodes the value of a given result.
+   *
+   * @throw touca::detail::runtime_error if the result does not exist
+   */
+  ResultEntry result(const std::string& key) const;
+
+  /** names of all metrics captured for this testcase, in stored order */
+  std::vector<std::string> metric_keys() const;
+
+  bool has_metric(const std::string& key) const;
+
+  /**
+   * @throw touca::detail::runtime_error if the metric does not exist
+   */
+  touca::detail::number_signed_t metric(const std::string& key) const;
+
+  /** decodes the entire content of this testcase */
+  Testcase decode() const;
+
+  const fbs::Message* message() const noexcept { return _message; }
+
+  const touca::detail::StringTable& strings() const noexcept {
+    return *_strings;
+  }
+
+ private:
+  const fbs::Message* _message;
+  const fbs::IndexEntry* _entry;
+  const touca::detail::StringTable* _strings;
+};
+
+/**
+ * Provides random access to the testcases stored in a result file in
+ * binary format, without loading the file into memory.
+ *
+ * The file is memory-mapped and only its top-level structure is verified
+ * when it is opened. Compressed files are decompressed into memory.
+ * Shared strings of files in binary format v2 are loaded when the file is
+ * opened. The content of each testcase is verified when a view of that
+ * testcase is first requested. Lookups by name use the index
+ * stored at the end of the file if there is one, and otherwise build an
+ * index of all testcases on first use. Views of distinct testcases may be
+ * requested from multiple threads at the same time, but lookups by name
+ * may not.
+ */
+class TOUCA_CLIENT_API ResultFile {
+ public:
+  /**
+   * @param path path to a result file in binary format
+   * @throw touca::detail::runtime_error if the file cannot be read or
+   *        does not represent valid test results
+   */
+  explicit ResultFile(const touca::filesystem::path& path);
+
+  /** number of testcases stored in this file */
+  std::size_t size() const;
+
+  /**
+   * @param index position of the testcase in this file
+   * @throw touca::detail::runtime_error if the testcase is not valid
+   */
+  TestcaseView at(const std::size_t index) const;
+
+  bool has_testcase(const std::string& name) const;
+
+  /**
+   * @throw touca::detail::runtime_error if the file has no testcase with
+   *        the given name
+   */
+  TestcaseView testcase(const std::string& name) const;
+
+ private:
+  const std::unordered_map<std::string, std::size_t>& index() const;
+
+  void load_footer();
+
+  std::string _path;
+  touca::detail::MappedFile _file;
+  std::vector<std::uint8_t> _content;
+  const std::uint8_t* _data;
+  std::size_t _size;
+  touca::detail::StringTable _strings;
+  const fbs::Index* _footer = nullptr;
+  mutable std::vector<std::uint8_t> _verified;
+  mutable std::unordered_map<std::string, std::size_t> _index;
+  mutable bool _indexed = false;
+};
+
+/**
+ * Appends an index of the testcases in a given list of serialized test
+ * results to its end, allowing `ResultFile` to find testcases and their
+ * results by name without scanning the entire file. Readers that are
+ * unaware of the index ignore it.
+ *
+ * @param content test results serialized by `Testcase::serialize`
+ */
+TOUCA_CLIENT_API void append_index(std::vector<std::uint8_t>& content);
+
+/**
+ * Builds the bytes that `append_index` appends to a given list of
+ * serialized test results, for callers that write them out separately.
+ *
+ * @param data test results serialized by `Testcase::serialize`
+ * @param size number of bytes of serialized test results
+ */
+TOUCA_CLIENT_API std::vector<std::uint8_t> make_index(
+    const std::uint8_t* data, const std::size_t size);
+
+}  // namespace touca
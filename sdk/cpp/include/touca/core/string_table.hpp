@@ -0,0 +1,110 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "touca/lib_api.hpp"
+
+namespace flatbuffers {
+struct String;
+}  // namespace flatbuffers
+
+namespace touca {
+class data_point;
+namespace fbs {
+struct Messages;
+}  // namespace fbs
+namespace detail {
+
+/**
+ * Collects strings that are shared by the testcases serialized in binary
+ * format v2, so that each distinct string is stored only once in the
+ * list of serialized testcases.
+ */
+class TOUCA_CLIENT_API StringPool {
+ public:
+  /**
+   * Whether a given string value should be stored in the pool. Keys and
+   * names are always pooled. Long string values rarely repeat and are
+   * stored inline, so that readers do not need to hold them in memory
+   * for the entire lifetime of the file.
+   */
+  static bool is_shareable(const std::string& value);
+
+  /**
+   * Position of a given string in this pool, adding it if necessary.
+   *
+   * @throw touca::detail::runtime_error if the string is missing from a
+   *        frozen pool
+   */
+  std::uint32_t add(const std::string& value);
+
+  /**
+   * Adds the strings that serializing a given value with this pool would
+   * add to it, in the same order.
+   *
+   * @param positions if set, receives the position of each string that
+   *        serialization would refer to, in the same order
+   */
+  void collect(const data_point& value,
+               std::vector<std::uint32_t>* positions = nullptr);
+
+  /**
+   * Position of a given string in this pool, adding it if necessary, and
+   * appending it to a given list of positions if set.
+   */
+  std::uint32_t add(const std::string& value,
+                    std::vector<std::uint32_t>* positions);
+
+  /**
+   * Prevents further changes to this pool, so that it can be shared by
+   * threads that serialize testcases whose strings were collected.
+   */
+  void freeze() noexcept { _frozen = true; }
+
+  const std::vector<std::string>& strings() const noexcept {
+    return _strings;
+  }
+
+ private:
+  std::unordered_map<std::string, std::uint32_t> _positions;
+  std::vector<std::string> _strings;
+  bool _frozen = false;
+};
+
+/**
+ * Resolves strings of serialized testcases that may either be stored
+ * inline or refer to the shared strings of a result file in binary format
+ * v2. An empty table resolves only strings that are stored inline.
+ */
+class TOUCA_CLIENT_API StringTable {
+ public:
+  StringTable() = default;
+
+  explicit StringTable(std::vector<std::string> strings);
+
+  /**
+   * @param messages serialized test results that may have shared strings
+   */
+  explicit StringTable(const fbs::Messages* messages);
+
+  /**
+   * @param value string stored inline, if any
+   * @param ref position of the shared string if `value` is not set
+   * @throw touca::detail::runtime_error if the reference is out of range
+   */
+  const char* get(const flatbuffers::String* value,
+                  const std::uint32_t ref) const;
+
+  std::size_t size() const noexcept { return _strings.size(); }
+
+ private:
+  std::vector<std::string> _strings;
+};
+
+}  // namespace detail
+}  // namespace touca
@@ -2,8 +2,10 @@
 
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <map>
+#include <memory>
 #include <unordered_map>
 
 #include "rapidjson/fwd.h"
@@ -16,6 +18,25 @@ class TestcaseComparison;
 
 enum class ResultCategory { Check = 1, Assert };
 
+/**
+ * Revisions of the binary format in which test results are serialized.
+ * Readers support all revisions.
+ */
+enum class BinaryFormat : std::uint8_t {
+  /** format understood by all versions of Touca and the Touca server */
+  V1 = 1,
+  /**
+   * stores keys, object names and short string values once for each
+   * list of serialized testcases and refers to them by position
+   */
+  V2 = 2,
+  /**
+   * extends v2 by storing scalar values inline rather than in tables of
+   * their own, and arrays of scalars of the same type as typed vectors
+   */
+  V3 = 3
+};
+
 struct MetricsMapValue {
   data_point value;
 };
@@ -31,6 +52,7 @@ using ResultsMap = std::map<std::string, ResultEntry>;
 class TOUCA_CLIENT_API Testcase {
   friend class ClientImpl;
   friend class TestcaseComparison;
+  friend class touca::detail::JsonWriter;
 
  public:
   struct TOUCA_CLIENT_API Overview {
@@ -84,7 +106,51 @@ class TOUCA_CLIENT_API Testcase {
 
   rapidjson::Value json(RJAllocator& allocator) const;
 
-  std::vector<uint8_t> flatbuffers() const;
+  /**
+   * @param strings pool of shared strings of the list of testcases that
+   *        this testcase is serialized with, for binary format v2.
+   * @param compact whether to store scalars inline, for binary format v3.
+   */
+  std::vector<uint8_t> flatbuffers(touca::detail::StringPool* strings = nullptr,
+                                   const bool compact = false) const;
+
+  /**
+   * Serializes this testcase into a given builder and finishes it, so
+   * that callers can reuse the memory of the builder from one testcase
+   * to the next.
+   *
+   * @param builder builder that has no content or was just cleared
+   */
+  void flatbuffers(flatbuffers::FlatBufferBuilder& builder,
+                   touca::detail::StringPool* strings = nullptr,
+                   const bool compact = false) const;
+
+  /**
+   * Adds the strings that serializing this testcase with a given pool
+   * would add to it, in the same order.
+   *
+   * @param positions if set, receives the position of each string that
+   *        serialization would refer to, in the same order
+   */
+  void collect_strings(
+      touca::detail::StringPool& strings,
+      std::vector<std::uint32_t>* positions = nullptr) const;
+
+  /**
+   * Serializes this testcase in a given binary format, reusing the
+   * outcome of the previous call for the same format if this testcase has
+   * not changed since and its shared strings have kept their positions.
+   * The outcome remains valid until this testcase is changed.
+   *
+   * @param builder builder that has no content or was just cleared, that
+   *        this testcase is serialized into unless it can be reused
+   * @param format revision of the binary format to use
+   * @param strings pool of shared strings of the list of testcases that
+   *        this testcase is serialized with, for binary format v2 and v3.
+   */
+  const std::vector<std::uint8_t>& encode(
+      flatbuffers::FlatBufferBuilder& builder, const BinaryFormat format,
+      touca::detail::StringPool* strings = nullptr) const;
 
   Metadata metadata() const;
 
@@ -97,17 +163,36 @@ class TOUCA_CLIENT_API Testcase {
    * data compliant with Touca flatbuffers schema.
    *
    * @param testcases list of `Testcase` objects to be serialized
+   * @param format revision of the binary format to use
+   * @param concurrency number of threads to use for serializing
+   *        testcases. `0` uses as many threads as the hardware supports.
    * @return serialized binary data in flatbuffers format
+   * @see touca::detail::MessagesWriter to serialize without copying the
+   *      output
    */
-  static std::vector<uint8_t> serialize(const std::vector<Testcase>& testcases);
+  static std::vector<uint8_t> serialize(
+      const std::vector<Testcase>& testcases,
+      const BinaryFormat format = BinaryFormat::V1,
+      const std::size_t concurrency = 1);
 
  private:
+  struct Encoding;
+
+  /** marks this testcase as changed since it was last posted or encoded */
+  void changed();
+
   bool _posted;
   Metadata _metadata;
   ResultsMap _resultsMap;
 
   std::unordered_map<std::string, std::chrono::system_clock::time_point> _tics;
   std::unordered_map<std::string, std::chrono::system_clock::time_point> _tocs;
+
+  /**
+   * Most recent encoding of this testcase in each binary format. Copies
+   * of this testcase share encodings until either of them is changed.
+   */
+  mutable std::array<std::shared_ptr<const Encoding>, 3> _encodings;
 };
 
 using ElementsMap = std::unordered_map<std::string, std::shared_ptr<Testcase>>;
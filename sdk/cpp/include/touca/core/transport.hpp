@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -39,7 +41,11 @@ struct Transport {
                          const std::string& body = "") const = 0;
   virtual Response post(const std::string& route,
                         const std::string& body = "") const = 0;
-  virtual Response binary(const std::string& route, const std::string& content,
+  /**
+   * Submits binary content in place, without copying it into a string.
+   */
+  virtual Response binary(const std::string& route,
+                          const std::uint8_t* content, const std::size_t size,
                           const Headers& headers = {}) const = 0;
   virtual ~Transport() = default;
 };
@@ -49,8 +55,8 @@ struct DefaultTransport : public Transport {
   Response get(const std::string& route) const;
   Response patch(const std::string& route, const std::string& body = "") const;
   Response post(const std::string& route, const std::string& body = "") const;
-  Response binary(const std::string& route, const std::string& content,
-                  const Headers& headers) const;
+  Response binary(const std::string& route, const std::uint8_t* content,
+                  const std::size_t size, const Headers& headers) const;
   DefaultTransport();
   ~DefaultTransport();
 
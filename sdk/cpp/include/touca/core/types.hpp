@@ -37,6 +37,8 @@ struct TypeWrapper;
 using RJAllocator = rapidjson::MemoryPoolAllocator<rapidjson::CrtAllocator>;
 
 namespace detail {
+class JsonWriter;
+class StringPool;
 
 enum class TOUCA_CLIENT_API internal_type : std::uint8_t {
   null,
@@ -136,6 +138,8 @@ class TOUCA_CLIENT_API data_point {
       const data_point& input);
   friend rapidjson::Value to_json(const data_point& value,
                                   RJAllocator& allocator);
+  friend class touca::detail::JsonWriter;
+  friend class touca::detail::StringPool;
 
  public:
   data_point(const array& value)
@@ -230,8 +234,15 @@ class TOUCA_CLIENT_API data_point {
     return touca::detail::get<detail::number_signed_t>(_value);
   }
 
+  /**
+   * @param strings optional pool of shared strings, for serializing in
+   *        binary format v2 and later
+   * @param compact whether to store scalars inline, as in binary format v3
+   */
   flatbuffers::Offset<fbs::TypeWrapper> serialize(
-      flatbuffers::FlatBufferBuilder& builder) const;
+      flatbuffers::FlatBufferBuilder& builder,
+      touca::detail::StringPool* strings = nullptr,
+      const bool compact = false) const;
 
  private:
   // default, null
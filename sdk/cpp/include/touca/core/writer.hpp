@@ -0,0 +1,148 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "touca/core/string_table.hpp"
+#include "touca/core/testcase.hpp"
+#include "touca/lib_api.hpp"
+
+namespace flatbuffers {
+class FlatBufferBuilder;
+}  // namespace flatbuffers
+
+namespace touca {
+class TestcaseView;
+namespace detail {
+
+/**
+ * Counters of the work done by a `MessagesWriter` since it was created.
+ */
+struct WriterStats {
+  /** number of buffers allocated, including when a buffer has to grow */
+  std::uint64_t allocations = 0;
+  /** number of bytes copied from one buffer to another */
+  std::uint64_t bytes_copied = 0;
+};
+
+/**
+ * Serializes lists of testcases into the binary format of result files.
+ *
+ * Each testcase is serialized into a scratch buffer and kept by the
+ * testcase as its encoding, which is copied into the output buffer and
+ * reused by later calls until the testcase changes. A message is thus
+ * copied twice when its testcase is serialized afresh, once into the
+ * encoding and once into the output buffer, and once when the encoding
+ * is reused, such as when the same results are saved and submitted in
+ * binary format v1.
+ * Buffers are kept from one testcase and from one list of testcases to
+ * the next, so they are only allocated again when they need to grow. The
+ * output is exposed in place, to be written to disk or submitted without
+ * another copy.
+ *
+ * Large lists of testcases may be serialized on multiple threads, each
+ * with its own pooled buffers. Testcases are split into contiguous chunks
+ * whose messages are copied into the output buffer in their original
+ * order, so the output does not depend on the number of threads.
+ */
+class TOUCA_CLIENT_API MessagesWriter {
+ public:
+  MessagesWriter();
+
+  ~MessagesWriter();
+
+  /**
+   * Serializes a given list of testcases, replacing the output of any
+   * previous call.
+   *
+   * @param testcases list of testcases to be serialized
+   * @param format revision of the binary format to use
+   * @param concurrency maximum number of threads to use. `0` uses as
+   *        many threads as the hardware supports.
+   */
+  void write(const std::vector<Testcase>& testcases,
+             const BinaryFormat format = BinaryFormat::V1,
+             const std::size_t concurrency = 1);
+
+  /**
+   * Serialized content of the most recent call to `write`, which remains
+   * valid until the next call.
+   */
+  const std::uint8_t* data() const;
+
+  std::size_t size() const;
+
+  WriterStats stats() const noexcept;
+
+ private:
+  class CountingAllocator;
+  struct Chunk;
+
+  std::vector<const std::vector<std::uint8_t>*> encode_chunks(
+      const std::vector<Testcase>& testcases, const BinaryFormat format,
+      StringPool* strings, const std::size_t threads);
+
+  WriterStats _stats;
+  std::vector<std::unique_ptr<Chunk>> _chunks;
+  std::unique_ptr<CountingAllocator> _allocator;
+  std::unique_ptr<flatbuffers::FlatBufferBuilder> _output;
+  std::unique_ptr<flatbuffers::FlatBufferBuilder> _scratch;
+};
+
+/**
+ * Combines the testcases of lists of serialized testcases, such as result
+ * files, into a single list of serialized testcases in a given binary
+ * format, without holding their decoded content in memory.
+ *
+ * Testcases of lists in binary format v1, which have no shared strings,
+ * are copied as they are stored when the output is also in binary format
+ * v1. Other testcases are stored in a different layout or refer to shared
+ * strings by their position in their own list, so they are decoded one at
+ * a time and serialized again in the format and with the shared strings
+ * of the output.
+ */
+class TOUCA_CLIENT_API MessagesMerger {
+ public:
+  explicit MessagesMerger(const BinaryFormat format = BinaryFormat::V1);
+
+  ~MessagesMerger();
+
+  /**
+   * Adds the testcases of a given list of serialized testcases, which may
+   * be compressed and may be followed by an index.
+   *
+   * @param filter optional function that is given each testcase and
+   *        returns whether to add it
+   * @throw touca::detail::runtime_error if the content does not represent
+   *        valid test results
+   */
+  void add(const std::uint8_t* data, const std::size_t size,
+           const std::function<bool(const TestcaseView&)>& filter = nullptr);
+
+  /** Completes the output, after which no testcase may be added. */
+  void finish();
+
+  /** Serialized content of the output, once completed. */
+  const std::uint8_t* data() const;
+
+  std::size_t size() const;
+
+  /** number of testcases added so far */
+  std::size_t count() const noexcept { return _buffers.size(); }
+
+ private:
+  BinaryFormat _format;
+  StringPool _pool;
+  /** offsets of the added testcases in the output buffer */
+  std::vector<std::uint32_t> _buffers;
+  std::unique_ptr<flatbuffers::FlatBufferBuilder> _output;
+  std::unique_ptr<flatbuffers::FlatBufferBuilder> _scratch;
+};
+
+}  // namespace detail
+}  // namespace touca
@@ -73,6 +73,15 @@ struct MessageBufferBuilder;
 struct Messages;
 struct MessagesBuilder;
 
+struct IndexKey;
+struct IndexKeyBuilder;
+
+struct IndexEntry;
+struct IndexEntryBuilder;
+
+struct Index;
+struct IndexBuilder;
+
 enum class Type : uint8_t {
   NONE = 0,
   Bool = 1,
@@ -193,17 +202,35 @@ struct TypeWrapper FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef TypeWrapperBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_VALUE_TYPE = 4,
-    VT_VALUE = 6
+    VT_VALUE = 6,
+    VT_BOOL_VALUE = 8,
+    VT_INT_VALUE = 10,
+    VT_UINT_VALUE = 12,
+    VT_FLOAT_VALUE = 14,
+    VT_DOUBLE_VALUE = 16
   };
   touca::fbs::Type value_type() const {
     return static_cast<touca::fbs::Type>(GetField<uint8_t>(VT_VALUE_TYPE, 0));
   }
   const void* value() const { return GetPointer<const void*>(VT_VALUE); }
+  bool bool_value() const { return GetField<uint8_t>(VT_BOOL_VALUE, 0) != 0; }
+  int64_t int_value() const { return GetField<int64_t>(VT_INT_VALUE, 0); }
+  uint64_t uint_value() const { return GetField<uint64_t>(VT_UINT_VALUE, 0); }
+  float float_value() const { return GetField<float>(VT_FLOAT_VALUE, 0.0f); }
+  double double_value() const {
+    return GetField<double>(VT_DOUBLE_VALUE, 0.0);
+  }
   bool Verify(flatbuffers::Verifier& verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyField<uint8_t>(verifier, VT_VALUE_TYPE) &&
            VerifyOffset(verifier, VT_VALUE) &&
-           VerifyType(verifier, value(), value_type()) && verifier.EndTable();
+           VerifyType(verifier, value(), value_type()) &&
+           VerifyField<uint8_t>(verifier, VT_BOOL_VALUE) &&
+           VerifyField<int64_t>(verifier, VT_INT_VALUE) &&
+           VerifyField<uint64_t>(verifier, VT_UINT_VALUE) &&
+           VerifyField<float>(verifier, VT_FLOAT_VALUE) &&
+           VerifyField<double>(verifier, VT_DOUBLE_VALUE) &&
+           verifier.EndTable();
   }
 };
 
@@ -218,6 +245,22 @@ struct TypeWrapperBuilder {
   void add_value(flatbuffers::Offset<void> value) {
     fbb_.AddOffset(TypeWrapper::VT_VALUE, value);
   }
+  void add_bool_value(bool bool_value) {
+    fbb_.AddElement<uint8_t>(TypeWrapper::VT_BOOL_VALUE,
+                             static_cast<uint8_t>(bool_value), 0);
+  }
+  void add_int_value(int64_t int_value) {
+    fbb_.AddElement<int64_t>(TypeWrapper::VT_INT_VALUE, int_value, 0);
+  }
+  void add_uint_value(uint64_t uint_value) {
+    fbb_.AddElement<uint64_t>(TypeWrapper::VT_UINT_VALUE, uint_value, 0);
+  }
+  void add_float_value(float float_value) {
+    fbb_.AddElement<float>(TypeWrapper::VT_FLOAT_VALUE, float_value, 0.0f);
+  }
+  void add_double_value(double double_value) {
+    fbb_.AddElement<double>(TypeWrapper::VT_DOUBLE_VALUE, double_value, 0.0);
+  }
   explicit TypeWrapperBuilder(flatbuffers::FlatBufferBuilder& _fbb)
       : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -232,9 +275,16 @@ struct TypeWrapperBuilder {
 inline flatbuffers::Offset<TypeWrapper> CreateTypeWrapper(
     flatbuffers::FlatBufferBuilder& _fbb,
     touca::fbs::Type value_type = touca::fbs::Type::NONE,
-    flatbuffers::Offset<void> value = 0) {
+    flatbuffers::Offset<void> value = 0, bool bool_value = false,
+    int64_t int_value = 0, uint64_t uint_value = 0, float float_value = 0.0f,
+    double double_value = 0.0) {
   TypeWrapperBuilder builder_(_fbb);
+  builder_.add_double_value(double_value);
+  builder_.add_uint_value(uint_value);
+  builder_.add_int_value(int_value);
+  builder_.add_float_value(float_value);
   builder_.add_value(value);
+  builder_.add_bool_value(bool_value);
   builder_.add_value_type(value_type);
   return builder_.Finish();
 }
@@ -433,14 +483,17 @@ inline flatbuffers::Offset<Double> CreateDouble(
 struct String FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef StringBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
-    VT_VALUE = 4
+    VT_VALUE = 4,
+    VT_VALUE_REF = 6
   };
   const flatbuffers::String* value() const {
     return GetPointer<const flatbuffers::String*>(VT_VALUE);
   }
+  uint32_t value_ref() const { return GetField<uint32_t>(VT_VALUE_REF, 0); }
   bool Verify(flatbuffers::Verifier& verifier) const {
     return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_VALUE) &&
-           verifier.VerifyString(value()) && verifier.EndTable();
+           verifier.VerifyString(value()) &&
+           VerifyField<uint32_t>(verifier, VT_VALUE_REF) && verifier.EndTable();
   }
 };
 
@@ -451,6 +504,9 @@ struct StringBuilder {
   void add_value(flatbuffers::Offset<flatbuffers::String> value) {
     fbb_.AddOffset(String::VT_VALUE, value);
   }
+  void add_value_ref(uint32_t value_ref) {
+    fbb_.AddElement<uint32_t>(String::VT_VALUE_REF, value_ref, 0);
+  }
   explicit StringBuilder(flatbuffers::FlatBufferBuilder& _fbb) : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
@@ -463,23 +519,27 @@ struct StringBuilder {
 
 inline flatbuffers::Offset<String> CreateString(
     flatbuffers::FlatBufferBuilder& _fbb,
-    flatbuffers::Offset<flatbuffers::String> value = 0) {
+    flatbuffers::Offset<flatbuffers::String> value = 0,
+    uint32_t value_ref = 0) {
   StringBuilder builder_(_fbb);
+  builder_.add_value_ref(value_ref);
   builder_.add_value(value);
   return builder_.Finish();
 }
 
 inline flatbuffers::Offset<String> CreateStringDirect(
-    flatbuffers::FlatBufferBuilder& _fbb, const char* value = nullptr) {
+    flatbuffers::FlatBufferBuilder& _fbb, const char* value = nullptr,
+    uint32_t value_ref = 0) {
   auto value__ = value ? _fbb.CreateString(value) : 0;
-  return touca::fbs::CreateString(_fbb, value__);
+  return touca::fbs::CreateString(_fbb, value__, value_ref);
 }
 
 struct ObjectMember FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef ObjectMemberBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_NAME = 4,
-    VT_VALUE = 6
+    VT_VALUE = 6,
+    VT_NAME_REF = 8
   };
   const flatbuffers::String* name() const {
     return GetPointer<const flatbuffers::String*>(VT_NAME);
@@ -487,10 +547,12 @@ struct ObjectMember FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const touca::fbs::TypeWrapper* value() const {
     return GetPointer<const touca::fbs::TypeWrapper*>(VT_VALUE);
   }
+  uint32_t name_ref() const { return GetField<uint32_t>(VT_NAME_REF, 0); }
   bool Verify(flatbuffers::Verifier& verifier) const {
     return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_NAME) &&
            verifier.VerifyString(name()) && VerifyOffset(verifier, VT_VALUE) &&
-           verifier.VerifyTable(value()) && verifier.EndTable();
+           verifier.VerifyTable(value()) &&
+           VerifyField<uint32_t>(verifier, VT_NAME_REF) && verifier.EndTable();
   }
 };
 
@@ -504,6 +566,9 @@ struct ObjectMemberBuilder {
   void add_value(flatbuffers::Offset<touca::fbs::TypeWrapper> value) {
     fbb_.AddOffset(ObjectMember::VT_VALUE, value);
   }
+  void add_name_ref(uint32_t name_ref) {
+    fbb_.AddElement<uint32_t>(ObjectMember::VT_NAME_REF, name_ref, 0);
+  }
   explicit ObjectMemberBuilder(flatbuffers::FlatBufferBuilder& _fbb)
       : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -518,8 +583,10 @@ struct ObjectMemberBuilder {
 inline flatbuffers::Offset<ObjectMember> CreateObjectMember(
     flatbuffers::FlatBufferBuilder& _fbb,
     flatbuffers::Offset<flatbuffers::String> name = 0,
-    flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0) {
+    flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0,
+    uint32_t name_ref = 0) {
   ObjectMemberBuilder builder_(_fbb);
+  builder_.add_name_ref(name_ref);
   builder_.add_value(value);
   builder_.add_name(name);
   return builder_.Finish();
@@ -527,16 +594,18 @@ inline flatbuffers::Offset<ObjectMember> CreateObjectMember(
 
 inline flatbuffers::Offset<ObjectMember> CreateObjectMemberDirect(
     flatbuffers::FlatBufferBuilder& _fbb, const char* name = nullptr,
-    flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0) {
+    flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0,
+    uint32_t name_ref = 0) {
   auto name__ = name ? _fbb.CreateString(name) : 0;
-  return touca::fbs::CreateObjectMember(_fbb, name__, value);
+  return touca::fbs::CreateObjectMember(_fbb, name__, value, name_ref);
 }
 
 struct Object FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef ObjectBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_KEY = 4,
-    VT_VALUES = 6
+    VT_VALUES = 6,
+    VT_KEY_REF = 8
   };
   const flatbuffers::String* key() const {
     return GetPointer<const flatbuffers::String*>(VT_KEY);
@@ -546,11 +615,13 @@ struct Object FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
     return GetPointer<const flatbuffers::Vector<
         flatbuffers::Offset<touca::fbs::ObjectMember>>*>(VT_VALUES);
   }
+  uint32_t key_ref() const { return GetField<uint32_t>(VT_KEY_REF, 0); }
   bool Verify(flatbuffers::Verifier& verifier) const {
     return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_KEY) &&
            verifier.VerifyString(key()) && VerifyOffset(verifier, VT_VALUES) &&
            verifier.VerifyVector(values()) &&
-           verifier.VerifyVectorOfTables(values()) && verifier.EndTable();
+           verifier.VerifyVectorOfTables(values()) &&
+           VerifyField<uint32_t>(verifier, VT_KEY_REF) && verifier.EndTable();
   }
 };
 
@@ -567,6 +638,9 @@ struct ObjectBuilder {
           values) {
     fbb_.AddOffset(Object::VT_VALUES, values);
   }
+  void add_key_ref(uint32_t key_ref) {
+    fbb_.AddElement<uint32_t>(Object::VT_KEY_REF, key_ref, 0);
+  }
   explicit ObjectBuilder(flatbuffers::FlatBufferBuilder& _fbb) : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
@@ -582,8 +656,10 @@ inline flatbuffers::Offset<Object> CreateObject(
     flatbuffers::Offset<flatbuffers::String> key = 0,
     flatbuffers::Offset<
         flatbuffers::Vector<flatbuffers::Offset<touca::fbs::ObjectMember>>>
-        values = 0) {
+        values = 0,
+    uint32_t key_ref = 0) {
   ObjectBuilder builder_(_fbb);
+  builder_.add_key_ref(key_ref);
   builder_.add_values(values);
   builder_.add_key(key);
   return builder_.Finish();
@@ -592,29 +668,58 @@ inline flatbuffers::Offset<Object> CreateObject(
 inline flatbuffers::Offset<Object> CreateObjectDirect(
     flatbuffers::FlatBufferBuilder& _fbb, const char* key = nullptr,
     const std::vector<flatbuffers::Offset<touca::fbs::ObjectMember>>* values =
-        nullptr) {
+        nullptr,
+    uint32_t key_ref = 0) {
   auto key__ = key ? _fbb.CreateString(key) : 0;
   auto values__ =
       values ? _fbb.CreateVector<flatbuffers::Offset<touca::fbs::ObjectMember>>(
                    *values)
              : 0;
-  return touca::fbs::CreateObject(_fbb, key__, values__);
+  return touca::fbs::CreateObject(_fbb, key__, values__, key_ref);
 }
 
 struct Array FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef ArrayBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
-    VT_VALUES = 4
+    VT_VALUES = 4,
+    VT_BOOLS = 6,
+    VT_INTS = 8,
+    VT_UINTS = 10,
+    VT_FLOATS = 12,
+    VT_DOUBLES = 14
   };
   const flatbuffers::Vector<flatbuffers::Offset<touca::fbs::TypeWrapper>>*
   values() const {
     return GetPointer<const flatbuffers::Vector<
         flatbuffers::Offset<touca::fbs::TypeWrapper>>*>(VT_VALUES);
   }
+  const flatbuffers::Vector<uint8_t>* bools() const {
+    return GetPointer<const flatbuffers::Vector<uint8_t>*>(VT_BOOLS);
+  }
+  const flatbuffers::Vector<int64_t>* ints() const {
+    return GetPointer<const flatbuffers::Vector<int64_t>*>(VT_INTS);
+  }
+  const flatbuffers::Vector<uint64_t>* uints() const {
+    return GetPointer<const flatbuffers::Vector<uint64_t>*>(VT_UINTS);
+  }
+  const flatbuffers::Vector<float>* floats() const {
+    return GetPointer<const flatbuffers::Vector<float>*>(VT_FLOATS);
+  }
+  const flatbuffers::Vector<double>* doubles() const {
+    return GetPointer<const flatbuffers::Vector<double>*>(VT_DOUBLES);
+  }
   bool Verify(flatbuffers::Verifier& verifier) const {
     return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_VALUES) &&
            verifier.VerifyVector(values()) &&
-           verifier.VerifyVectorOfTables(values()) && verifier.EndTable();
+           verifier.VerifyVectorOfTables(values()) &&
+           VerifyOffset(verifier, VT_BOOLS) &&
+           verifier.VerifyVector(bools()) && VerifyOffset(verifier, VT_INTS) &&
+           verifier.VerifyVector(ints()) && VerifyOffset(verifier, VT_UINTS) &&
+           verifier.VerifyVector(uints()) &&
+           VerifyOffset(verifier, VT_FLOATS) &&
+           verifier.VerifyVector(floats()) &&
+           VerifyOffset(verifier, VT_DOUBLES) &&
+           verifier.VerifyVector(doubles()) && verifier.EndTable();
   }
 };
 
@@ -628,6 +733,21 @@ struct ArrayBuilder {
           values) {
     fbb_.AddOffset(Array::VT_VALUES, values);
   }
+  void add_bools(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> bools) {
+    fbb_.AddOffset(Array::VT_BOOLS, bools);
+  }
+  void add_ints(flatbuffers::Offset<flatbuffers::Vector<int64_t>> ints) {
+    fbb_.AddOffset(Array::VT_INTS, ints);
+  }
+  void add_uints(flatbuffers::Offset<flatbuffers::Vector<uint64_t>> uints) {
+    fbb_.AddOffset(Array::VT_UINTS, uints);
+  }
+  void add_floats(flatbuffers::Offset<flatbuffers::Vector<float>> floats) {
+    fbb_.AddOffset(Array::VT_FLOATS, floats);
+  }
+  void add_doubles(flatbuffers::Offset<flatbuffers::Vector<double>> doubles) {
+    fbb_.AddOffset(Array::VT_DOUBLES, doubles);
+  }
   explicit ArrayBuilder(flatbuffers::FlatBufferBuilder& _fbb) : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
@@ -642,8 +762,18 @@ inline flatbuffers::Offset<Array> CreateArray(
     flatbuffers::FlatBufferBuilder& _fbb,
     flatbuffers::Offset<
         flatbuffers::Vector<flatbuffers::Offset<touca::fbs::TypeWrapper>>>
-        values = 0) {
+        values = 0,
+    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> bools = 0,
+    flatbuffers::Offset<flatbuffers::Vector<int64_t>> ints = 0,
+    flatbuffers::Offset<flatbuffers::Vector<uint64_t>> uints = 0,
+    flatbuffers::Offset<flatbuffers::Vector<float>> floats = 0,
+    flatbuffers::Offset<flatbuffers::Vector<double>> doubles = 0) {
   ArrayBuilder builder_(_fbb);
+  builder_.add_doubles(doubles);
+  builder_.add_floats(floats);
+  builder_.add_uints(uints);
+  builder_.add_ints(ints);
+  builder_.add_bools(bools);
   builder_.add_values(values);
   return builder_.Finish();
 }
@@ -651,12 +781,23 @@ inline flatbuffers::Offset<Array> CreateArray(
 inline flatbuffers::Offset<Array> CreateArrayDirect(
     flatbuffers::FlatBufferBuilder& _fbb,
     const std::vector<flatbuffers::Offset<touca::fbs::TypeWrapper>>* values =
-        nullptr) {
+        nullptr,
+    const std::vector<uint8_t>* bools = nullptr,
+    const std::vector<int64_t>* ints = nullptr,
+    const std::vector<uint64_t>* uints = nullptr,
+    const std::vector<float>* floats = nullptr,
+    const std::vector<double>* doubles = nullptr) {
   auto values__ =
       values ? _fbb.CreateVector<flatbuffers::Offset<touca::fbs::TypeWrapper>>(
                    *values)
              : 0;
-  return touca::fbs::CreateArray(_fbb, values__);
+  auto bools__ = bools ? _fbb.CreateVector<uint8_t>(*bools) : 0;
+  auto ints__ = ints ? _fbb.CreateVector<int64_t>(*ints) : 0;
+  auto uints__ = uints ? _fbb.CreateVector<uint64_t>(*uints) : 0;
+  auto floats__ = floats ? _fbb.CreateVector<float>(*floats) : 0;
+  auto doubles__ = doubles ? _fbb.CreateVector<double>(*doubles) : 0;
+  return touca::fbs::CreateArray(_fbb, values__, bools__, ints__, uints__,
+                                 floats__, doubles__);
 }
 
 struct Blob FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -734,7 +875,8 @@ struct Result FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_KEY = 4,
     VT_VALUE = 6,
-    VT_TYP = 8
+    VT_TYP = 8,
+    VT_KEY_REF = 10
   };
   const flatbuffers::String* key() const {
     return GetPointer<const flatbuffers::String*>(VT_KEY);
@@ -745,11 +887,13 @@ struct Result FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   touca::fbs::ResultType typ() const {
     return static_cast<touca::fbs::ResultType>(GetField<uint8_t>(VT_TYP, 1));
   }
+  uint32_t key_ref() const { return GetField<uint32_t>(VT_KEY_REF, 0); }
   bool Verify(flatbuffers::Verifier& verifier) const {
     return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_KEY) &&
            verifier.VerifyString(key()) && VerifyOffset(verifier, VT_VALUE) &&
            verifier.VerifyTable(value()) &&
-           VerifyField<uint8_t>(verifier, VT_TYP) && verifier.EndTable();
+           VerifyField<uint8_t>(verifier, VT_TYP) &&
+           VerifyField<uint32_t>(verifier, VT_KEY_REF) && verifier.EndTable();
   }
 };
 
@@ -766,6 +910,9 @@ struct ResultBuilder {
   void add_typ(touca::fbs::ResultType typ) {
     fbb_.AddElement<uint8_t>(Result::VT_TYP, static_cast<uint8_t>(typ), 1);
   }
+  void add_key_ref(uint32_t key_ref) {
+    fbb_.AddElement<uint32_t>(Result::VT_KEY_REF, key_ref, 0);
+  }
   explicit ResultBuilder(flatbuffers::FlatBufferBuilder& _fbb) : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
@@ -780,8 +927,10 @@ inline flatbuffers::Offset<Result> CreateResult(
     flatbuffers::FlatBufferBuilder& _fbb,
     flatbuffers::Offset<flatbuffers::String> key = 0,
     flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0,
-    touca::fbs::ResultType typ = touca::fbs::ResultType::Check) {
+    touca::fbs::ResultType typ = touca::fbs::ResultType::Check,
+    uint32_t key_ref = 0) {
   ResultBuilder builder_(_fbb);
+  builder_.add_key_ref(key_ref);
   builder_.add_value(value);
   builder_.add_key(key);
   builder_.add_typ(typ);
@@ -791,9 +940,10 @@ inline flatbuffers::Offset<Result> CreateResult(
 inline flatbuffers::Offset<Result> CreateResultDirect(
     flatbuffers::FlatBufferBuilder& _fbb, const char* key = nullptr,
     flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0,
-    touca::fbs::ResultType typ = touca::fbs::ResultType::Check) {
+    touca::fbs::ResultType typ = touca::fbs::ResultType::Check,
+    uint32_t key_ref = 0) {
   auto key__ = key ? _fbb.CreateString(key) : 0;
-  return touca::fbs::CreateResult(_fbb, key__, value, typ);
+  return touca::fbs::CreateResult(_fbb, key__, value, typ, key_ref);
 }
 
 struct Assertion FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -810,7 +960,8 @@ struct Metric FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef MetricBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_KEY = 4,
-    VT_VALUE = 6
+    VT_VALUE = 6,
+    VT_KEY_REF = 8
   };
   const flatbuffers::String* key() const {
     return GetPointer<const flatbuffers::String*>(VT_KEY);
@@ -818,10 +969,12 @@ struct Metric FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const touca::fbs::TypeWrapper* value() const {
     return GetPointer<const touca::fbs::TypeWrapper*>(VT_VALUE);
   }
+  uint32_t key_ref() const { return GetField<uint32_t>(VT_KEY_REF, 0); }
   bool Verify(flatbuffers::Verifier& verifier) const {
     return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_KEY) &&
            verifier.VerifyString(key()) && VerifyOffset(verifier, VT_VALUE) &&
-           verifier.VerifyTable(value()) && verifier.EndTable();
+           verifier.VerifyTable(value()) &&
+           VerifyField<uint32_t>(verifier, VT_KEY_REF) && verifier.EndTable();
   }
 };
 
@@ -835,6 +988,9 @@ struct MetricBuilder {
   void add_value(flatbuffers::Offset<touca::fbs::TypeWrapper> value) {
     fbb_.AddOffset(Metric::VT_VALUE, value);
   }
+  void add_key_ref(uint32_t key_ref) {
+    fbb_.AddElement<uint32_t>(Metric::VT_KEY_REF, key_ref, 0);
+  }
   explicit MetricBuilder(flatbuffers::FlatBufferBuilder& _fbb) : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
@@ -848,8 +1004,10 @@ struct MetricBuilder {
 inline flatbuffers::Offset<Metric> CreateMetric(
     flatbuffers::FlatBufferBuilder& _fbb,
     flatbuffers::Offset<flatbuffers::String> key = 0,
-    flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0) {
+    flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0,
+    uint32_t key_ref = 0) {
   MetricBuilder builder_(_fbb);
+  builder_.add_key_ref(key_ref);
   builder_.add_value(value);
   builder_.add_key(key);
   return builder_.Finish();
@@ -857,9 +1015,10 @@ inline flatbuffers::Offset<Metric> CreateMetric(
 
 inline flatbuffers::Offset<Metric> CreateMetricDirect(
     flatbuffers::FlatBufferBuilder& _fbb, const char* key = nullptr,
-    flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0) {
+    flatbuffers::Offset<touca::fbs::TypeWrapper> value = 0,
+    uint32_t key_ref = 0) {
   auto key__ = key ? _fbb.CreateString(key) : 0;
-  return touca::fbs::CreateMetric(_fbb, key__, value);
+  return touca::fbs::CreateMetric(_fbb, key__, value, key_ref);
 }
 
 struct Results FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
@@ -1198,17 +1357,27 @@ inline flatbuffers::Offset<MessageBuffer> CreateMessageBufferDirect(
 struct Messages FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef MessagesBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
-    VT_MESSAGES = 4
+    VT_MESSAGES = 4,
+    VT_STRINGS = 6
   };
   const flatbuffers::Vector<flatbuffers::Offset<touca::fbs::MessageBuffer>>*
   messages() const {
     return GetPointer<const flatbuffers::Vector<
         flatbuffers::Offset<touca::fbs::MessageBuffer>>*>(VT_MESSAGES);
   }
+  const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>*
+  strings() const {
+    return GetPointer<
+        const flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>*>(
+        VT_STRINGS);
+  }
   bool Verify(flatbuffers::Verifier& verifier) const {
     return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_MESSAGES) &&
            verifier.VerifyVector(messages()) &&
-           verifier.VerifyVectorOfTables(messages()) && verifier.EndTable();
+           verifier.VerifyVectorOfTables(messages()) &&
+           VerifyOffset(verifier, VT_STRINGS) &&
+           verifier.VerifyVector(strings()) &&
+           verifier.VerifyVectorOfStrings(strings()) && verifier.EndTable();
   }
 };
 
@@ -1222,6 +1391,12 @@ struct MessagesBuilder {
           messages) {
     fbb_.AddOffset(Messages::VT_MESSAGES, messages);
   }
+  void add_strings(
+      flatbuffers::Offset<
+          flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+          strings) {
+    fbb_.AddOffset(Messages::VT_STRINGS, strings);
+  }
   explicit MessagesBuilder(flatbuffers::FlatBufferBuilder& _fbb) : fbb_(_fbb) {
     start_ = fbb_.StartTable();
   }
@@ -1236,8 +1411,12 @@ inline flatbuffers::Offset<Messages> CreateMessages(
     flatbuffers::FlatBufferBuilder& _fbb,
     flatbuffers::Offset<
         flatbuffers::Vector<flatbuffers::Offset<touca::fbs::MessageBuffer>>>
-        messages = 0) {
+        messages = 0,
+    flatbuffers::Offset<
+        flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+        strings = 0) {
   MessagesBuilder builder_(_fbb);
+  builder_.add_strings(strings);
   builder_.add_messages(messages);
   return builder_.Finish();
 }
@@ -1245,13 +1424,229 @@ inline flatbuffers::Offset<Messages> CreateMessages(
 inline flatbuffers::Offset<Messages> CreateMessagesDirect(
     flatbuffers::FlatBufferBuilder& _fbb,
     const std::vector<flatbuffers::Offset<touca::fbs::MessageBuffer>>*
-        messages = nullptr) {
+        messages = nullptr,
+    const std::vector<flatbuffers::Offset<flatbuffers::String>>* strings =
+        nullptr) {
   auto messages__ =
       messages
           ? _fbb.CreateVector<flatbuffers::Offset<touca::fbs::MessageBuffer>>(
                 *messages)
           : 0;
-  return touca::fbs::CreateMessages(_fbb, messages__);
+  auto strings__ =
+      strings ? _fbb.CreateVector<flatbuffers::Offset<flatbuffers::String>>(
+                    *strings)
+              : 0;
+  return touca::fbs::CreateMessages(_fbb, messages__, strings__);
+}
+
+struct IndexKey FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef IndexKeyBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_KEY = 4,
+    VT_POSITION = 6
+  };
+  const flatbuffers::String* key() const {
+    return GetPointer<const flatbuffers::String*>(VT_KEY);
+  }
+  bool KeyCompareLessThan(const IndexKey* o) const {
+    return *key() < *o->key();
+  }
+  int KeyCompareWithValue(const char* val) const {
+    return strcmp(key()->c_str(), val);
+  }
+  uint32_t position() const { return GetField<uint32_t>(VT_POSITION, 0); }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffsetRequired(verifier, VT_KEY) &&
+           verifier.VerifyString(key()) &&
+           VerifyField<uint32_t>(verifier, VT_POSITION) && verifier.EndTable();
+  }
+};
+
+struct IndexKeyBuilder {
+  typedef IndexKey Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_key(flatbuffers::Offset<flatbuffers::String> key) {
+    fbb_.AddOffset(IndexKey::VT_KEY, key);
+  }
+  void add_position(uint32_t position) {
+    fbb_.AddElement<uint32_t>(IndexKey::VT_POSITION, position, 0);
+  }
+  explicit IndexKeyBuilder(flatbuffers::FlatBufferBuilder& _fbb) : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<IndexKey> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<IndexKey>(end);
+    fbb_.Required(o, IndexKey::VT_KEY);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<IndexKey> CreateIndexKey(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    flatbuffers::Offset<flatbuffers::String> key = 0, uint32_t position = 0) {
+  IndexKeyBuilder builder_(_fbb);
+  builder_.add_position(position);
+  builder_.add_key(key);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<IndexKey> CreateIndexKeyDirect(
+    flatbuffers::FlatBufferBuilder& _fbb, const char* key = nullptr,
+    uint32_t position = 0) {
+  auto key__ = key ? _fbb.CreateString(key) : 0;
+  return touca::fbs::CreateIndexKey(_fbb, key__, position);
+}
+
+struct IndexEntry FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef IndexEntryBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_TESTCASE = 4,
+    VT_OFFSET = 6,
+    VT_SIZE = 8,
+    VT_KEYS = 10
+  };
+  const flatbuffers::String* testcase() const {
+    return GetPointer<const flatbuffers::String*>(VT_TESTCASE);
+  }
+  bool KeyCompareLessThan(const IndexEntry* o) const {
+    return *testcase() < *o->testcase();
+  }
+  int KeyCompareWithValue(const char* val) const {
+    return strcmp(testcase()->c_str(), val);
+  }
+  uint64_t offset() const { return GetField<uint64_t>(VT_OFFSET, 0); }
+  uint64_t size() const { return GetField<uint64_t>(VT_SIZE, 0); }
+  const flatbuffers::Vector<flatbuffers::Offset<touca::fbs::IndexKey>>* keys()
+      const {
+    return GetPointer<
+        const flatbuffers::Vector<flatbuffers::Offset<touca::fbs::IndexKey>>*>(
+        VT_KEYS);
+  }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffsetRequired(verifier, VT_TESTCASE) &&
+           verifier.VerifyString(testcase()) &&
+           VerifyField<uint64_t>(verifier, VT_OFFSET) &&
+           VerifyField<uint64_t>(verifier, VT_SIZE) &&
+           VerifyOffset(verifier, VT_KEYS) && verifier.VerifyVector(keys()) &&
+           verifier.VerifyVectorOfTables(keys()) && verifier.EndTable();
+  }
+};
+
+struct IndexEntryBuilder {
+  typedef IndexEntry Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_testcase(flatbuffers::Offset<flatbuffers::String> testcase) {
+    fbb_.AddOffset(IndexEntry::VT_TESTCASE, testcase);
+  }
+  void add_offset(uint64_t offset) {
+    fbb_.AddElement<uint64_t>(IndexEntry::VT_OFFSET, offset, 0);
+  }
+  void add_size(uint64_t size) {
+    fbb_.AddElement<uint64_t>(IndexEntry::VT_SIZE, size, 0);
+  }
+  void add_keys(flatbuffers::Offset<
+                flatbuffers::Vector<flatbuffers::Offset<touca::fbs::IndexKey>>>
+                    keys) {
+    fbb_.AddOffset(IndexEntry::VT_KEYS, keys);
+  }
+  explicit IndexEntryBuilder(flatbuffers::FlatBufferBuilder& _fbb)
+      : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<IndexEntry> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<IndexEntry>(end);
+    fbb_.Required(o, IndexEntry::VT_TESTCASE);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<IndexEntry> CreateIndexEntry(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    flatbuffers::Offset<flatbuffers::String> testcase = 0, uint64_t offset = 0,
+    uint64_t size = 0,
+    flatbuffers::Offset<
+        flatbuffers::Vector<flatbuffers::Offset<touca::fbs::IndexKey>>>
+        keys = 0) {
+  IndexEntryBuilder builder_(_fbb);
+  builder_.add_size(size);
+  builder_.add_offset(offset);
+  builder_.add_keys(keys);
+  builder_.add_testcase(testcase);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<IndexEntry> CreateIndexEntryDirect(
+    flatbuffers::FlatBufferBuilder& _fbb, const char* testcase = nullptr,
+    uint64_t offset = 0, uint64_t size = 0,
+    std::vector<flatbuffers::Offset<touca::fbs::IndexKey>>* keys = nullptr) {
+  auto testcase__ = testcase ? _fbb.CreateString(testcase) : 0;
+  auto keys__ =
+      keys ? _fbb.CreateVectorOfSortedTables<touca::fbs::IndexKey>(keys) : 0;
+  return touca::fbs::CreateIndexEntry(_fbb, testcase__, offset, size, keys__);
+}
+
+struct Index FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef IndexBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_TESTCASES = 4
+  };
+  const flatbuffers::Vector<flatbuffers::Offset<touca::fbs::IndexEntry>>*
+  testcases() const {
+    return GetPointer<const flatbuffers::Vector<
+        flatbuffers::Offset<touca::fbs::IndexEntry>>*>(VT_TESTCASES);
+  }
+  bool Verify(flatbuffers::Verifier& verifier) const {
+    return VerifyTableStart(verifier) && VerifyOffset(verifier, VT_TESTCASES) &&
+           verifier.VerifyVector(testcases()) &&
+           verifier.VerifyVectorOfTables(testcases()) && verifier.EndTable();
+  }
+};
+
+struct IndexBuilder {
+  typedef Index Table;
+  flatbuffers::FlatBufferBuilder& fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_testcases(
+      flatbuffers::Offset<
+          flatbuffers::Vector<flatbuffers::Offset<touca::fbs::IndexEntry>>>
+          testcases) {
+    fbb_.AddOffset(Index::VT_TESTCASES, testcases);
+  }
+  explicit IndexBuilder(flatbuffers::FlatBufferBuilder& _fbb) : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  flatbuffers::Offset<Index> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<Index>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<Index> CreateIndex(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    flatbuffers::Offset<
+        flatbuffers::Vector<flatbuffers::Offset<touca::fbs::IndexEntry>>>
+        testcases = 0) {
+  IndexBuilder builder_(_fbb);
+  builder_.add_testcases(testcases);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<Index> CreateIndexDirect(
+    flatbuffers::FlatBufferBuilder& _fbb,
+    std::vector<flatbuffers::Offset<touca::fbs::IndexEntry>>* testcases =
+        nullptr) {
+  auto testcases__ =
+      testcases
+          ? _fbb.CreateVectorOfSortedTables<touca::fbs::IndexEntry>(testcases)
+          : 0;
+  return touca::fbs::CreateIndex(_fbb, testcases__);
 }
 
 inline bool VerifyType(flatbuffers::Verifier& verifier, const void* obj,
@@ -2,49 +2,117 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "fmt/color.h"
 #include "touca/lib_api.hpp"
+#include "touca/runner/detail/prefetch.hpp"
+#include "touca/runner/detail/store.hpp"
 #include "touca/runner/runner.hpp"
 
 namespace touca {
 namespace detail {
 
+class MessagesMerger;
+
 using Status = Post::Status;
 
 /**
  * @brief Captures content printed to standard output and error streams.
+ *
+ * By default, captures content printed to `std::cout` and `std::cerr` and
+ * keeps it in memory. Optionally, captures content written to the file
+ * descriptors of the standard output and error, including content printed
+ * by C libraries, and streams it into files as it is printed.
  */
 struct TOUCA_CLIENT_API OutputCapturer {
+  struct Options {
+    /**
+     * Captures content written to file descriptors 1 and 2, instead of
+     * content printed to `std::cout` and `std::cerr`. Since file
+     * descriptors are shared by all threads of a process, content printed
+     * by other threads is captured as well. Not supported on Windows.
+     */
+    bool descriptors = false;
+    /**
+     * Maximum number of bytes to keep of each stream. Content beyond this
+     * limit is discarded and replaced by a note of how much was discarded.
+     * `0` keeps all content.
+     */
+    std::size_t limit = 0;
+    /**
+     * Files to stream captured content into, instead of keeping it in
+     * memory. Files are only created if content is captured.
+     */
+    touca::filesystem::path out_file;
+    touca::filesystem::path err_file;
+  };
+
   OutputCapturer();
+  explicit OutputCapturer(const Options& options);
   ~OutputCapturer();
 
   void start_capture();
   void stop_capture();
 
+  /** Returns captured content that was kept in memory. */
   std::string cerr() const;
+  /** Returns captured content that was kept in memory. */
   std::string cout() const;
 
  private:
+  struct Buffer;
+  struct Redirect;
+
+  Options _options;
   bool _capturing = false;
+  bool _routed = false;
   std::streambuf* _err;
   std::streambuf* _out;
-  std::stringstream _buf_err;
-  std::stringstream _buf_out;
+  std::unique_ptr<Buffer> _buf_err;
+  std::unique_ptr<Buffer> _buf_out;
+  std::unique_ptr<Redirect> _redirect;
+};
+
+/**
+ * @brief Lets testcases that run at the same time capture their output
+ *        separately.
+ *
+ * While an instance exists, content printed to the standard output and
+ * error streams is routed to the `OutputCapturer` started by the thread
+ * that prints it, if any, and `OutputCapturer` only captures content
+ * printed by the thread that starts it.
+ */
+struct TOUCA_CLIENT_API OutputRouter {
+  OutputRouter();
+  ~OutputRouter();
+
+ private:
+  struct Buffer;
+  std::unique_ptr<Buffer> _out;
+  std::unique_ptr<Buffer> _err;
 };
 
 struct Statistics {
   void inc(Status value);
   unsigned long count(Status value) const;
+  unsigned long total() const;
 
  private:
   std::map<Status, unsigned long> _v;
@@ -54,10 +122,13 @@ struct Timer {
   void tic(const std::string& key);
   void toc(const std::string& key);
   long long count(const std::string& key) const;
+  /** Forgets a key that is no longer needed, to keep the timer small. */
+  void erase(const std::string& key);
 
  private:
   std::unordered_map<std::string, std::chrono::system_clock::time_point> _tics;
   std::unordered_map<std::string, std::chrono::system_clock::time_point> _tocs;
+  mutable std::mutex _mutex;
 };
 
 struct Logger {
@@ -70,6 +141,7 @@ struct Logger {
  private:
   void publish(const Sink::Level level, const std::string& msg) const;
   std::vector<std::pair<std::unique_ptr<Sink>, Sink::Level>> _sinks;
+  mutable std::mutex _mutex;
 };
 
 struct Printer {
@@ -86,7 +158,8 @@ struct Printer {
                       const std::vector<std::string>& errors = {});
 
   void print_footer(const Statistics& stats, Timer& timer,
-                    const Workflow workflow, const RunnerOptions& options);
+                    const Workflow workflow, const RunnerOptions& options,
+                    const long long worker_setup_duration);
   void print_error(const std::string& msg);
 
  private:
@@ -120,19 +193,147 @@ struct Printer {
        {Status::Diff, std::make_tuple(fmt::terminal_color::yellow, "DIFF")}};
 };
 
+/**
+ * @brief Saves and submits the results of finished testcases on a
+ *        background thread, while the workflow runs the next testcase.
+ *
+ * Tasks run one at a time, in the order in which they are pushed. At most
+ * `capacity` tasks are held at once, so `push` blocks while the queue is
+ * full. The outcome of each task is reported on the thread that pushes
+ * tasks, in the order in which tasks were pushed, so that progress output
+ * does not depend on when tasks finish. An exception thrown by a task
+ * marks its testcase as failed.
+ *
+ * Tasks that are still queued when the queue is destroyed are run to
+ * completion before the destructor returns, but are not reported.
+ */
+struct TOUCA_CLIENT_API ResultQueue {
+  struct Result {
+    unsigned index;
+    std::string testcase;
+    Status status;
+    std::vector<std::string> errors;
+  };
+
+  using Task = std::function<Status()>;
+
+  ResultQueue(const std::size_t capacity,
+              const std::function<void(const Result&)> report);
+  ~ResultQueue();
+
+  /**
+   * Queues a task that determines the outcome of a given testcase. A
+   * task that is `nullptr` leaves the given status as is.
+   */
+  void push(const Result& result, const Task& task);
+
+  /** Reports tasks that have finished, without waiting for others. */
+  void poll();
+
+  /** Waits for all queued tasks to finish and reports them. */
+  void drain();
+
+ private:
+  struct Item {
+    Result result;
+    Task task;
+    bool started;
+    bool done;
+  };
+
+  void report_front(std::unique_lock<std::mutex>& lock);
+  void work();
+
+  const std::size_t _capacity;
+  const std::function<void(const Result&)> _report;
+  std::deque<Item> _items;
+  bool _stop = false;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::thread _thread;
+};
+
 struct Runner {
   Runner(const RunnerOptions& opts) : options(opts) {}
   void run_workflows();
 
  private:
+  /** Outcome of running a testcase, to be handed over to a ResultQueue. */
+  struct Outcome {
+    ResultQueue::Result result;
+    ResultQueue::Task task;
+    /** whether results were reused from the result cache */
+    bool reused;
+  };
+
+  /** Results of a testcase that are ready to be saved and submitted. */
+  struct FinishedTestcase {
+    std::string testcase;
+    std::vector<Testcase> results;
+    std::string cout;
+    std::string cerr;
+    touca::filesystem::path directory;
+    std::vector<std::string> errors;
+    /** key under which to keep the results in the result cache, if any */
+    std::string cache_key;
+    /** whether results were reused from the result cache */
+    bool reused = false;
+  };
+
   void run_workflow(const Workflow& workflow);
-  void run_testcase(const Workflow& workflow, const std::string& testcase,
-                    const unsigned index);
+  void run_testcases(const Workflow& workflow, ResultQueue& results,
+                     const std::size_t jobs);
+  void run_isolated_testcases(const Workflow& workflow, ResultQueue& results,
+                              const std::size_t jobs);
+  Outcome run_testcase(const Workflow& workflow, const std::string& testcase,
+                       const unsigned index, const std::string& worker_error);
+  /** Returns the result directory of a testcase, or nothing to skip it. */
+  touca::filesystem::path prepare_testcase(const Workflow& workflow,
+                                           const std::string& testcase);
+  /** Returns the key of a testcase in the result cache, if any. */
+  std::string make_cache_key(const Workflow& workflow,
+                             const std::string& testcase) const;
+  /** Returns the results of a testcase from the result cache, if any. */
+  std::shared_ptr<FinishedTestcase> find_cached_testcase(
+      const Workflow& workflow, const std::string& testcase,
+      const touca::filesystem::path& directory, const std::string& key) const;
+  /** Runs worker setup, returning an error message if it fails. */
+  std::string setup_worker(const Workflow& workflow);
+  std::shared_ptr<FinishedTestcase> execute_testcase(
+      const Workflow& workflow, const std::string& testcase,
+      const touca::filesystem::path& directory,
+      const std::string& worker_error) const;
+  Outcome finish_testcase(const unsigned index,
+                          const std::shared_ptr<FinishedTestcase>& finished);
+  /** Hands over the outcome of a testcase to be reported in order. */
+  void hand_over(ResultQueue& results, const Outcome& outcome);
+  Status save_testcase(const FinishedTestcase& finished);
+  /** Keeps the results of a testcase in the result cache. */
+  void keep_testcase(const FinishedTestcase& finished) const;
+  /** Adds the results saved for a testcase in binary format, if any. */
+  void add_saved_results(MessagesMerger& merger, const Workflow& workflow,
+                         const std::string& testcase) const;
 
   Timer timer;
   Logger logger;
   Printer printer;
   Statistics stats;
+  std::unique_ptr<ResultStore> store;
+  std::unique_ptr<Prefetcher> prefetcher;
+  std::unique_ptr<ResultStore> cache;
+  /** testcases to skip since they are not expected to fit in the budget */
+  std::unordered_set<std::string> excluded;
+  /** time after which testcases that have not started are skipped */
+  std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::time_point::max();
+  /**
+   * testcases handed over with results reused from the result cache that
+   * are not yet reported. only touched on the thread that hands over
+   * outcomes, which is also the thread that reports them.
+   */
+  std::unordered_multiset<std::string> reused;
+  /** milliseconds spent in worker setup, summed over all workers */
+  std::atomic<long long> worker_setup_duration{0};
   const RunnerOptions& options;
 };
 
@@ -0,0 +1,99 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "touca/client/detail/options.hpp"
+#include "touca/lib_api.hpp"
+
+namespace touca {
+namespace detail {
+
+/**
+ * @brief Loads the input of test cases ahead of time on a pool of threads,
+ *        so that loading the input of upcoming test cases overlaps with
+ *        running earlier test cases.
+ *
+ * Test cases are loaded in the order in which they are scheduled. Loaded
+ * input is kept until it is taken or discarded. While loaded input that
+ * is not yet taken takes more memory than a given budget, no other input
+ * is loaded ahead of time; test cases whose loading has not started by
+ * the time they are taken are loaded by the calling thread instead.
+ *
+ * Member functions may be called concurrently from multiple threads.
+ */
+class TOUCA_CLIENT_API Prefetcher {
+ public:
+  using Loader = std::function<TestcaseInput(const std::string&)>;
+
+  /**
+   * @param loader function that loads the input of a given test case
+   * @param threads number of threads that load input ahead of time
+   * @param budget number of bytes of memory that loaded input may take
+   *        before loading ahead of time is paused. `0` sets no limit.
+   */
+  Prefetcher(const Loader& loader, const std::size_t threads,
+             const std::size_t budget);
+
+  /**
+   * Waits for input that is being loaded and releases any input that was
+   * not taken.
+   */
+  ~Prefetcher();
+
+  /**
+   * Schedules the input of a given test case to be loaded ahead of time.
+   * Has no effect if the test case is already scheduled.
+   */
+  void schedule(const std::string& testcase);
+
+  /**
+   * Hands over the input of a given test case, waiting for it to be loaded
+   * if it is being loaded, or loading it on the calling thread if loading
+   * has not started.
+   *
+   * @throw any exception thrown by the loader for this test case
+   */
+  TestcaseInput take(const std::string& testcase);
+
+  /**
+   * Releases the input of a given scheduled test case that is not going to
+   * be taken, cancelling its loading if it has not started.
+   */
+  void discard(const std::string& testcase);
+
+ private:
+  enum class State : unsigned char { Queued, Loading, Loaded, Discarded };
+
+  struct Entry {
+    State state;
+    TestcaseInput input;
+    std::exception_ptr error;
+  };
+
+  void work();
+  void cancel(const std::string& testcase);
+
+  const Loader _loader;
+  const std::size_t _budget;
+  std::deque<std::string> _queue;
+  std::unordered_map<std::string, Entry> _entries;
+  std::size_t _memory = 0;
+  bool _stopped = false;
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  std::vector<std::thread> _threads;
+};
+
+}  // namespace detail
+}  // namespace touca
@@ -0,0 +1,110 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "touca/lib_api.hpp"
+
+namespace touca {
+namespace detail {
+
+/**
+ * @brief Runs tasks in a pool of child processes, so that a task that
+ *        crashes ends its child process instead of the calling process.
+ *
+ * Each child process is a copy of the calling process, made when the
+ * child is started, that runs one task at a time and sends back a reply
+ * over a pipe. Tasks and replies are lists of strings. A child process
+ * that exits while running a task is not reused: the task is reported as
+ * failed and a new child process is started for the next task. Child
+ * processes may also be retired after a given number of tasks, so that
+ * later tasks start from a fresh copy of the calling process.
+ *
+ * Child processes are made with `fork()`, at any point while tasks are
+ * submitted. Only the thread that calls `fork()` is copied into the child
+ * process, so any other thread of the calling process must not hold locks
+ * that tasks may need at that point. Callers that run other threads give
+ * a function to call before each child process is started, that brings
+ * those threads to a point where they hold no such lock. Member functions
+ * must be called from one thread.
+ */
+class TOUCA_CLIENT_API ProcessPool {
+ public:
+  using Message = std::vector<std::string>;
+  using Handler = std::function<Message(const Message&)>;
+
+  struct Reply {
+    /** identifier of the task, as given to `submit` */
+    std::size_t task;
+    /** reply of the child process, if it finished the task */
+    Message message;
+    /** description of how the child process exited, if it crashed */
+    std::string error;
+  };
+
+  /**
+   * @param size maximum number of child processes to run at once
+   * @param handler function that child processes call to run a task
+   * @param tasks_per_worker number of tasks after which a child process
+   *        is retired. `0` keeps child processes for any number of tasks.
+   * @param before_fork optional function to call before each child
+   *        process is started, to let other threads release their locks
+   * @throw touca::detail::runtime_error if the platform does not support
+   *        running tasks in child processes
+   */
+  ProcessPool(const std::size_t size, const Handler& handler,
+              const std::size_t tasks_per_worker = 0,
+              const std::function<void()>& before_fork = nullptr);
+
+  /**
+   * Lets idle child processes exit and waits for them. Child processes
+   * that are still running a task are killed.
+   */
+  ~ProcessPool();
+
+  /** Checks whether a task may be submitted without waiting. */
+  bool idle() const;
+
+  /** Checks whether any submitted task awaits its reply. */
+  bool busy() const;
+
+  /**
+   * Hands over a task to an idle child process, starting a new child
+   * process if there is none.
+   *
+   * @param task identifier to report with the reply to this task
+   * @param message task to pass to the handler
+   * @throw touca::detail::runtime_error if a child process is needed but
+   *        cannot be started
+   */
+  void submit(const std::size_t task, const Message& message);
+
+  /**
+   * Waits for any submitted task to finish or for the child process that
+   * runs it to exit.
+   *
+   * @throw touca::detail::runtime_error if no task awaits its reply
+   */
+  Reply receive();
+
+ private:
+  struct Worker;
+
+  void spawn();
+  std::string stop(const std::size_t index);
+
+  const std::size_t _size;
+  const Handler _handler;
+  const std::size_t _tasks_per_worker;
+  const std::function<void()> _before_fork;
+  std::vector<std::unique_ptr<Worker>> _workers;
+  void (*_sigpipe)(int) = nullptr;
+};
+
+}  // namespace detail
+}  // namespace touca
@@ -0,0 +1,114 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "touca/core/filesystem.hpp"
+#include "touca/lib_api.hpp"
+
+namespace touca {
+namespace detail {
+
+/**
+ * @brief Test results and captured output of a single testcase, as kept
+ *        in a `ResultStore`.
+ */
+struct ResultRecord {
+  /** Content that would otherwise be written to `touca.bin`. */
+  std::string binary;
+  /** Content that would otherwise be written to `touca.json`. */
+  std::string json;
+  /** Content that would otherwise be written to `stdout.txt`. */
+  std::string cout;
+  /** Content that would otherwise be written to `stderr.txt`. */
+  std::string cerr;
+};
+
+/**
+ * @brief Keeps the test results of all testcases of a given version of a
+ *        suite in a single append-only segment file, as an alternative to
+ *        writing a separate directory of files for each testcase.
+ *
+ * Each call to `append` adds a record to the end of `touca.seg` and an
+ * entry to `touca.idx`, an index of the position of each record in the
+ * segment. The index is loaded into memory when the store is opened so
+ * that looking up a testcase never touches the filesystem. A testcase
+ * appended more than once is represented by its most recent record.
+ *
+ * Member functions may be called concurrently from multiple threads.
+ *
+ * If the index does not match the segment, for instance because a
+ * previous run was interrupted between writing the two files, the index
+ * is rebuilt by scanning the segment and any incomplete record at the
+ * end of the segment is discarded.
+ */
+class TOUCA_CLIENT_API ResultStore {
+ public:
+  /**
+   * Opens the store in the given directory, creating it if it does not
+   * already exist.
+   *
+   * @throw touca::detail::runtime_error if the store cannot be opened
+   */
+  explicit ResultStore(const touca::filesystem::path& directory);
+
+  /**
+   * Checks whether the store has test results for a given testcase.
+   *
+   * @param testcase name of the testcase
+   * @param binary whether to look for results in binary format, as
+   *               opposed to results in JSON format
+   */
+  bool contains(const std::string& testcase, const bool binary) const;
+
+  /**
+   * Appends the test results and captured output of a given testcase to
+   * the store. Empty fields of the record are not stored.
+   *
+   * @throw touca::detail::runtime_error if the record cannot be written
+   */
+  void append(const std::string& testcase, const ResultRecord& record);
+
+  /**
+   * Reads back the most recent record of a given testcase.
+   *
+   * @throw touca::detail::runtime_error if the store has no record of the
+   *        given testcase or if the record cannot be read
+   */
+  ResultRecord read(const std::string& testcase) const;
+
+  /**
+   * Lists testcases with a record in the store, in the order in which
+   * they were first appended.
+   */
+  std::vector<std::string> testcases() const;
+
+ private:
+  struct Entry {
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint32_t fields;
+  };
+
+  void load_index();
+  void rebuild_index(const std::uint64_t segment_size);
+  void add_entry(const std::string& testcase, const Entry& entry);
+
+  touca::filesystem::path _segment_path;
+  touca::filesystem::path _index_path;
+  std::ofstream _segment;
+  std::ofstream _index;
+  std::uint64_t _segment_size = 0;
+  std::unordered_map<std::string, Entry> _entries;
+  std::vector<std::string> _order;
+  mutable std::mutex _mutex;
+};
+
+}  // namespace detail
+}  // namespace touca
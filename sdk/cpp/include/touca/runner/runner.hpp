@@ -25,6 +25,7 @@
  * @endcode
  */
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <string>
@@ -79,6 +80,140 @@ TOUCA_CLIENT_API void workflow(
     const std::function<void(const std::string&)> workflow_callback,
     const std::function<void(WorkflowOptions&)> options_callback = nullptr);
 
+/**
+ * Registers a test workflow whose test cases share a state object of type
+ * `State`, such as a dataset or a connection pool that is expensive to
+ * prepare.
+ *
+ * The state object is made once by `setup_callback`, before the first test
+ * case, and is passed to `workflow_callback` with each test case. It is
+ * destroyed after the last test case.
+ *
+ * @code
+ *  touca::workflow<Model>(
+ *      "classifier", []() { return Model("model.bin"); },
+ *      [](const std::string& testcase, Model& model) {
+ *        touca::check("label", model.classify(testcase));
+ *      });
+ * @endcode
+ *
+ * When test cases run on multiple threads, they share the same state
+ * object, which should then be safe to use from multiple threads. When test
+ * cases run in separate worker processes, each worker process has its own
+ * copy of the state object.
+ *
+ * @param name name of this test workflow to be used as the test suite slug
+ * @param setup_callback function that makes the state object
+ * @param workflow_callback function that calls your code under test once for
+ *                          each test case.
+ * @param options_callback optional function that helps you set certain
+ *                         configuration options for this particular workflow.
+ * @see `touca::WorkflowOptions` for a list of supported options.
+ */
+template <typename State>
+void workflow(
+    const std::string& name, const std::function<State()> setup_callback,
+    const std::function<void(const std::string&, State&)> workflow_callback,
+    const std::function<void(WorkflowOptions&)> options_callback = nullptr) {
+  const auto state = std::make_shared<std::unique_ptr<State>>();
+  workflow(
+      name,
+      [state, workflow_callback](const std::string& testcase) {
+        workflow_callback(testcase, **state);
+      },
+      [state, setup_callback, options_callback](WorkflowOptions& options) {
+        if (options_callback) {
+          options_callback(options);
+        }
+        const auto setup = options.setup;
+        options.setup = [state, setup_callback, setup]() {
+          state->reset(new State(setup_callback()));
+          if (setup) {
+            setup();
+          }
+        };
+        const auto teardown = options.teardown;
+        options.teardown = [state, teardown]() {
+          if (teardown) {
+            teardown();
+          }
+          state->reset();
+        };
+      });
+}
+
+namespace detail {
+
+/** Registers a given test workflow to be run by the test runner. */
+TOUCA_CLIENT_API void add_workflow(const Workflow& workflow);
+
+/** Approximate number of bytes of memory that a given value takes. */
+template <typename T>
+std::size_t input_size(const T&) {
+  return sizeof(T);
+}
+
+inline std::size_t input_size(const std::string& value) {
+  return sizeof(value) + value.capacity();
+}
+
+template <typename T>
+std::size_t input_size(const std::vector<T>& value) {
+  return sizeof(value) + value.capacity() * sizeof(T);
+}
+
+}  // namespace detail
+
+/**
+ * Registers a test workflow whose test cases each have an input of type
+ * `Input`, such as the content of an input file, that is slow to load.
+ *
+ * The input of each test case is loaded by `loader_callback` and passed
+ * to `workflow_callback`. When the test runner is instructed to prefetch
+ * input, it calls `loader_callback` ahead of time for upcoming test cases
+ * on separate threads, so that loading input, for instance from a network
+ * filesystem, overlaps with running earlier test cases. `loader_callback`
+ * should then be safe to call from multiple threads.
+ *
+ * @code
+ *  touca::workflow<std::string>(
+ *      "parser",
+ *      [](const std::string& testcase) { return read_file(testcase); },
+ *      [](const std::string& testcase, std::string& content) {
+ *        touca::check("output", parse(content));
+ *      });
+ * @endcode
+ *
+ * @param name name of this test workflow to be used as the test suite slug
+ * @param loader_callback function that loads the input of a test case.
+ * @param workflow_callback function that calls your code under test once for
+ *                          each test case, with its loaded input.
+ * @param options_callback optional function that helps you set certain
+ *                         configuration options for this particular workflow.
+ * @see `touca::RunnerOptions::prefetch` to load input ahead of time.
+ */
+template <typename Input>
+void workflow(
+    const std::string& name,
+    const std::function<Input(const std::string&)> loader_callback,
+    const std::function<void(const std::string&, Input&)> workflow_callback,
+    const std::function<void(WorkflowOptions&)> options_callback = nullptr) {
+  Workflow workflow;
+  workflow.suite = name;
+  workflow.loader = [loader_callback](const std::string& testcase) {
+    const auto input = std::make_shared<Input>(loader_callback(testcase));
+    return TestcaseInput{input, detail::input_size(*input)};
+  };
+  workflow.input_callback = [workflow_callback](const std::string& testcase,
+                                                TestcaseInput& input) {
+    workflow_callback(testcase, *std::static_pointer_cast<Input>(input.value));
+  };
+  if (options_callback) {
+    options_callback(workflow);
+  }
+  detail::add_workflow(workflow);
+}
+
 /**
  * High-level function that lets you customize the behavior of the built-in
  * test runner at runtime, before running the test workflows.
@@ -6,11 +6,13 @@
 #include <sstream>
 
 #include "rapidjson/document.h"
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
 #include "touca/client/detail/options.hpp"
+#include "touca/core/compression.hpp"
 #include "touca/core/filesystem.hpp"
+#include "touca/core/json_writer.hpp"
+#include "touca/core/reader.hpp"
 #include "touca/core/transport.hpp"
+#include "touca/core/writer.hpp"
 #include "touca/impl/schema.hpp"
 
 #ifdef _WIN32
@@ -83,6 +85,7 @@ std::shared_ptr<touca::Testcase> ClientImpl::declare_testcase(
   if (!_configured) {
     return nullptr;
   }
+  std::lock_guard<std::mutex> lock(_mutex);
   if (!_testcases.count(name)) {
     const auto& tc = std::make_shared<Testcase>(_options.team, _options.suite,
                                                 _options.version, name);
@@ -94,6 +97,7 @@ std::shared_ptr<touca::Testcase> ClientImpl::declare_testcase(
 }
 
 void ClientImpl::forget_testcase(const std::string& name) {
+  std::lock_guard<std::mutex> lock(_mutex);
   if (!_testcases.count(name)) {
     const auto err = touca::detail::format("key `{}` does not exist", name);
     notify_loggers(logger::Level::Warning, err);
@@ -103,46 +107,77 @@ void ClientImpl::forget_testcase(const std::string& name) {
   _testcases.erase(name);
 }
 
+std::shared_ptr<Testcase> ClientImpl::release_testcase(
+    const std::string& name) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  const auto it = _testcases.find(name);
+  if (it == _testcases.end()) {
+    return nullptr;
+  }
+  const auto testcase = it->second;
+  _testcases.erase(it);
+  // calls that capture results should no longer find the released
+  // testcase as the testcase most recently declared.
+  if (_mostRecentTestcase == name) {
+    _mostRecentTestcase.clear();
+  }
+  for (auto entry = _threadMap.begin(); entry != _threadMap.end();) {
+    if (entry->second == name) {
+      entry = _threadMap.erase(entry);
+    } else {
+      ++entry;
+    }
+  }
+  return testcase;
+}
+
 void ClientImpl::check(const std::string& key, const data_point& value) {
-  if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->check(key, value);
+  const auto testcase = find_last_testcase();
+  if (testcase) {
+    testcase->check(key, value);
   }
 }
 
 void ClientImpl::assume(const std::string& key, const data_point& value) {
-  if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->assume(key, value);
+  const auto testcase = find_last_testcase();
+  if (testcase) {
+    testcase->assume(key, value);
   }
 }
 
 void ClientImpl::add_array_element(const std::string& key,
                                    const data_point& value) {
-  if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->add_array_element(key, value);
+  const auto testcase = find_last_testcase();
+  if (testcase) {
+    testcase->add_array_element(key, value);
   }
 }
 
 void ClientImpl::add_hit_count(const std::string& key) {
-  if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->add_hit_count(key);
+  const auto testcase = find_last_testcase();
+  if (testcase) {
+    testcase->add_hit_count(key);
   }
 }
 
 void ClientImpl::add_metric(const std::string& key, const unsigned duration) {
-  if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->add_metric(key, duration);
+  const auto testcase = find_last_testcase();
+  if (testcase) {
+    testcase->add_metric(key, duration);
   }
 }
 
 void ClientImpl::start_timer(const std::string& key) {
-  if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->tic(key);
+  const auto testcase = find_last_testcase();
+  if (testcase) {
+    testcase->tic(key);
   }
 }
 
 void ClientImpl::stop_timer(const std::string& key) {
-  if (has_last_testcase()) {
-    _testcases.at(get_last_testcase())->toc(key);
+  const auto testcase = find_last_testcase();
+  if (testcase) {
+    testcase->toc(key);
   }
 }
 
@@ -153,6 +188,7 @@ void ClientImpl::save(const touca::filesystem::path& path,
     throw touca::detail::runtime_error("file already exists");
   }
 
+  std::lock_guard<std::mutex> lock(_mutex);
   auto tcs = testcases;
   if (tcs.empty()) {
     std::transform(
@@ -160,13 +196,43 @@ void ClientImpl::save(const touca::filesystem::path& path,
         [](const ElementsMap::value_type& kvp) { return kvp.first; });
   }
 
+  save(path, find_testcases(tcs), format);
+}
+
+void ClientImpl::save(const touca::filesystem::path& path,
+                      const std::vector<Testcase>& testcases,
+                      const DataFormat format) const {
   if (format == DataFormat::JSON) {
-    save_json(path, find_testcases(tcs));
+    save_json(path, testcases);
   } else {
-    save_flatbuffers(path, find_testcases(tcs));
+    save_flatbuffers(path, testcases);
   }
 }
 
+std::string ClientImpl::dump(const std::vector<Testcase>& testcases,
+                             const DataFormat format) const {
+  std::string content;
+  if (format == DataFormat::JSON) {
+    touca::detail::JsonWriter writer(content);
+    for (const auto& testcase : testcases) {
+      writer.write(testcase);
+    }
+    writer.finish();
+    return content;
+  }
+  touca::detail::MessagesWriter writer;
+  writer.write(testcases, find_binary_format(), 0);
+  const auto& index = make_index(writer.data(), writer.size());
+  std::vector<std::uint8_t> buffer;
+  buffer.reserve(writer.size() + index.size());
+  buffer.insert(buffer.end(), writer.data(), writer.data() + writer.size());
+  buffer.insert(buffer.end(), index.begin(), index.end());
+  if (_options.compress && touca::detail::has_compression()) {
+    buffer = touca::detail::compress(buffer.data(), buffer.size());
+  }
+  return std::string(buffer.begin(), buffer.end());
+}
+
 Post::Status ClientImpl::post(const Post::Options& options) const {
   // check that client is configured to submit test results
   if (!_configured || _options.offline) {
@@ -175,20 +241,47 @@ Post::Status ClientImpl::post(const Post::Options& options) const {
   }
   // we should only post testcases that we have not posted yet
   // or those that have changed since we last posted them.
-  std::vector<std::string> testcases;
-  for (const auto& tc : _testcases) {
-    if (!tc.second->_posted) {
-      testcases.emplace_back(tc.first);
+  std::vector<std::shared_ptr<Testcase>> testcases;
+  std::vector<Testcase> copies;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const auto& tc : _testcases) {
+      if (!tc.second->_posted) {
+        testcases.emplace_back(tc.second);
+        copies.emplace_back(*tc.second);
+      }
     }
   }
-  const auto& buffer = Testcase::serialize(find_testcases(testcases));
-  std::string content((const char*)buffer.data(), buffer.size());
-  const auto response = _transport->binary(
-      "/client/submit", content,
-      {{"X-Touca-Submission-Mode", options.submit_async ? "async" : "sync"}});
+  const auto status = submit(copies, options);
+  std::lock_guard<std::mutex> lock(_mutex);
   for (const auto& tc : testcases) {
-    _testcases.at(tc)->_posted = true;
+    tc->_posted = true;
+  }
+  return status;
+}
+
+Post::Status ClientImpl::submit(const std::vector<Testcase>& testcases,
+                                const Post::Options& options) const {
+  if (!_configured || _options.offline) {
+    throw touca::detail::runtime_error(
+        "client is not configured to contact server");
   }
+  // the server only reads results in binary format v1.
+  touca::detail::MessagesWriter writer;
+  writer.write(testcases, BinaryFormat::V1, 0);
+  Transport::Headers headers = {
+      {"X-Touca-Submission-Mode", options.submit_async ? "async" : "sync"}};
+  const std::uint8_t* content = writer.data();
+  std::size_t size = writer.size();
+  std::vector<std::uint8_t> compressed;
+  if (_options.compress && touca::detail::has_compression()) {
+    compressed = touca::detail::zlib_compress(content, size);
+    content = compressed.data();
+    size = compressed.size();
+    headers.emplace_back("Content-Encoding", "deflate");
+  }
+  const auto response =
+      _transport->binary("/client/submit", content, size, headers);
   if (response.status == 204) {
     return Post::Status::Sent;
   }
@@ -244,6 +337,15 @@ bool ClientImpl::has_last_testcase() const {
   return _threadMap.count(std::this_thread::get_id());
 }
 
+std::shared_ptr<Testcase> ClientImpl::find_last_testcase() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (!has_last_testcase()) {
+    return nullptr;
+  }
+  const auto it = _testcases.find(get_last_testcase());
+  return it == _testcases.end() ? nullptr : it->second;
+}
+
 std::string ClientImpl::get_last_testcase() const {
   // We do not expect this function to be called without calling
   // `has_last_testcase` first.
@@ -278,26 +380,50 @@ std::vector<Testcase> ClientImpl::find_testcases(
 
 void ClientImpl::save_json(const touca::filesystem::path& path,
                            const std::vector<Testcase>& testcases) const {
-  rapidjson::Document doc(rapidjson::kArrayType);
-  rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+  touca::detail::save_json_file(path.string(), testcases);
+}
 
-  for (const auto& testcase : testcases) {
-    doc.PushBack(testcase.json(allocator), allocator);
+BinaryFormat ClientImpl::find_binary_format() const {
+  if (_options.binary_format == "v2") {
+    return BinaryFormat::V2;
   }
-
-  rapidjson::StringBuffer strbuf;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
-  writer.SetMaxDecimalPlaces(3);
-  doc.Accept(writer);
-
-  touca::detail::save_text_file(path.string(), strbuf.GetString());
+  if (_options.binary_format == "v3") {
+    return BinaryFormat::V3;
+  }
+  return BinaryFormat::V1;
 }
 
 void ClientImpl::save_flatbuffers(
     const touca::filesystem::path& path,
     const std::vector<Testcase>& testcases) const {
-  touca::detail::save_binary_file(path.string(),
-                                  Testcase::serialize(testcases));
+  touca::detail::MessagesWriter writer;
+  writer.write(testcases, find_binary_format(), 0);
+  save_binary(path, writer.data(), writer.size());
+}
+
+std::size_t ClientImpl::save_merged(
+    const touca::filesystem::path& path,
+    const std::function<void(touca::detail::MessagesMerger&)>& add) const {
+  touca::detail::MessagesMerger merger(find_binary_format());
+  add(merger);
+  merger.finish();
+  save_binary(path, merger.data(), merger.size());
+  return merger.count();
+}
+
+void ClientImpl::save_binary(const touca::filesystem::path& path,
+                             const std::uint8_t* data,
+                             const std::size_t size) const {
+  const auto& index = make_index(data, size);
+  if (_options.compress && touca::detail::has_compression()) {
+    std::vector<std::uint8_t> content(data, data + size);
+    content.insert(content.end(), index.begin(), index.end());
+    content = touca::detail::compress(content.data(), content.size());
+    touca::detail::save_binary_file(path.string(), content);
+    return;
+  }
+  touca::detail::save_binary_file(
+      path.string(), {{data, size}, {index.data(), index.size()}});
 }
 
 void ClientImpl::notify_loggers(const logger::Level severity,
@@ -2,10 +2,18 @@
 
 #include "touca/core/comparison.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "flatbuffers/flatbuffers.h"
 #include "rapidjson/document.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
+#include "touca/core/deserialize.hpp"
 #include "touca/core/filesystem.hpp"
+#include "touca/core/reader.hpp"
+#include "touca/impl/schema.hpp"
 
 namespace touca {
 
@@ -141,14 +149,369 @@ std::map<std::string, data_point> flatten(const data_point& input) {
   return entries;
 }
 
-std::vector<data_point> flatten_array(
-    const std::map<std::string, data_point>& elements) {
-  std::vector<data_point> data_points;
-  data_points.reserve(elements.size());
+namespace {
+
+/**
+ * The comparison logic below is shared between `data_point` values and
+ * values in their serialized form, so that comparing two result files
+ * directly produces the same output as comparing their decoded content.
+ * Each of the functions in this section has one overload for each of
+ * these two representations.
+ */
+
+/**
+ * Type of the elements of a non-empty array of scalars that is stored as
+ * a typed vector, as in binary format v3.
+ */
+fbs::Type element_type(const fbs::Array* arr) {
+  if (arr->bools()) {
+    return fbs::Type::Bool;
+  }
+  if (arr->ints()) {
+    return fbs::Type::Int;
+  }
+  if (arr->uints()) {
+    return fbs::Type::UInt;
+  }
+  if (arr->floats()) {
+    return fbs::Type::Float;
+  }
+  if (arr->doubles()) {
+    return fbs::Type::Double;
+  }
+  return fbs::Type::NONE;
+}
+
+/**
+ * Serialized value, along with the shared strings of the file that
+ * stores it. Elements of arrays that are stored as typed vectors have no
+ * `TypeWrapper` of their own and are identified by their position in
+ * their array instead.
+ */
+struct fbs_value_t {
+  fbs_value_t(const fbs::TypeWrapper* value,
+              const touca::detail::StringTable* table)
+      : ptr(value), strings(table) {}
+
+  fbs_value_t(const fbs::Array* arr, const flatbuffers::uoffset_t position,
+              const touca::detail::StringTable* table)
+      : array(arr), index(position), strings(table) {}
+
+  fbs::Type type() const {
+    return ptr ? ptr->value_type() : element_type(array);
+  }
+
+  const fbs::TypeWrapper* operator->() const { return ptr; }
+
+  const fbs::TypeWrapper* ptr = nullptr;
+  const fbs::Array* array = nullptr;
+  flatbuffers::uoffset_t index = 0;
+  const touca::detail::StringTable* strings;
+};
+
+using fbs_members_t = std::vector<const fbs::ObjectMember*>;
+
+touca::detail::internal_type type_of(const data_point& value) {
+  return value.type();
+}
+
+touca::detail::internal_type type_of(const fbs_value_t& value) {
+  switch (value.type()) {
+    case fbs::Type::Bool:
+      return touca::detail::internal_type::boolean;
+    case fbs::Type::Int:
+      return touca::detail::internal_type::number_signed;
+    case fbs::Type::UInt:
+      return touca::detail::internal_type::number_unsigned;
+    case fbs::Type::Float:
+      return touca::detail::internal_type::number_float;
+    case fbs::Type::Double:
+      return touca::detail::internal_type::number_double;
+    case fbs::Type::String:
+      return touca::detail::internal_type::string;
+    case fbs::Type::Object:
+      return touca::detail::internal_type::object;
+    case fbs::Type::Array:
+      return touca::detail::internal_type::array;
+    default:
+      throw touca::detail::runtime_error("encountered unexpected type");
+  }
+}
+
+template <typename T>
+const T* cast(const fbs_value_t& value) {
+  return static_cast<const T*>(value->value());
+}
+
+template <typename T>
+T scalar_of(const fbs_value_t& value);
+
+template <>
+detail::boolean_t scalar_of<detail::boolean_t>(const fbs_value_t& value) {
+  return value.array ? value.array->bools()->Get(value.index) != 0
+                     : deserialize_scalar<detail::boolean_t>(value.ptr);
+}
+
+template <>
+detail::number_signed_t scalar_of<detail::number_signed_t>(
+    const fbs_value_t& value) {
+  return value.array ? value.array->ints()->Get(value.index)
+                     : deserialize_scalar<detail::number_signed_t>(value.ptr);
+}
+
+template <>
+detail::number_unsigned_t scalar_of<detail::number_unsigned_t>(
+    const fbs_value_t& value) {
+  return value.array
+             ? value.array->uints()->Get(value.index)
+             : deserialize_scalar<detail::number_unsigned_t>(value.ptr);
+}
+
+template <>
+detail::number_float_t scalar_of<detail::number_float_t>(
+    const fbs_value_t& value) {
+  return value.array ? value.array->floats()->Get(value.index)
+                     : deserialize_scalar<detail::number_float_t>(value.ptr);
+}
+
+template <>
+detail::number_double_t scalar_of<detail::number_double_t>(
+    const fbs_value_t& value) {
+  return value.array ? value.array->doubles()->Get(value.index)
+                     : deserialize_scalar<detail::number_double_t>(value.ptr);
+}
+
+std::vector<fbs_value_t> elements_of(const fbs_value_t& value) {
+  const auto& arr = cast<fbs::Array>(value);
+  std::vector<fbs_value_t> elements;
+  if (arr->values()) {
+    elements.reserve(arr->values()->size());
+    for (const auto&& element : *arr->values()) {
+      elements.emplace_back(element, value.strings);
+    }
+    return elements;
+  }
+  flatbuffers::uoffset_t count = 0;
+  switch (element_type(arr)) {
+    case fbs::Type::Bool:
+      count = arr->bools()->size();
+      break;
+    case fbs::Type::Int:
+      count = arr->ints()->size();
+      break;
+    case fbs::Type::UInt:
+      count = arr->uints()->size();
+      break;
+    case fbs::Type::Float:
+      count = arr->floats()->size();
+      break;
+    case fbs::Type::Double:
+      count = arr->doubles()->size();
+      break;
+    default:
+      break;
+  }
+  elements.reserve(count);
+  for (flatbuffers::uoffset_t i = 0; i < count; ++i) {
+    elements.emplace_back(arr, i, value.strings);
+  }
+  return elements;
+}
+
+/**
+ * Lists members of a serialized object in the order in which they appear
+ * in its decoded representation: sorted by name, keeping only the first
+ * occurrence of each name.
+ */
+fbs_members_t sorted_members(const fbs::Object* obj,
+                             const touca::detail::StringTable& strings) {
+  fbs_members_t members;
+  if (obj->values()) {
+    members.reserve(obj->values()->size());
+    for (const auto&& member : *obj->values()) {
+      members.push_back(member);
+    }
+  }
+  const auto& compare = [&strings](const fbs::ObjectMember* a,
+                                   const fbs::ObjectMember* b) {
+    return std::strcmp(strings.get(a->name(), a->name_ref()),
+                       strings.get(b->name(), b->name_ref()));
+  };
+  std::stable_sort(
+      members.begin(), members.end(),
+      [&compare](const fbs::ObjectMember* a, const fbs::ObjectMember* b) {
+        return compare(a, b) < 0;
+      });
+  members.erase(
+      std::unique(members.begin(), members.end(),
+                  [&compare](const fbs::ObjectMember* a,
+                             const fbs::ObjectMember* b) {
+                    return compare(a, b) == 0;
+                  }),
+      members.end());
+  return members;
+}
+
+const char* string_of(const fbs_value_t& value) {
+  const auto& str = cast<fbs::String>(value);
+  return value.strings->get(str->value(), str->value_ref());
+}
+
+void write_json(rapidjson::Writer<rapidjson::StringBuffer>& writer,
+                const fbs_value_t& value) {
+  switch (value.type()) {
+    case fbs::Type::Bool:
+      writer.Bool(scalar_of<detail::boolean_t>(value));
+      break;
+    case fbs::Type::Int:
+      writer.Int64(scalar_of<detail::number_signed_t>(value));
+      break;
+    case fbs::Type::UInt:
+      writer.Uint64(scalar_of<detail::number_unsigned_t>(value));
+      break;
+    case fbs::Type::Float:
+      writer.Double(
+          static_cast<double>(scalar_of<detail::number_float_t>(value)));
+      break;
+    case fbs::Type::Double:
+      writer.Double(scalar_of<detail::number_double_t>(value));
+      break;
+    case fbs::Type::String:
+      writer.String(string_of(value));
+      break;
+    case fbs::Type::Array:
+      writer.StartArray();
+      for (const auto& element : elements_of(value)) {
+        write_json(writer, element);
+      }
+      writer.EndArray();
+      break;
+    case fbs::Type::Object: {
+      const auto& obj = cast<fbs::Object>(value);
+      const auto& strings = *value.strings;
+      writer.StartObject();
+      writer.Key(strings.get(obj->key(), obj->key_ref()));
+      writer.StartObject();
+      for (const auto& member : sorted_members(obj, strings)) {
+        writer.Key(strings.get(member->name(), member->name_ref()));
+        write_json(writer, {member->value(), value.strings});
+      }
+      writer.EndObject();
+      writer.EndObject();
+      break;
+    }
+    default:
+      throw touca::detail::runtime_error("encountered unexpected type");
+  }
+}
+
+std::string to_string(const data_point& value) { return value.to_string(); }
+
+std::string to_string(const fbs_value_t& value) {
+  if (value.type() == fbs::Type::String) {
+    return string_of(value);
+  }
+  rapidjson::StringBuffer strbuf;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
+  writer.SetMaxDecimalPlaces(3);
+  write_json(writer, value);
+  return strbuf.GetString();
+}
+
+std::map<std::string, fbs_value_t> flatten(const fbs_value_t& input) {
+  std::map<std::string, fbs_value_t> entries;
+  const auto& type = input.type();
+  if (type == fbs::Type::Array) {
+    const auto& values = elements_of(input);
+    for (unsigned i = 0; i < values.size(); ++i) {
+      const auto& value = values.at(i);
+      const auto& name = '[' + std::to_string(i) + ']';
+      const auto& nestedMembers = flatten(value);
+      if (nestedMembers.empty()) {
+        entries.emplace(name, value);
+        continue;
+      }
+      for (const auto& nestedMember : nestedMembers) {
+        const auto& key = name + nestedMember.first;
+        entries.emplace(key, nestedMember.second);
+      }
+    }
+  } else if (type == fbs::Type::Object) {
+    const auto& strings = *input.strings;
+    for (const auto& member :
+         sorted_members(cast<fbs::Object>(input), strings)) {
+      const std::string name = strings.get(member->name(), member->name_ref());
+      const fbs_value_t value = {member->value(), input.strings};
+      const auto& nestedMembers = flatten(value);
+      if (nestedMembers.empty()) {
+        entries.emplace(name, value);
+        continue;
+      }
+      for (const auto& nestedMember : nestedMembers) {
+        const auto& key = name + '.' + nestedMember.first;
+        entries.emplace(key, nestedMember.second);
+      }
+    }
+  }
+  return entries;
+}
+
+bool equal_booleans(const data_point& src, const data_point& dst) {
+  return src.as_boolean() == dst.as_boolean();
+}
+
+bool equal_booleans(const fbs_value_t& src, const fbs_value_t& dst) {
+  return scalar_of<detail::boolean_t>(src) == scalar_of<detail::boolean_t>(dst);
+}
+
+bool equal_strings(const data_point& src, const data_point& dst) {
+  return 0 == src.as_string()->compare(*dst.as_string());
+}
+
+bool equal_strings(const fbs_value_t& src, const fbs_value_t& dst) {
+  return 0 == std::strcmp(string_of(src), string_of(dst));
+}
+
+template <typename Number>
+Number get_number(const data_point& value);
+
+template <>
+detail::number_signed_t get_number<detail::number_signed_t>(
+    const data_point& value) {
+  return value.as_number_signed();
+}
+
+template <>
+detail::number_unsigned_t get_number<detail::number_unsigned_t>(
+    const data_point& value) {
+  return value.as_number_unsigned();
+}
+
+template <>
+detail::number_float_t get_number<detail::number_float_t>(
+    const data_point& value) {
+  return value.as_number_float();
+}
+
+template <>
+detail::number_double_t get_number<detail::number_double_t>(
+    const data_point& value) {
+  return value.as_number_double();
+}
+
+template <typename Number>
+Number get_number(const fbs_value_t& value) {
+  return scalar_of<Number>(value);
+}
+
+template <typename Value>
+std::vector<Value> flatten_array(const std::map<std::string, Value>& elements) {
+  std::vector<Value> values;
+  values.reserve(elements.size());
   for (const auto& element : elements) {
-    data_points.emplace_back(element.second);
+    values.emplace_back(element.second);
   }
-  return data_points;
+  return values;
 }
 
 template <typename T>
@@ -174,8 +537,20 @@ void compare_number(const T& src_number, const T& dst_number,
   cmp.desc.insert("value is " + direction + " by " + difference);
 }
 
-void compare_arrays(const data_point& src, const data_point& dst,
-                    TypeComparison& cmp) {
+template <typename Number, typename Value>
+void compare_numbers(const Value& src, const Value& dst, TypeComparison& cmp) {
+  compare_number<Number>(get_number<Number>(src), get_number<Number>(dst),
+                         cmp);
+  if (cmp.match != MatchType::Perfect) {
+    cmp.dstValue = to_string(dst);
+  }
+}
+
+template <typename Value>
+TypeComparison compare_values(const Value& src, const Value& dst);
+
+template <typename Value>
+void compare_arrays(const Value& src, const Value& dst, TypeComparison& cmp) {
   const auto& src_members = flatten_array(flatten(src));
   const auto& dst_members = flatten_array(flatten(dst));
   const std::pair<size_t, size_t> minmax =
@@ -210,7 +585,7 @@ void compare_arrays(const data_point& src, const data_point& dst,
   if (sizeThreshold < sizeRatio || src_members.empty()) {
     // keep match as None and score as 0.0
     // and return the comparison result
-    cmp.dstValue = dst.to_string();
+    cmp.dstValue = to_string(dst);
     return;
   }
 
@@ -219,7 +594,7 @@ void compare_arrays(const data_point& src, const data_point& dst,
   std::unordered_map<unsigned, std::set<std::string>> differences;
 
   for (auto i = 0U; i < minmax.first; i++) {
-    const auto tmp = compare(src_members.at(i), dst_members.at(i));
+    const auto tmp = compare_values(src_members.at(i), dst_members.at(i));
     scoreEarned += tmp.score;
     if (MatchType::None == tmp.match) {
       differences.emplace(i, tmp.desc);
@@ -248,11 +623,11 @@ void compare_arrays(const data_point& src, const data_point& dst,
     return;
   }
 
-  cmp.dstValue = dst.to_string();
+  cmp.dstValue = to_string(dst);
 }
 
-void compare_objects(const data_point& src, const data_point& dst,
-                     TypeComparison& cmp) {
+template <typename Value>
+void compare_objects(const Value& src, const Value& dst, TypeComparison& cmp) {
   const auto& src_members = flatten(src);
   const auto& dst_members = flatten(dst);
 
@@ -263,7 +638,7 @@ void compare_objects(const data_point& src, const data_point& dst,
     // compare common members
     if (dst_members.count(src_member.first)) {
       const auto& dstKey = dst_members.at(src_member.first);
-      const auto& tmp = compare(src_member.second, dstKey);
+      const auto& tmp = compare_values(src_member.second, dstKey);
       scoreEarned += tmp.score;
       if (MatchType::Perfect == tmp.match) {
         continue;
@@ -298,70 +673,55 @@ void compare_objects(const data_point& src, const data_point& dst,
   cmp.score = scoreEarned / scoreTotal;
 }
 
-TypeComparison compare(const data_point& src, const data_point& dst) {
+template <typename Value>
+TypeComparison compare_values(const Value& src, const Value& dst) {
   TypeComparison cmp;
-  cmp.srcType = src._type;
-  cmp.srcValue = src.to_string();
+  cmp.srcType = type_of(src);
+  cmp.srcValue = to_string(src);
 
   // the two result keys are considered completely different
   // if they are different in types.
 
-  if (src._type != dst._type) {
-    cmp.dstType = dst._type;
-    cmp.dstValue = dst.to_string();
+  if (cmp.srcType != type_of(dst)) {
+    cmp.dstType = type_of(dst);
+    cmp.dstValue = to_string(dst);
     cmp.desc.insert("result types are different");
     return cmp;
   }
 
-  switch (src._type) {
+  switch (cmp.srcType) {
     case touca::detail::internal_type::boolean:
       // two Bool objects are equal if they have identical values.
-      if (src.as_boolean() == dst.as_boolean()) {
+      if (equal_booleans(src, dst)) {
         cmp.match = MatchType::Perfect;
         cmp.score = 1.0;
         return cmp;
       }
-      cmp.dstValue = dst.to_string();
+      cmp.dstValue = to_string(dst);
       break;
 
     case touca::detail::internal_type::number_double:
-      compare_number<detail::number_double_t>(src.as_number_double(),
-                                              dst.as_number_double(), cmp);
-      if (cmp.match != MatchType::Perfect) {
-        cmp.dstValue = dst.to_string();
-      }
+      compare_numbers<detail::number_double_t>(src, dst, cmp);
       break;
 
     case touca::detail::internal_type::number_float:
-      compare_number<detail::number_float_t>(src.as_number_float(),
-                                             dst.as_number_float(), cmp);
-      if (cmp.match != MatchType::Perfect) {
-        cmp.dstValue = dst.to_string();
-      }
+      compare_numbers<detail::number_float_t>(src, dst, cmp);
       break;
 
     case touca::detail::internal_type::number_signed:
-      compare_number<detail::number_signed_t>(src.as_number_signed(),
-                                              dst.as_number_signed(), cmp);
-      if (cmp.match != MatchType::Perfect) {
-        cmp.dstValue = dst.to_string();
-      }
+      compare_numbers<detail::number_signed_t>(src, dst, cmp);
       break;
 
     case touca::detail::internal_type::number_unsigned:
-      compare_number<detail::number_unsigned_t>(src.as_number_unsigned(),
-                                                dst.as_number_unsigned(), cmp);
-      if (cmp.match != MatchType::Perfect) {
-        cmp.dstValue = dst.to_string();
-      }
+      compare_numbers<detail::number_unsigned_t>(src, dst, cmp);
       break;
 
     case touca::detail::internal_type::string:
-      if (0 == src.as_string()->compare(*dst.as_string())) {
+      if (equal_strings(src, dst)) {
         cmp.match = MatchType::Perfect;
         cmp.score = 1.0;
       } else {
-        cmp.dstValue = dst.to_string();
+        cmp.dstValue = to_string(dst);
       }
       break;
 
@@ -372,7 +732,7 @@ TypeComparison compare(const data_point& src, const data_point& dst) {
     case touca::detail::internal_type::object:
       compare_objects(src, dst, cmp);
       if (cmp.match != MatchType::Perfect) {
-        cmp.dstValue = dst.to_string();
+        cmp.dstValue = to_string(dst);
       }
       break;
 
@@ -383,16 +743,194 @@ TypeComparison compare(const data_point& src, const data_point& dst) {
   return cmp;
 }
 
-TestcaseComparison::TestcaseComparison(const Testcase& src, const Testcase& dst)
-    : _src(src), _dst(dst) {
-  _srcMeta = _src.metadata();
-  _dstMeta = _dst.metadata();
+/**
+ * Entry of a serialized results or metrics map, with its key resolved.
+ */
+template <typename Entry>
+struct KeyedEntry {
+  const char* key;
+  const Entry* entry;
+  fbs_value_t value;
+};
+
+/**
+ * Lists entries of a serialized results or metrics map in the order in
+ * which they appear in its decoded representation: sorted by key, keeping
+ * only the first occurrence of each key.
+ */
+template <typename Entry>
+std::vector<KeyedEntry<Entry>> sorted_entries(
+    const flatbuffers::Vector<flatbuffers::Offset<Entry>>* entries,
+    const touca::detail::StringTable& strings) {
+  std::vector<KeyedEntry<Entry>> out;
+  out.reserve(entries->size());
+  for (const auto&& entry : *entries) {
+    out.push_back({strings.get(entry->key(), entry->key_ref()), entry,
+                   {entry->value(), &strings}});
+  }
+  const auto& less = [](const KeyedEntry<Entry>& a,
+                        const KeyedEntry<Entry>& b) {
+    return std::strcmp(a.key, b.key) < 0;
+  };
+  std::stable_sort(out.begin(), out.end(), less);
+  out.erase(std::unique(out.begin(), out.end(),
+                        [&less](const KeyedEntry<Entry>& a,
+                                const KeyedEntry<Entry>& b) {
+                          return !less(a, b) && !less(b, a);
+                        }),
+            out.end());
+  return out;
+}
+
+template <typename Entry>
+const KeyedEntry<Entry>* find_entry(
+    const std::vector<KeyedEntry<Entry>>& entries, const char* key) {
+  const auto& it = std::lower_bound(
+      entries.begin(), entries.end(), key,
+      [](const KeyedEntry<Entry>& a, const char* b) {
+        return std::strcmp(a.key, b) < 0;
+      });
+  return it != entries.end() && 0 == std::strcmp(it->key, key) ? &*it
+                                                                : nullptr;
+}
+
+data_point decode(const fbs_value_t& value) {
+  return deserialize_value(value.ptr, *value.strings);
+}
+
+ResultCategory category_of(const fbs::Result* result) {
+  return result->typ() == fbs::ResultType::Assert ? ResultCategory::Assert
+                                                  : ResultCategory::Check;
+}
+
+void init_cellar(const std::vector<KeyedEntry<fbs::Result>>& src,
+                 const std::vector<KeyedEntry<fbs::Result>>& dst,
+                 const ResultCategory& type, Cellar& result) {
+  for (const auto& entry : dst) {
+    if (category_of(entry.entry) != type) {
+      continue;
+    }
+    const auto& match = find_entry(src, entry.key);
+    if (match) {
+      result.common.emplace(entry.key, compare_values<fbs_value_t>(
+                                           match->value, entry.value));
+      continue;
+    }
+    result.missing.emplace(entry.key, decode(entry.value));
+  }
+  for (const auto& entry : src) {
+    if (category_of(entry.entry) != type) {
+      continue;
+    }
+    if (!find_entry(dst, entry.key)) {
+      result.fresh.emplace(entry.key, decode(entry.value));
+    }
+  }
+}
+
+void init_cellar(const std::vector<KeyedEntry<fbs::Metric>>& src,
+                 const std::vector<KeyedEntry<fbs::Metric>>& dst,
+                 Cellar& result) {
+  for (const auto& entry : dst) {
+    if (const auto& match = find_entry(src, entry.key)) {
+      result.common.emplace(entry.key, compare_values<fbs_value_t>(
+                                           match->value, entry.value));
+      continue;
+    }
+    result.missing.emplace(entry.key, decode(entry.value));
+  }
+  for (const auto& entry : src) {
+    if (!find_entry(dst, entry.key)) {
+      result.fresh.emplace(entry.key, decode(entry.value));
+    }
+  }
+}
+
+std::vector<KeyedEntry<fbs::Metric>> sorted_metrics(
+    const fbs::Message& message, const touca::detail::StringTable& strings) {
+  const auto& metrics = sorted_entries(message.metrics()->entries(), strings);
+  for (const auto& metric : metrics) {
+    if (metric.value->value_type() != fbs::Type::Int) {
+      throw touca::detail::runtime_error("failed to parse metrics map entry");
+    }
+  }
+  return metrics;
+}
+
+std::int32_t total_duration(
+    const std::vector<KeyedEntry<fbs::Metric>>& metrics, const Cellar& cellar) {
+  std::int32_t duration = 0;
+  for (const auto& kvp : cellar.common) {
+    const auto& metric = find_entry(metrics, kvp.first.c_str());
+    duration += static_cast<std::int32_t>(
+        scalar_of<detail::number_signed_t>(metric->value));
+  }
+  return duration;
+}
+
+using MessageIndex = std::unordered_map<std::string, TestcaseView>;
+
+/**
+ * Indexes testcases of a given result file by name, in the same order in
+ * which `deserialize_file` would load them.
+ */
+MessageIndex index_messages(const ResultFile& file) {
+  MessageIndex index;
+  for (std::size_t i = 0; i < file.size(); ++i) {
+    const auto& view = file.at(i);
+    index.emplace(view.name(), view);
+  }
+  return index;
+}
+
+}  // namespace
+
+TypeComparison compare(const data_point& src, const data_point& dst) {
+  return compare_values(src, dst);
+}
+
+TestcaseComparison::TestcaseComparison(const Testcase& src,
+                                       const Testcase& dst) {
+  _srcMeta = src.metadata();
+  _dstMeta = dst.metadata();
   // perform comparisons on assumptions
-  init_cellar(_src._resultsMap, _dst._resultsMap, ResultCategory::Assert,
+  init_cellar(src._resultsMap, dst._resultsMap, ResultCategory::Assert,
               _assumptions);
-  init_cellar(_src._resultsMap, _dst._resultsMap, ResultCategory::Check,
+  init_cellar(src._resultsMap, dst._resultsMap, ResultCategory::Check,
               _results);
-  init_cellar(_src.metrics(), _dst.metrics(), _metrics);
+  init_cellar(src.metrics(), dst.metrics(), _metrics);
+
+  const auto getTotalCommonDuration = [this](const Testcase& tc) {
+    namespace chr = std::chrono;
+    std::int32_t duration = 0U;
+    for (const auto& kvp : _metrics.common) {
+      const auto& diff = tc._tocs.at(kvp.first) - tc._tics.at(kvp.first);
+      duration += static_cast<std::int32_t>(
+          chr::duration_cast<chr::milliseconds>(diff).count());
+    }
+    return duration;
+  };
+
+  _metricsDurationCommonSrc = getTotalCommonDuration(src);
+  _metricsDurationCommonDst = getTotalCommonDuration(dst);
+}
+
+TestcaseComparison::TestcaseComparison(
+    const fbs::Message& src, const fbs::Message& dst,
+    const touca::detail::StringTable& srcStrings,
+    const touca::detail::StringTable& dstStrings) {
+  _srcMeta = deserialize_metadata(&src);
+  _dstMeta = deserialize_metadata(&dst);
+  const auto& srcResults = sorted_entries(src.results()->entries(), srcStrings);
+  const auto& dstResults = sorted_entries(dst.results()->entries(), dstStrings);
+  touca::init_cellar(srcResults, dstResults, ResultCategory::Assert,
+                     _assumptions);
+  touca::init_cellar(srcResults, dstResults, ResultCategory::Check, _results);
+  const auto& srcMetrics = sorted_metrics(src, srcStrings);
+  const auto& dstMetrics = sorted_metrics(dst, dstStrings);
+  touca::init_cellar(srcMetrics, dstMetrics, _metrics);
+  _metricsDurationCommonSrc = total_duration(srcMetrics, _metrics);
+  _metricsDurationCommonDst = total_duration(dstMetrics, _metrics);
 }
 
 TestcaseComparison compare(const Testcase& src, const Testcase& dst) {
@@ -462,19 +1000,8 @@ TestcaseComparison::Overview TestcaseComparison::overview() const {
   output.metricsCountFresh = count(_metrics.fresh.size());
   output.metricsCountMissing = count(_metrics.missing.size());
 
-  const auto getTotalCommonDuration = [this](const Testcase& tc) {
-    namespace chr = std::chrono;
-    std::int32_t duration = 0U;
-    for (const auto& kvp : _metrics.common) {
-      const auto& diff = tc._tocs.at(kvp.first) - tc._tics.at(kvp.first);
-      duration += static_cast<std::int32_t>(
-          chr::duration_cast<chr::milliseconds>(diff).count());
-    }
-    return duration;
-  };
-
-  output.metricsDurationCommonSrc = getTotalCommonDuration(_src);
-  output.metricsDurationCommonDst = getTotalCommonDuration(_dst);
+  output.metricsDurationCommonSrc = _metricsDurationCommonSrc;
+  output.metricsDurationCommonDst = _metricsDurationCommonDst;
 
   return output;
 }
@@ -542,6 +1069,38 @@ ElementsMapComparison compare(const ElementsMap& src, const ElementsMap& dst) {
   return cmp;
 }
 
+ElementsMapComparison compare_files(const touca::filesystem::path& src,
+                                    const touca::filesystem::path& dst) {
+  const ResultFile srcFile(src);
+  const ResultFile dstFile(dst);
+  const auto& srcIndex = index_messages(srcFile);
+  const auto& dstIndex = index_messages(dstFile);
+
+  // decode only the testcases that are missing from either file, since
+  // we report them using their `Testcase` representation.
+
+  ElementsMapComparison cmp;
+  for (const auto& tc : srcIndex) {
+    const auto& key = tc.first;
+    const auto& match = dstIndex.find(key);
+    if (match != dstIndex.end()) {
+      const auto& dst = match->second;
+      cmp.common.emplace(
+          key, TestcaseComparison(*tc.second.message(), *dst.message(),
+                                  tc.second.strings(), dst.strings()));
+      continue;
+    }
+    cmp.fresh.emplace(key, std::make_shared<Testcase>(tc.second.decode()));
+  }
+  for (const auto& tc : dstIndex) {
+    const auto& key = tc.first;
+    if (!srcIndex.count(key)) {
+      cmp.missing.emplace(key, std::make_shared<Testcase>(tc.second.decode()));
+    }
+  }
+  return cmp;
+}
+
 std::string ElementsMapComparison::json() const {
   rapidjson::Document doc(rapidjson::kObjectType);
   auto& allocator = doc.GetAllocator();
@@ -0,0 +1,225 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/compression.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <streambuf>
+
+#include "touca/core/filesystem.hpp"
+
+#ifdef TOUCA_HAS_ZLIB
+#include "zlib.h"
+#endif
+
+namespace touca {
+namespace detail {
+
+namespace {
+
+constexpr char compressed_magic[] = "TCZ1";
+
+#ifdef TOUCA_HAS_ZLIB
+
+/** largest chunk of input that zlib can consume in one call */
+constexpr std::size_t max_chunk_size = std::numeric_limits<unsigned>::max();
+
+void write_size(std::uint8_t* output, std::uint64_t size) {
+  for (auto i = 0; i < 8; ++i) {
+    output[i] = static_cast<std::uint8_t>(size >> (8 * i));
+  }
+}
+
+std::uint64_t read_size(const std::uint8_t* input) {
+  std::uint64_t size = 0;
+  for (auto i = 0; i < 8; ++i) {
+    size |= static_cast<std::uint64_t>(input[i]) << (8 * i);
+  }
+  return size;
+}
+
+void deflate_into(std::vector<std::uint8_t>& output, const std::uint8_t* data,
+                  const std::size_t size) {
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (deflateInit(&stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+    throw touca::detail::runtime_error("failed to compress content");
+  }
+  std::uint8_t chunk[16384];
+  std::size_t offset = 0;
+  auto flush = Z_NO_FLUSH;
+  do {
+    const auto count = std::min(size - offset, max_chunk_size);
+    stream.next_in = const_cast<Bytef*>(data + offset);
+    stream.avail_in = static_cast<uInt>(count);
+    offset += count;
+    flush = offset == size ? Z_FINISH : Z_NO_FLUSH;
+    do {
+      stream.next_out = chunk;
+      stream.avail_out = sizeof(chunk);
+      ::deflate(&stream, flush);
+      output.insert(output.end(), chunk,
+                    chunk + sizeof(chunk) - stream.avail_out);
+    } while (stream.avail_out == 0);
+  } while (flush != Z_FINISH);
+  deflateEnd(&stream);
+}
+
+class InflatingStreambuf : public std::streambuf {
+ public:
+  explicit InflatingStreambuf(std::istream& input) : _input(input) {
+    std::memset(&_stream, 0, sizeof(_stream));
+    if (inflateInit(&_stream) != Z_OK) {
+      throw touca::detail::runtime_error("failed to decompress content");
+    }
+  }
+
+  ~InflatingStreambuf() { inflateEnd(&_stream); }
+
+ protected:
+  int_type underflow() override {
+    if (gptr() < egptr()) {
+      return traits_type::to_int_type(*gptr());
+    }
+    while (!_done) {
+      if (_stream.avail_in == 0) {
+        _input.read(_in, sizeof(_in));
+        if (_input.gcount() == 0) {
+          throw touca::detail::runtime_error("compressed content truncated");
+        }
+        _stream.next_in = reinterpret_cast<Bytef*>(_in);
+        _stream.avail_in = static_cast<uInt>(_input.gcount());
+      }
+      _stream.next_out = reinterpret_cast<Bytef*>(_out);
+      _stream.avail_out = sizeof(_out);
+      const auto ret = ::inflate(&_stream, Z_NO_FLUSH);
+      if (ret == Z_STREAM_END) {
+        _done = true;
+      } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+        throw touca::detail::runtime_error("failed to decompress content");
+      }
+      const auto produced = sizeof(_out) - _stream.avail_out;
+      if (produced != 0) {
+        setg(_out, _out, _out + produced);
+        return traits_type::to_int_type(*gptr());
+      }
+    }
+    return traits_type::eof();
+  }
+
+ private:
+  std::istream& _input;
+  z_stream _stream;
+  bool _done = false;
+  char _in[16384];
+  char _out[16384];
+};
+
+#endif
+
+}  // namespace
+
+bool has_compression() {
+#ifdef TOUCA_HAS_ZLIB
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool is_compressed(const std::uint8_t* data, const std::size_t size) {
+  return 4 <= size && std::memcmp(data, compressed_magic, 4) == 0;
+}
+
+#ifdef TOUCA_HAS_ZLIB
+
+std::vector<std::uint8_t> compress(const std::uint8_t* data,
+                                   const std::size_t size) {
+  std::vector<std::uint8_t> output(compressed_header_size);
+  std::memcpy(output.data(), compressed_magic, 4);
+  write_size(output.data() + 4, size);
+  deflate_into(output, data, size);
+  return output;
+}
+
+std::vector<std::uint8_t> decompress(const std::uint8_t* data,
+                                     const std::size_t size) {
+  if (!is_compressed(data, size) || size < compressed_header_size) {
+    throw touca::detail::runtime_error("content is not compressed");
+  }
+  const auto expected = read_size(data + 4);
+  if (std::numeric_limits<std::size_t>::max() <= expected) {
+    throw touca::detail::runtime_error("compressed content is too large");
+  }
+  // reserve one extra byte so that zlib always has room to make progress
+  // until it reaches the end of the stream.
+  std::vector<std::uint8_t> output(static_cast<std::size_t>(expected) + 1);
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (inflateInit(&stream) != Z_OK) {
+    throw touca::detail::runtime_error("failed to decompress content");
+  }
+  std::size_t offset = compressed_header_size;
+  std::size_t produced = 0;
+  auto ret = Z_OK;
+  while (ret == Z_OK) {
+    if (stream.avail_in == 0) {
+      const auto count = std::min(size - offset, max_chunk_size);
+      stream.next_in = const_cast<Bytef*>(data + offset);
+      stream.avail_in = static_cast<uInt>(count);
+      offset += count;
+    }
+    const auto space = std::min(output.size() - produced, max_chunk_size);
+    stream.next_out = output.data() + produced;
+    stream.avail_out = static_cast<uInt>(space);
+    ret = ::inflate(&stream, Z_NO_FLUSH);
+    produced += space - stream.avail_out;
+  }
+  inflateEnd(&stream);
+  if (ret != Z_STREAM_END || produced != expected) {
+    throw touca::detail::runtime_error("failed to decompress content");
+  }
+  output.pop_back();
+  return output;
+}
+
+std::vector<std::uint8_t> zlib_compress(const std::uint8_t* data,
+                                        const std::size_t size) {
+  std::vector<std::uint8_t> output;
+  deflate_into(output, data, size);
+  return output;
+}
+
+std::unique_ptr<std::streambuf> make_inflating_streambuf(std::istream& input) {
+  return touca::detail::make_unique<InflatingStreambuf>(input);
+}
+
+#else
+
+std::vector<std::uint8_t> compress(const std::uint8_t*, const std::size_t) {
+  throw touca::detail::runtime_error(
+      "this build of touca does not support compression");
+}
+
+std::vector<std::uint8_t> decompress(const std::uint8_t*, const std::size_t) {
+  throw touca::detail::runtime_error(
+      "this build of touca does not support compression");
+}
+
+std::vector<std::uint8_t> zlib_compress(const std::uint8_t*,
+                                        const std::size_t) {
+  throw touca::detail::runtime_error(
+      "this build of touca does not support compression");
+}
+
+std::unique_ptr<std::streambuf> make_inflating_streambuf(std::istream&) {
+  throw touca::detail::runtime_error(
+      "this build of touca does not support compression");
+}
+
+#endif
+
+}  // namespace detail
+}  // namespace touca
@@ -2,57 +2,207 @@
 
 #include "touca/core/deserialize.hpp"
 
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <initializer_list>
+#include <istream>
+#include <queue>
 #include <stdexcept>
+#include <string>
+#include <utility>
 
 #include "flatbuffers/flatbuffers.h"
+#include "touca/core/compression.hpp"
 #include "touca/core/filesystem.hpp"
+#include "touca/core/parallel.hpp"
+#include "touca/core/reader.hpp"
 #include "touca/core/testcase.hpp"
 #include "touca/core/types.hpp"
 #include "touca/impl/schema.hpp"
 
 namespace touca {
 
-data_point deserialize_value(const fbs::TypeWrapper* ptr) {
-  const auto& value = ptr->value();
-  const auto& type = ptr->value_type();
-  switch (type) {
-    case fbs::Type::Bool: {
-      const auto& castptr = static_cast<const fbs::Bool*>(ptr->value());
-      return data_point::boolean(castptr->value());
-    }
-    case fbs::Type::Double: {
-      const auto& castptr = static_cast<const fbs::Double*>(ptr->value());
-      return data_point::number_double(castptr->value());
+namespace {
+
+/**
+ * Number of bytes by which a block of content grows as it is read. Since
+ * the input may be a pipe, we do not know how many bytes are left to read
+ * and should not trust lengths stored in the input to allocate memory.
+ */
+constexpr std::uint64_t block_chunk_size = 64 * 1024;
+
+/**
+ * Consumes a stream of serialized test results forward-only, keeping
+ * track of the position of the next byte to be read.
+ */
+class ForwardReader {
+ public:
+  explicit ForwardReader(std::istream& input) : _input(input) {}
+
+  std::uint64_t position() const { return _position; }
+
+  void skip_to(const std::uint64_t position) {
+    if (position < _position) {
+      throw touca::detail::runtime_error(
+          "result file cannot be read forward-only");
     }
-    case fbs::Type::Float: {
-      const auto& castptr = static_cast<const fbs::Float*>(ptr->value());
-      return data_point::number_float(castptr->value());
+    const auto& count = position - _position;
+    _input.ignore(static_cast<std::streamsize>(count));
+    consume(count);
+  }
+
+  void read(std::uint8_t* output, const std::size_t count) {
+    _input.read(reinterpret_cast<char*>(output),
+                static_cast<std::streamsize>(count));
+    consume(count);
+  }
+
+  std::uint32_t read_offset() {
+    std::uint8_t bytes[sizeof(flatbuffers::uoffset_t)];
+    read(bytes, sizeof(bytes));
+    return flatbuffers::ReadScalar<flatbuffers::uoffset_t>(bytes);
+  }
+
+  /**
+   * Reads a block of a given number of bytes into a given container,
+   * growing the container as content is read, so that an invalid length
+   * fails once the input ends instead of allocating memory for it.
+   */
+  template <typename Container>
+  void read_block(Container& output, const std::uint64_t count) {
+    if (FLATBUFFERS_MAX_BUFFER_SIZE < count) {
+      throw touca::detail::runtime_error("result file invalid");
     }
-    case fbs::Type::Int: {
-      const auto& castptr = static_cast<const fbs::Int*>(ptr->value());
-      return data_point::number_signed(castptr->value());
+    output.clear();
+    while (output.size() < count) {
+      const auto offset = output.size();
+      const auto chunk =
+          std::min<std::uint64_t>(count - offset, block_chunk_size);
+      output.resize(offset + chunk);
+      read(reinterpret_cast<std::uint8_t*>(&output[offset]), chunk);
     }
-    case fbs::Type::UInt: {
-      const auto& castptr = static_cast<const fbs::UInt*>(ptr->value());
-      return data_point::number_unsigned(castptr->value());
+  }
+
+ private:
+  void consume(const std::uint64_t count) {
+    if (static_cast<std::uint64_t>(_input.gcount()) != count) {
+      throw touca::detail::runtime_error("unexpected end of result file");
     }
+    _position += count;
+  }
+
+  std::istream& _input;
+  std::uint64_t _position = 0;
+};
+
+/**
+ * Largest position of the root table of a result file that we expect
+ * when reading it forward-only. The root table of result files is stored
+ * right after its vtable at the beginning of the file.
+ */
+constexpr std::uint64_t max_root_offset = 1024;
+
+}  // namespace
+
+template <>
+touca::detail::boolean_t deserialize_scalar<touca::detail::boolean_t>(
+    const fbs::TypeWrapper* ptr) {
+  const auto& value = static_cast<const fbs::Bool*>(ptr->value());
+  return value ? value->value() : ptr->bool_value();
+}
+
+template <>
+touca::detail::number_signed_t
+deserialize_scalar<touca::detail::number_signed_t>(
+    const fbs::TypeWrapper* ptr) {
+  const auto& value = static_cast<const fbs::Int*>(ptr->value());
+  return value ? value->value() : ptr->int_value();
+}
+
+template <>
+touca::detail::number_unsigned_t
+deserialize_scalar<touca::detail::number_unsigned_t>(
+    const fbs::TypeWrapper* ptr) {
+  const auto& value = static_cast<const fbs::UInt*>(ptr->value());
+  return value ? value->value() : ptr->uint_value();
+}
+
+template <>
+touca::detail::number_float_t deserialize_scalar<touca::detail::number_float_t>(
+    const fbs::TypeWrapper* ptr) {
+  const auto& value = static_cast<const fbs::Float*>(ptr->value());
+  return value ? value->value() : ptr->float_value();
+}
+
+template <>
+touca::detail::number_double_t
+deserialize_scalar<touca::detail::number_double_t>(
+    const fbs::TypeWrapper* ptr) {
+  const auto& value = static_cast<const fbs::Double*>(ptr->value());
+  return value ? value->value() : ptr->double_value();
+}
+
+data_point deserialize_value(const fbs::TypeWrapper* ptr,
+                             const touca::detail::StringTable& strings) {
+  const auto& value = ptr->value();
+  const auto& type = ptr->value_type();
+  switch (type) {
+    case fbs::Type::Bool:
+      return data_point::boolean(
+          deserialize_scalar<touca::detail::boolean_t>(ptr));
+    case fbs::Type::Double:
+      return data_point::number_double(
+          deserialize_scalar<touca::detail::number_double_t>(ptr));
+    case fbs::Type::Float:
+      return data_point::number_float(
+          deserialize_scalar<touca::detail::number_float_t>(ptr));
+    case fbs::Type::Int:
+      return data_point::number_signed(
+          deserialize_scalar<touca::detail::number_signed_t>(ptr));
+    case fbs::Type::UInt:
+      return data_point::number_unsigned(
+          deserialize_scalar<touca::detail::number_unsigned_t>(ptr));
     case fbs::Type::String: {
       const auto& str = static_cast<const fbs::String*>(value);
-      return data_point::string(str->value()->data());
+      return data_point::string(strings.get(str->value(), str->value_ref()));
     }
     case fbs::Type::Array: {
       const auto& fbsArr = static_cast<const fbs::Array*>(value);
       array out;
-      for (const auto&& element : *fbsArr->values()) {
-        out.add(deserialize_value(element));
+      if (fbsArr->values()) {
+        for (const auto&& element : *fbsArr->values()) {
+          out.add(deserialize_value(element, strings));
+        }
+      } else if (fbsArr->bools()) {
+        for (const auto element : *fbsArr->bools()) {
+          out.add(data_point::boolean(element != 0));
+        }
+      } else if (fbsArr->ints()) {
+        for (const auto element : *fbsArr->ints()) {
+          out.add(data_point::number_signed(element));
+        }
+      } else if (fbsArr->uints()) {
+        for (const auto element : *fbsArr->uints()) {
+          out.add(data_point::number_unsigned(element));
+        }
+      } else if (fbsArr->floats()) {
+        for (const auto element : *fbsArr->floats()) {
+          out.add(data_point::number_float(element));
+        }
+      } else if (fbsArr->doubles()) {
+        for (const auto element : *fbsArr->doubles()) {
+          out.add(data_point::number_double(element));
+        }
       }
       return out;
     }
     case fbs::Type::Object: {
       const auto& fbsObj = static_cast<const fbs::Object*>(value);
-      touca::object out(fbsObj->key()->data());
+      touca::object out(strings.get(fbsObj->key(), fbsObj->key_ref()));
       for (const auto&& member : *fbsObj->values()) {
-        out.add(member->name()->data(), deserialize_value(member->value()));
+        out.add(strings.get(member->name(), member->name_ref()),
+                deserialize_value(member->value(), strings));
       }
       return out;
     }
@@ -61,21 +211,25 @@ data_point deserialize_value(const fbs::TypeWrapper* ptr) {
   }
 }
 
-Testcase deserialize_testcase(const std::vector<uint8_t>& buffer) {
-  const auto message = flatbuffers::GetRoot<touca::fbs::Message>(buffer.data());
-  Testcase::Metadata metadata = {message->metadata()->teamslug()
-                                     ? message->metadata()->teamslug()->data()
-                                     : "unknown",
-                                 message->metadata()->testsuite()->data(),
-                                 message->metadata()->version()->data(),
-                                 message->metadata()->testcase()->data(),
-                                 message->metadata()->builtAt()->data()};
+Testcase::Metadata deserialize_metadata(const fbs::Message* message) {
+  return {message->metadata()->teamslug()
+              ? message->metadata()->teamslug()->data()
+              : "unknown",
+          message->metadata()->testsuite()->data(),
+          message->metadata()->version()->data(),
+          message->metadata()->testcase()->data(),
+          message->metadata()->builtAt()->data()};
+}
+
+Testcase deserialize_testcase(const fbs::Message* message,
+                              const touca::detail::StringTable& strings) {
+  const auto& metadata = deserialize_metadata(message);
 
   ResultsMap resultsMap;
   const auto& results = message->results()->entries();
   for (const auto&& result : *results) {
-    const auto& key = result->key()->data();
-    const auto& value = deserialize_value(result->value());
+    const auto& key = strings.get(result->key(), result->key_ref());
+    const auto& value = deserialize_value(result->value(), strings);
     if (value.type() == touca::detail::internal_type::unknown) {
       throw touca::detail::runtime_error("failed to parse results map entry");
     }
@@ -88,8 +242,8 @@ Testcase deserialize_testcase(const std::vector<uint8_t>& buffer) {
   std::unordered_map<std::string, touca::detail::number_unsigned_t> metricsMap;
   const auto& metrics = message->metrics()->entries();
   for (const auto&& metric : *metrics) {
-    const auto& key = metric->key()->data();
-    const auto& value = deserialize_value(metric->value());
+    const auto& key = strings.get(metric->key(), metric->key_ref());
+    const auto& value = deserialize_value(metric->value(), strings);
     if (value.type() != touca::detail::internal_type::number_signed) {
       throw touca::detail::runtime_error("failed to parse metrics map entry");
     }
@@ -99,29 +253,192 @@ Testcase deserialize_testcase(const std::vector<uint8_t>& buffer) {
   return Testcase(metadata, resultsMap, metricsMap);
 }
 
-ElementsMap deserialize_file(const touca::filesystem::path& path) {
-  const auto& content = touca::detail::load_text_file(
-      path.string(), std::ios::in | std::ios::binary);
-
-  // verify that given content represents valid flatbuffers data
-  if (!flatbuffers::Verifier((const uint8_t*)content.data(), content.size())
-           .VerifyBuffer<touca::fbs::Messages>()) {
-    throw touca::detail::runtime_error(
-        touca::detail::format("result file invalid: {}", path.string()));
-  }
+Testcase deserialize_testcase(const std::vector<uint8_t>& buffer) {
+  return deserialize_testcase(
+      flatbuffers::GetRoot<touca::fbs::Message>(buffer.data()));
+}
 
+ElementsMap deserialize_file(const touca::filesystem::path& path,
+                             const std::size_t concurrency) {
+  const ResultFile file(path);
+  std::vector<std::shared_ptr<Testcase>> decoded(file.size());
+  touca::detail::parallel_for(
+      decoded.size(), concurrency, [&file, &decoded](const std::size_t i) {
+        decoded[i] = std::make_shared<Testcase>(file.at(i).decode());
+      });
+  // insert testcases in the order they are stored, regardless of the
+  // order in which they were decoded.
   ElementsMap testcases;
-  // parse content of given file
-  const auto& messages = touca::fbs::GetMessages(content.c_str());
-  for (const auto&& message : *messages->messages()) {
-    const auto& buffer = message->buf();
-    const auto& ptr = buffer->data();
-    std::vector<uint8_t> data(ptr, ptr + buffer->size());
-    const auto& testcase =
-        std::make_shared<Testcase>(deserialize_testcase(data));
+  for (const auto& testcase : decoded) {
     testcases.emplace(testcase->metadata().testcase, testcase);
   }
   return testcases;
 }
 
+/**
+ * Test results are serialized as a `Messages` table holding a vector of
+ * `MessageBuffer` tables, each with a single field that points to a
+ * nested `Message` buffer, and an optional vector of shared strings.
+ * Since flatbuffers are built back to front and offsets always point
+ * forward, we can learn the position of each of these objects from the
+ * beginning of the file and visit them in order of their position.
+ * Tables with a single offset field store that field right after their
+ * vtable offset, which lets us find nested buffers without reading
+ * vtables that may be stored further in the file. Each nested buffer is
+ * verified before it is decoded. Shared strings are stored before the
+ * messages that refer to them; messages found before all shared strings
+ * are read are kept in memory until they can be decoded.
+ */
+void for_each_testcase(std::istream& input,
+                       const std::function<void(const Testcase&)>& callback) {
+  using position_t = std::uint64_t;
+  const position_t field_offset = sizeof(flatbuffers::soffset_t);
+  ForwardReader reader(input);
+
+  std::uint8_t head[sizeof(flatbuffers::uoffset_t)];
+  reader.read(head, sizeof(head));
+  if (touca::detail::is_compressed(head, sizeof(head))) {
+    std::uint8_t size[touca::detail::compressed_header_size - sizeof(head)];
+    reader.read(size, sizeof(size));
+    const auto& buffer = touca::detail::make_inflating_streambuf(input);
+    std::istream inflated(buffer.get());
+    inflated.exceptions(std::ios::badbit);
+    return for_each_testcase(inflated, callback);
+  }
+
+  // the vtable of the root table is stored right before it, unless it is
+  // shared with `MessageBuffer` tables, in which case the root table has
+  // the same single-field layout.
+
+  const position_t root = flatbuffers::ReadScalar<flatbuffers::uoffset_t>(head);
+  if (root < sizeof(head) || max_root_offset < root) {
+    throw touca::detail::runtime_error(
+        "result file cannot be read forward-only");
+  }
+  std::vector<std::uint8_t> prefix(root + field_offset - sizeof(head));
+  reader.read(prefix.data(), prefix.size());
+  const auto& vtable_offset = flatbuffers::ReadScalar<flatbuffers::soffset_t>(
+      prefix.data() + prefix.size() - field_offset);
+  const auto vtable = static_cast<std::int64_t>(root) - vtable_offset;
+  flatbuffers::voffset_t fields[2] = {
+      static_cast<flatbuffers::voffset_t>(field_offset), 0};
+  if (static_cast<std::int64_t>(sizeof(head)) <= vtable &&
+      vtable + 4 <= static_cast<std::int64_t>(root)) {
+    const auto& ptr = prefix.data() + vtable - sizeof(head);
+    const auto& vtable_end = std::min<std::int64_t>(
+        vtable + flatbuffers::ReadScalar<flatbuffers::voffset_t>(ptr), root);
+    for (auto i = 0; i < 2; ++i) {
+      const auto& entry = ptr + 4 + 2 * i;
+      fields[i] = vtable + 4 + 2 * i + 2 <= vtable_end
+                      ? flatbuffers::ReadScalar<flatbuffers::voffset_t>(entry)
+                      : 0;
+    }
+  }
+
+  enum class Item : std::uint8_t { Messages, Strings, String, Table, Buffer };
+  struct Pending {
+    position_t position;
+    Item item;
+    std::uint32_t index;
+    bool operator>(const Pending& other) const {
+      return position > other.position;
+    }
+  };
+  std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>>
+      pending;
+  const auto first = fields[1] != 0 && fields[1] < fields[0] ? 1 : 0;
+  for (auto i : {first, 1 - first}) {
+    if (fields[i] == 0) {
+      continue;
+    }
+    reader.skip_to(root + fields[i]);
+    const position_t field = reader.position();
+    pending.push({field + reader.read_offset(),
+                  i == 0 ? Item::Messages : Item::Strings, 0});
+  }
+
+  // number of shared strings that are yet to be read, counting the list
+  // of shared strings as one until we know its size.
+  std::size_t missing = fields[1] != 0 ? 1 : 0;
+  std::vector<std::string> shared;
+  touca::detail::StringTable strings;
+  std::vector<std::vector<std::uint8_t>> deferred;
+  const auto& decode = [&strings, &callback](const std::uint8_t* data) {
+    callback(deserialize_testcase(
+        flatbuffers::GetRoot<touca::fbs::Message>(data), strings));
+  };
+  const auto& load_strings = [&shared, &strings, &deferred, &decode]() {
+    strings = touca::detail::StringTable(std::move(shared));
+    for (const auto& buffer : deferred) {
+      decode(buffer.data());
+    }
+    deferred.clear();
+  };
+
+  while (!pending.empty()) {
+    const auto next = pending.top();
+    pending.pop();
+    reader.skip_to(next.position);
+    switch (next.item) {
+      case Item::Messages:
+      case Item::Strings: {
+        // the offsets of elements are read before we allocate anything
+        // for them, so that an invalid count fails once the input ends.
+        const auto count = reader.read_offset();
+        for (std::uint32_t i = 0; i < count; ++i) {
+          const position_t offset = reader.position();
+          pending.push({offset + reader.read_offset(),
+                        next.item == Item::Strings ? Item::String : Item::Table,
+                        i});
+        }
+        if (next.item == Item::Strings) {
+          shared.resize(count);
+          missing = count;
+          if (missing == 0) {
+            load_strings();
+          }
+        }
+        break;
+      }
+      case Item::String: {
+        reader.read_block(shared[next.index], reader.read_offset());
+        if (--missing == 0) {
+          load_strings();
+        }
+        break;
+      }
+      case Item::Table: {
+        reader.skip_to(next.position + field_offset);
+        const position_t offset = reader.position();
+        pending.push({offset + reader.read_offset(), Item::Buffer, 0});
+        break;
+      }
+      case Item::Buffer: {
+        std::vector<std::uint8_t> buffer;
+        reader.read_block(buffer, reader.read_offset());
+        if (!flatbuffers::Verifier(buffer.data(), buffer.size())
+                 .VerifyBuffer<fbs::Message>()) {
+          throw touca::detail::runtime_error("result file invalid");
+        }
+        if (missing != 0) {
+          deferred.push_back(std::move(buffer));
+        } else {
+          decode(buffer.data());
+        }
+        break;
+      }
+    }
+  }
+}
+
+void for_each_testcase(const touca::filesystem::path& path,
+                       const std::function<void(const Testcase&)>& callback) {
+  std::ifstream input(path.string(), std::ios::in | std::ios::binary);
+  if (!input) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("failed to read file {}", path.string()));
+  }
+  for_each_testcase(input, callback);
+}
+
 }  // namespace touca
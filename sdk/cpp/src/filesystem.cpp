@@ -14,6 +14,13 @@
 #endif
 #endif
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <codecvt>
 #include <fstream>
 #include <iostream>
@@ -61,10 +68,18 @@ void save_text_file(const std::string& path, const std::string& content) {
 
 void save_binary_file(const std::string& path,
                       const std::vector<uint8_t>& data) {
+  save_binary_file(path, {{data.data(), data.size()}});
+}
+
+void save_binary_file(
+    const std::string& path,
+    const std::vector<std::pair<const std::uint8_t*, std::size_t>>& pieces) {
   create_parent_directory(path);
   try {
     std::ofstream out(path, std::ios::binary);
-    out.write((const char*)data.data(), data.size());
+    for (const auto& piece : pieces) {
+      out.write((const char*)piece.first, piece.second);
+    }
     out.close();
   } catch (const std::exception& ex) {
     throw touca::detail::runtime_error(
@@ -72,5 +87,47 @@ void save_binary_file(const std::string& path,
   }
 }
 
+#ifndef _WIN32
+
+MappedFile::MappedFile(const std::string& path) {
+  const auto fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw touca::detail::runtime_error("failed to read file");
+  }
+  struct stat info;
+  if (::fstat(fd, &info) == -1) {
+    ::close(fd);
+    throw touca::detail::runtime_error("failed to read file");
+  }
+  _size = static_cast<std::size_t>(info.st_size);
+  if (_size != 0) {
+    const auto ptr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (ptr == MAP_FAILED) {
+      ::close(fd);
+      throw touca::detail::runtime_error("failed to map file into memory");
+    }
+    _data = static_cast<const std::uint8_t*>(ptr);
+  }
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (_data != nullptr) {
+    ::munmap(const_cast<std::uint8_t*>(_data), _size);
+  }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+    : _fallback(load_text_file(path, std::ios::in | std::ios::binary)) {
+  _data = reinterpret_cast<const std::uint8_t*>(_fallback.data());
+  _size = _fallback.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
+
 }  // namespace detail
 }  // namespace touca
@@ -0,0 +1,484 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/json_reader.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rapidjson/error/en.h"
+#include "rapidjson/reader.h"
+#include "touca/core/types.hpp"
+
+namespace touca {
+namespace {
+
+/** number of bytes read from the input at a time */
+constexpr std::size_t buffer_capacity = 64 * 1024;
+
+/**
+ * Input stream of rapidjson readers that reads content from a standard
+ * stream in chunks of fixed size.
+ */
+class JsonInputStream {
+ public:
+  typedef char Ch;
+
+  explicit JsonInputStream(std::istream& input)
+      : _input(input),
+        _buffer(buffer_capacity),
+        _current(_buffer.data()),
+        _end(_buffer.data()) {
+    fill();
+  }
+
+  Ch Peek() const { return _current < _end ? *_current : '\0'; }
+
+  Ch Take() {
+    if (_current == _end) {
+      return '\0';
+    }
+    const auto c = *_current++;
+    if (_current == _end) {
+      fill();
+    }
+    return c;
+  }
+
+  std::size_t Tell() const {
+    return _consumed + static_cast<std::size_t>(_current - _buffer.data());
+  }
+
+  // rapidjson requires input streams to declare these functions but does
+  // not call them when parsing without the in-situ flag.
+
+  Ch* PutBegin() { return nullptr; }
+  void Put(Ch) {}
+  void Flush() {}
+  std::size_t PutEnd(Ch*) { return 0; }
+
+ private:
+  void fill() {
+    _consumed += static_cast<std::size_t>(_end - _buffer.data());
+    _input.read(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    _current = _buffer.data();
+    _end = _current + _input.gcount();
+  }
+
+  std::istream& _input;
+  std::vector<char> _buffer;
+  std::size_t _consumed = 0;
+  const char* _current;
+  const char* _end;
+};
+
+/**
+ * Handler of the events of a rapidjson reader that builds one testcase
+ * at a time and hands it over once it is complete.
+ */
+class TestcaseHandler
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, TestcaseHandler> {
+  enum class State : std::uint8_t {
+    Root,
+    List,
+    Testcase,
+    ExpectMetadata,
+    Metadata,
+    MetadataField,
+    ExpectSection,
+    Section,
+    Entry,
+    EntryKey,
+    Value,
+    Skip
+  };
+
+  enum class Section : std::uint8_t { Results, Assertions, Metrics };
+
+  /**
+   * Value of a result that is being built. Objects are written as
+   * `{"name": {members}}`, so they go through a few steps.
+   */
+  struct Frame {
+    enum class Kind : std::uint8_t { Array, Wrapper, Named, Members, Closing };
+    Kind kind;
+    data_point value;
+    std::string key;
+  };
+
+ public:
+  explicit TestcaseHandler(
+      const std::function<void(const Testcase&)>& callback)
+      : _callback(callback) {}
+
+  const std::string& error() const { return _error; }
+
+  bool Null() { return scalar(data_point::null()); }
+
+  bool Bool(const bool value) { return scalar(data_point::boolean(value)); }
+
+  bool Int(const int value) {
+    return scalar(data_point::number_signed(value));
+  }
+
+  bool Uint(const unsigned value) {
+    return scalar(data_point::number_signed(value));
+  }
+
+  bool Int64(const std::int64_t value) {
+    return scalar(data_point::number_signed(value));
+  }
+
+  bool Uint64(const std::uint64_t value) {
+    const auto max = std::numeric_limits<std::int64_t>::max();
+    return scalar(value <= static_cast<std::uint64_t>(max)
+                      ? data_point::number_signed(
+                            static_cast<std::int64_t>(value))
+                      : data_point::number_unsigned(value));
+  }
+
+  bool Double(const double value) {
+    return scalar(data_point::number_double(value));
+  }
+
+  bool String(const char* str, const rapidjson::SizeType length, bool) {
+    std::string value(str, length);
+    if (_state == State::MetadataField) {
+      *_field = std::move(value);
+      _state = State::Metadata;
+      return true;
+    }
+    if (_state == State::EntryKey) {
+      _key = std::move(value);
+      _has_key = true;
+      _state = State::Entry;
+      return true;
+    }
+    return scalar(data_point::string(std::move(value)));
+  }
+
+  bool Key(const char* str, const rapidjson::SizeType length, bool) {
+    std::string key(str, length);
+    switch (_state) {
+      case State::Testcase:
+        if (key == "metadata") {
+          _state = State::ExpectMetadata;
+        } else if (key == "results" || key == "assertion" ||
+                   key == "metrics") {
+          _section = key == "results"     ? Section::Results
+                     : key == "assertion" ? Section::Assertions
+                                          : Section::Metrics;
+          _state = State::ExpectSection;
+        } else {
+          skip(State::Testcase);
+        }
+        return true;
+      case State::Metadata: {
+        const auto& it = _fields.find(key);
+        if (it == _fields.end()) {
+          skip(State::Metadata);
+          return true;
+        }
+        _field = &(_metadata.*(it->second));
+        _state = State::MetadataField;
+        return true;
+      }
+      case State::Entry:
+        if (key == "key") {
+          _state = State::EntryKey;
+        } else if (key == "value") {
+          _state = State::Value;
+        } else {
+          skip(State::Entry);
+        }
+        return true;
+      case State::Value: {
+        auto& frame = _frames.back();
+        if (frame.kind == Frame::Kind::Wrapper) {
+          frame.kind = Frame::Kind::Named;
+        } else if (frame.kind != Frame::Kind::Members) {
+          return fail("objects should have a single name");
+        }
+        frame.key = std::move(key);
+        return true;
+      }
+      case State::Skip:
+        return true;
+      default:
+        return fail("unexpected key");
+    }
+  }
+
+  bool StartObject() {
+    switch (_state) {
+      case State::Root:
+      case State::List:
+        _state = State::Testcase;
+        return true;
+      case State::ExpectMetadata:
+        _state = State::Metadata;
+        return true;
+      case State::Section:
+        _state = State::Entry;
+        _has_key = false;
+        _has_value = false;
+        return true;
+      case State::Value:
+        if (!_frames.empty() && _frames.back().kind == Frame::Kind::Named) {
+          auto& frame = _frames.back();
+          frame.kind = Frame::Kind::Members;
+          frame.value = object(std::move(frame.key));
+          return true;
+        }
+        if (!_frames.empty() && _frames.back().kind != Frame::Kind::Array &&
+            _frames.back().kind != Frame::Kind::Members) {
+          return fail("objects should have a single name");
+        }
+        _frames.push_back({Frame::Kind::Wrapper, data_point::null(), {}});
+        return true;
+      case State::Skip:
+        ++_skip_depth;
+        return true;
+      default:
+        return fail("unexpected object");
+    }
+  }
+
+  bool EndObject(rapidjson::SizeType) {
+    switch (_state) {
+      case State::Testcase:
+        _callback(Testcase(_metadata, _results, _metrics));
+        _metadata = {};
+        _results.clear();
+        _metrics.clear();
+        _state = _in_list ? State::List : State::Root;
+        return true;
+      case State::Metadata:
+        _state = State::Testcase;
+        return true;
+      case State::Entry:
+        _state = State::Section;
+        return add_entry();
+      case State::Value: {
+        auto& frame = _frames.back();
+        if (frame.kind == Frame::Kind::Members) {
+          frame.kind = Frame::Kind::Closing;
+          return true;
+        }
+        if (frame.kind != Frame::Kind::Closing) {
+          return fail("objects should have a name");
+        }
+        auto value = std::move(frame.value);
+        _frames.pop_back();
+        return add_value(std::move(value));
+      }
+      case State::Skip:
+        return leave_skipped();
+      default:
+        return fail("unexpected end of object");
+    }
+  }
+
+  bool StartArray() {
+    switch (_state) {
+      case State::Root:
+        _in_list = true;
+        _state = State::List;
+        return true;
+      case State::ExpectSection:
+        _state = State::Section;
+        return true;
+      case State::Value:
+        if (!_frames.empty() && _frames.back().kind != Frame::Kind::Array &&
+            _frames.back().kind != Frame::Kind::Members) {
+          return fail("objects should have a single name");
+        }
+        _frames.push_back({Frame::Kind::Array, array(), {}});
+        return true;
+      case State::Skip:
+        ++_skip_depth;
+        return true;
+      default:
+        return fail("unexpected array");
+    }
+  }
+
+  bool EndArray(rapidjson::SizeType) {
+    switch (_state) {
+      case State::List:
+        _in_list = false;
+        _state = State::Root;
+        return true;
+      case State::Section:
+        _state = State::Testcase;
+        return true;
+      case State::Value: {
+        auto value = std::move(_frames.back().value);
+        _frames.pop_back();
+        return add_value(std::move(value));
+      }
+      case State::Skip:
+        return leave_skipped();
+      default:
+        return fail("unexpected end of array");
+    }
+  }
+
+ private:
+  bool fail(const std::string& message) {
+    _error = message;
+    return false;
+  }
+
+  void skip(const State next) {
+    _state = State::Skip;
+    _skip_depth = 0;
+    _skip_next = next;
+  }
+
+  bool leave_skipped() {
+    if (--_skip_depth == 0) {
+      _state = _skip_next;
+    }
+    return true;
+  }
+
+  bool scalar(data_point&& value) {
+    switch (_state) {
+      case State::Value:
+        if (!_frames.empty() && _frames.back().kind != Frame::Kind::Array &&
+            _frames.back().kind != Frame::Kind::Members) {
+          return fail("objects should have a single name");
+        }
+        return add_value(std::move(value));
+      case State::Skip:
+        if (_skip_depth == 0) {
+          _state = _skip_next;
+        }
+        return true;
+      default:
+        return fail("unexpected value");
+    }
+  }
+
+  bool add_value(data_point&& value) {
+    if (_frames.empty()) {
+      _value = std::move(value);
+      _has_value = true;
+      _state = State::Entry;
+      return true;
+    }
+    auto& frame = _frames.back();
+    if (frame.kind == Frame::Kind::Array) {
+      frame.value.as_array()->push_back(std::move(value));
+    } else {
+      frame.value.as_object()->emplace(std::move(frame.key), std::move(value));
+    }
+    return true;
+  }
+
+  bool add_entry() {
+    if (!_has_key || !_has_value) {
+      return fail("entries should have a key and a value");
+    }
+    if (_section != Section::Metrics) {
+      const auto category = _section == Section::Results
+                                ? ResultCategory::Check
+                                : ResultCategory::Assert;
+      _results.emplace(std::move(_key),
+                       ResultEntry{std::move(_value), category});
+      return true;
+    }
+    if (_value.type() == detail::internal_type::number_signed &&
+        0 <= _value.as_number_signed()) {
+      _metrics.emplace(std::move(_key), _value.as_number_signed());
+      return true;
+    }
+    if (_value.type() == detail::internal_type::number_unsigned) {
+      _metrics.emplace(std::move(_key), _value.as_number_unsigned());
+      return true;
+    }
+    // older versions of the SDK wrote metrics as strings
+    if (_value.type() == detail::internal_type::string &&
+        !_value.as_string()->empty() &&
+        _value.as_string()->find_first_not_of("0123456789") ==
+            std::string::npos) {
+      _metrics.emplace(std::move(_key), std::stoull(*_value.as_string()));
+      return true;
+    }
+    return fail("metrics should be non-negative integers");
+  }
+
+  const std::function<void(const Testcase&)>& _callback;
+  const std::unordered_map<std::string, std::string Testcase::Metadata::*>
+      _fields = {{"teamslug", &Testcase::Metadata::teamslug},
+                 {"testsuite", &Testcase::Metadata::testsuite},
+                 {"version", &Testcase::Metadata::version},
+                 {"testcase", &Testcase::Metadata::testcase},
+                 {"builtAt", &Testcase::Metadata::builtAt}};
+  std::string _error;
+  State _state = State::Root;
+  bool _in_list = false;
+  Section _section = Section::Results;
+  std::size_t _skip_depth = 0;
+  State _skip_next = State::Root;
+
+  Testcase::Metadata _metadata;
+  std::string* _field = nullptr;
+  ResultsMap _results;
+  std::unordered_map<std::string, detail::number_unsigned_t> _metrics;
+
+  std::string _key;
+  bool _has_key = false;
+  data_point _value = data_point::null();
+  bool _has_value = false;
+  std::vector<Frame> _frames;
+};
+
+bool is_space(const char c) {
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+}  // namespace
+
+void for_each_json_testcase(
+    std::istream& input, const std::function<void(const Testcase&)>& callback) {
+  JsonInputStream stream(input);
+  TestcaseHandler handler(callback);
+  rapidjson::Reader reader;
+  while (true) {
+    while (is_space(stream.Peek())) {
+      stream.Take();
+    }
+    if (stream.Peek() == '\0') {
+      break;
+    }
+    if (!reader.Parse<rapidjson::kParseStopWhenDoneFlag>(stream, handler)) {
+      const auto& reason =
+          handler.error().empty()
+              ? std::string(rapidjson::GetParseError_En(
+                    reader.GetParseErrorCode()))
+              : handler.error();
+      throw touca::detail::runtime_error(
+          touca::detail::format("failed to parse json at offset {}: {}",
+                                reader.GetErrorOffset(), reason));
+    }
+  }
+}
+
+void for_each_json_testcase(
+    const touca::filesystem::path& path,
+    const std::function<void(const Testcase&)>& callback) {
+  std::ifstream input(path.string(), std::ios::in | std::ios::binary);
+  if (!input) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("failed to read file {}", path.string()));
+  }
+  for_each_json_testcase(input, callback);
+}
+
+}  // namespace touca
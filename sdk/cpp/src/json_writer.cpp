@@ -0,0 +1,221 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/json_writer.hpp"
+
+#include <exception>
+
+#include "rapidjson/writer.h"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/types.hpp"
+
+namespace touca {
+namespace detail {
+namespace {
+
+/** number of bytes buffered before they are handed over */
+constexpr std::size_t buffer_capacity = 64 * 1024;
+
+/**
+ * Output stream of rapidjson writers that buffers content in a fixed
+ * amount of memory and hands it over either to a file or to a string.
+ */
+class JsonStream {
+ public:
+  typedef char Ch;
+
+  JsonStream(std::FILE* file, std::string* text) : _file(file), _text(text) {
+    _buffer.reserve(buffer_capacity);
+  }
+
+  void Put(const char c) {
+    if (_buffer.size() == buffer_capacity) {
+      Flush();
+    }
+    _buffer.push_back(c);
+  }
+
+  void Flush() {
+    if (_text) {
+      _text->append(_buffer);
+    } else if (std::fwrite(_buffer.data(), 1, _buffer.size(), _file) !=
+               _buffer.size()) {
+      throw touca::detail::runtime_error("failed to write json output");
+    }
+    _buffer.clear();
+  }
+
+ private:
+  std::FILE* _file;
+  std::string* _text;
+  std::string _buffer;
+};
+
+}  // namespace
+
+struct JsonWriter::Impl {
+  Impl(std::FILE* file, std::string* text, const Layout layout)
+      : stream(file, text), writer(stream), layout(layout) {
+    writer.SetMaxDecimalPlaces(3);
+    if (layout == Layout::Array) {
+      writer.StartArray();
+    }
+  }
+
+  JsonStream stream;
+  rapidjson::Writer<JsonStream> writer;
+  Layout layout;
+};
+
+JsonWriter::JsonWriter(std::FILE* file, const Layout layout)
+    : _impl(touca::detail::make_unique<Impl>(file, nullptr, layout)) {}
+
+JsonWriter::JsonWriter(std::string& text, const Layout layout)
+    : _impl(touca::detail::make_unique<Impl>(nullptr, &text, layout)) {}
+
+JsonWriter::~JsonWriter() {
+  try {
+    _impl->stream.Flush();
+  } catch (const std::exception&) {
+    // destructors should not throw. callers that need to know whether the
+    // output was written should call `finish`.
+  }
+}
+
+void JsonWriter::write(const Testcase& testcase) {
+  auto& writer = _impl->writer;
+  const auto& meta = testcase._metadata;
+  writer.StartObject();
+  writer.Key("metadata");
+  writer.StartObject();
+  writer.Key("teamslug");
+  writer.String(meta.teamslug);
+  writer.Key("testsuite");
+  writer.String(meta.testsuite);
+  writer.Key("version");
+  writer.String(meta.version);
+  writer.Key("testcase");
+  writer.String(meta.testcase);
+  writer.Key("builtAt");
+  writer.String(meta.builtAt);
+  writer.EndObject();
+
+  const auto& write_results = [&](const ResultCategory category) {
+    writer.StartArray();
+    for (const auto& entry : testcase._resultsMap) {
+      if (entry.second.typ != category) {
+        continue;
+      }
+      writer.StartObject();
+      writer.Key("key");
+      writer.String(entry.first);
+      writer.Key("value");
+      write_value(entry.second.val);
+      writer.EndObject();
+    }
+    writer.EndArray();
+  };
+  writer.Key("results");
+  write_results(ResultCategory::Check);
+  writer.Key("assertion");
+  write_results(ResultCategory::Assert);
+
+  writer.Key("metrics");
+  writer.StartArray();
+  for (const auto& entry : testcase.metrics()) {
+    writer.StartObject();
+    writer.Key("key");
+    writer.String(entry.first);
+    writer.Key("value");
+    write_value(entry.second.value);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  if (_impl->layout == Layout::Lines) {
+    _impl->stream.Put('\n');
+    writer.Reset(_impl->stream);
+  }
+}
+
+void JsonWriter::finish() {
+  if (_impl->layout == Layout::Array) {
+    _impl->writer.EndArray();
+  }
+  _impl->stream.Flush();
+}
+
+void JsonWriter::write_value(const data_point& value) {
+  auto& writer = _impl->writer;
+  switch (value.type()) {
+    case internal_type::boolean:
+      writer.Bool(value.as_boolean());
+      break;
+    case internal_type::number_signed:
+      writer.Int64(value.as_number_signed());
+      break;
+    case internal_type::number_unsigned:
+      writer.Uint64(value.as_number_unsigned());
+      break;
+    case internal_type::number_float:
+      writer.Double(value.as_number_float());
+      break;
+    case internal_type::number_double:
+      writer.Double(value.as_number_double());
+      break;
+    case internal_type::string:
+      writer.String(*value.as_string());
+      break;
+    case internal_type::array:
+      writer.StartArray();
+      for (const auto& element : *value.as_array()) {
+        write_value(element);
+      }
+      writer.EndArray();
+      break;
+    case internal_type::object: {
+      const auto& obj = detail::get<deep_copy_ptr<object>>(value._value);
+      writer.StartObject();
+      writer.Key(obj->get_name());
+      writer.StartObject();
+      for (const auto& member : *obj) {
+        writer.Key(member.first);
+        write_value(member.second);
+      }
+      writer.EndObject();
+      writer.EndObject();
+      break;
+    }
+    default:
+      writer.Null();
+      break;
+  }
+}
+
+void save_json_file(const std::string& path,
+                    const std::vector<Testcase>& testcases,
+                    const JsonWriter::Layout layout) {
+  create_parent_directory(path);
+  const auto file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("failed to save content to disk: {}", path));
+  }
+  try {
+    JsonWriter writer(file, layout);
+    for (const auto& testcase : testcases) {
+      writer.write(testcase);
+    }
+    writer.finish();
+  } catch (...) {
+    std::fclose(file);
+    throw;
+  }
+  if (std::fclose(file) != 0) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("failed to save content to disk: {}", path));
+  }
+}
+
+}  // namespace detail
+}  // namespace touca
@@ -4,7 +4,9 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <functional>
+#include <memory>
 #include <sstream>
 #include <unordered_map>
 
@@ -39,6 +41,14 @@ void assign_option(const std::unordered_map<std::string, std::string> source,
   }
 }
 
+void assign_option(const std::unordered_map<std::string, std::string> source,
+                   unsigned& field, const std::string& key) {
+  if (source.count(key)) {
+    field = static_cast<unsigned>(
+        std::strtoul(source.at(key).c_str(), nullptr, 10));
+  }
+}
+
 void assign_core_options(
     ClientOptions& target,
     const std::unordered_map<std::string, std::string>& source) {
@@ -49,6 +59,8 @@ void assign_core_options(
   assign_option(source, target.version, "version");
   assign_option(source, target.offline, "offline");
   assign_option(source, target.concurrency, "concurrency");
+  assign_option(source, target.compress, "compress");
+  assign_option(source, target.binary_format, "binary_format");
   assign_option(source, target.api_key, "api-key");
   assign_option(source, target.api_url, "api-url");
   assign_option(source, target.version, "revision");
@@ -141,6 +153,11 @@ void validate_core_options(const ClientOptions& options) {
         touca::detail::format("required configuration options {} are missing",
                               fmt::join(missing_keys, ", ")));
   }
+  if (options.binary_format != "v1" && options.binary_format != "v2" &&
+      options.binary_format != "v3") {
+    throw touca::detail::runtime_error(touca::detail::format(
+        "binary format \"{}\" is not supported", options.binary_format));
+  }
 }
 
 void update_core_options(ClientOptions& options,
@@ -175,11 +192,14 @@ void assign_runner_options(
   assign_option(source, target.config_file, "config_file");
   assign_option(source, target.output_directory, "output_directory");
   assign_option(source, target.overwrite_results, "overwrite_results");
+  assign_option(source, target.consolidate_results, "consolidate_results");
   assign_option(source, target.workflow_filter, "workflow_filter");
   assign_option(source, target.save_binary, "save_binary");
   assign_option(source, target.save_json, "save_json");
   assign_option(source, target.log_level, "log_level");
   assign_option(source, target.redirect_output, "redirect_output");
+  assign_option(source, target.capture_descriptors, "capture_descriptors");
+  assign_option(source, target.output_limit, "output_limit");
   assign_option(source, target.skip_logs, "skip_logs");
   assign_option(source, target.no_color, "no_color");
   assign_option(source, target.no_color, "no-color");
@@ -187,8 +207,33 @@ void assign_runner_options(
   assign_option(source, target.save_json, "save-as-json");
   assign_option(source, target.output_directory, "output-directory");
   assign_option(source, target.overwrite_results, "overwrite");
+  assign_option(source, target.consolidate_results, "consolidate");
+  assign_option(source, target.cache_directory, "cache_directory");
+  assign_option(source, target.cache_directory, "cache-directory");
+  assign_option(source, target.code_version, "code_version");
+  assign_option(source, target.code_version, "code-version");
   assign_option(source, target.workflow_filter, "filter");
+  assign_option(source, target.testcase_file, "testcase_file");
+  assign_option(source, target.testcase_file, "testcase-file");
   assign_option(source, target.submit_async, "submit_async");
+  assign_option(source, target.jobs, "jobs");
+  assign_option(source, target.longest_first, "longest_first");
+  assign_option(source, target.longest_first, "longest-first");
+  assign_option(source, target.time_budget, "time_budget");
+  assign_option(source, target.time_budget, "time-budget");
+  assign_option(source, target.shard_count, "shard_count");
+  assign_option(source, target.shard_count, "shard-count");
+  assign_option(source, target.shard_index, "shard_index");
+  assign_option(source, target.shard_index, "shard-index");
+  assign_option(source, target.isolate_testcases, "isolate_testcases");
+  assign_option(source, target.isolate_testcases, "isolate");
+  assign_option(source, target.testcases_per_process,
+                "testcases_per_process");
+  assign_option(source, target.testcases_per_process,
+                "testcases-per-process");
+  assign_option(source, target.prefetch, "prefetch");
+  assign_option(source, target.prefetch_memory, "prefetch_memory");
+  assign_option(source, target.prefetch_memory, "prefetch-memory");
 }
 
 std::unordered_map<std::string, std::string> load_ini_file(
@@ -224,7 +269,7 @@ std::string make_remote_options_payload(RunnerOptions& options) {
     if (!workflow.version.empty()) {
       rjItem.AddMember("version", workflow.version, allocator);
     }
-    if (workflow.testcases.empty()) {
+    if (workflow.testcases.empty() && !workflow.testcase_source) {
       rapidjson::Value rjCases(rapidjson::kArrayType);
       rjItem.AddMember("testcases", rjCases, allocator);
     }
@@ -303,15 +348,60 @@ static cxxopts::Options cli_options(const char* program = "./app") {
       ("save-as-json",
           "save a copy of test results on local disk in json format",
           cxxopts::value<bool>()->implicit_value("true"))
+      ("compress",
+          "compress test results saved in binary format or submitted to the server",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("binary-format",
+          "revision of the binary format of result files: v1, v2 or v3",
+          cxxopts::value<std::string>())
       ("output-directory",
           "path to a local directory to store results files",
           cxxopts::value<std::string>())
       ("overwrite",
           "overwrite result directory for testcase if it already exists",
           cxxopts::value<bool>()->implicit_value("true"))
+      ("jobs",
+          "number of testcases to run at the same time, 0 to use all cores",
+          cxxopts::value<unsigned>())
+      ("longest-first",
+          "run testcases that took longest in previous runs first",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("time-budget",
+          "maximum number of seconds to spend running testcases",
+          cxxopts::value<unsigned>())
+      ("shard-count",
+          "number of shards to split testcases into",
+          cxxopts::value<unsigned>())
+      ("shard-index",
+          "zero-based index of the shard of testcases to run",
+          cxxopts::value<unsigned>())
+      ("isolate",
+          "run each testcase in a separate worker process",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("testcases-per-process",
+          "number of testcases each worker process runs before it exits",
+          cxxopts::value<unsigned>())
+      ("prefetch",
+          "number of upcoming testcases whose input to load ahead of time",
+          cxxopts::value<unsigned>())
+      ("prefetch-memory",
+          "maximum megabytes of input to load ahead of time, 0 for no limit",
+          cxxopts::value<unsigned>())
+      ("consolidate",
+          "store results of all testcases in a single file per version",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("cache-directory",
+          "path to a directory to keep results of testcases for reuse",
+          cxxopts::value<std::string>())
+      ("code-version",
+          "version of the code under test that invalidates kept results",
+          cxxopts::value<std::string>())
       ("testcase",
           "one or more testcases to feed to the workflow",
           cxxopts::value<std::vector<std::string>>())
+      ("testcase-file",
+          "file with one testcase per line to feed to the workflow",
+          cxxopts::value<std::string>())
       ("filter",
           "Name of the workflow to run",
           cxxopts::value<std::string>())
@@ -329,7 +419,13 @@ static cxxopts::Options cli_options(const char* program = "./app") {
           cxxopts::value<bool>()->implicit_value("true"))
       ("redirect-output",
           "redirect content printed to standard streams to files",
-          cxxopts::value<bool>()->default_value("true"));
+          cxxopts::value<bool>()->default_value("true"))
+      ("capture-descriptors",
+          "capture content written to file descriptors of standard streams",
+          cxxopts::value<bool>()->implicit_value("true"))
+      ("output-limit",
+          "maximum number of bytes of each standard stream to capture",
+          cxxopts::value<unsigned>());
   // clang-format on
 
   return options;
@@ -357,6 +453,13 @@ static void parse_file_option(const rapidjson::Value& result,
   }
 }
 
+static void parse_file_option(const rapidjson::Value& result,
+                              const std::string& key, unsigned& field) {
+  if (result.HasMember(key) && result[key].IsUint()) {
+    field = result[key].GetUint();
+  }
+}
+
 /**
  * @param argc number of arguments provided to the application
  * @param argv list of arguments provided to the application
@@ -379,11 +482,15 @@ void apply_cli_arguments(int argc, char* argv[], RunnerOptions& options) {
     if (result.count("testcase")) {
       options.testcases = result["testcase"].as<std::vector<std::string>>();
     }
+    parse_cli_option(result, "testcase-file", options.testcase_file);
     parse_cli_option(result, "output-directory", options.output_directory);
     parse_cli_option(result, "log-level", options.log_level);
     parse_cli_option(result, "save-as-binary", options.save_binary);
     parse_cli_option(result, "save-as-json", options.save_json);
     parse_cli_option(result, "redirect-output", options.redirect_output);
+    parse_cli_option(result, "capture-descriptors",
+                     options.capture_descriptors);
+    parse_cli_option(result, "output-limit", options.output_limit);
     parse_cli_option(result, "no-color", options.no_color);
     parse_cli_option(result, "api-key", options.api_key);
     parse_cli_option(result, "api-url", options.api_url);
@@ -393,7 +500,22 @@ void apply_cli_arguments(int argc, char* argv[], RunnerOptions& options) {
     parse_cli_option(result, "revision", options.version);
     parse_cli_option(result, "skip-logs", options.skip_logs);
     parse_cli_option(result, "offline", options.offline);
+    parse_cli_option(result, "compress", options.compress);
+    parse_cli_option(result, "binary-format", options.binary_format);
     parse_cli_option(result, "overwrite", options.overwrite_results);
+    parse_cli_option(result, "consolidate", options.consolidate_results);
+    parse_cli_option(result, "cache-directory", options.cache_directory);
+    parse_cli_option(result, "code-version", options.code_version);
+    parse_cli_option(result, "jobs", options.jobs);
+    parse_cli_option(result, "longest-first", options.longest_first);
+    parse_cli_option(result, "time-budget", options.time_budget);
+    parse_cli_option(result, "shard-count", options.shard_count);
+    parse_cli_option(result, "shard-index", options.shard_index);
+    parse_cli_option(result, "isolate", options.isolate_testcases);
+    parse_cli_option(result, "testcases-per-process",
+                     options.testcases_per_process);
+    parse_cli_option(result, "prefetch", options.prefetch);
+    parse_cli_option(result, "prefetch-memory", options.prefetch_memory);
   } catch (const cxxopts::OptionParseException& ex) {
     throw touca::detail::runtime_error(touca::detail::format(
         "failed to parse command line arguments: {}", ex.what()));
@@ -442,6 +564,8 @@ void apply_config_file(RunnerOptions& options) {
       parse_file_option(result, "revision", options.version);
       parse_file_option(result, "offline", options.offline);
       parse_file_option(result, "concurrency", options.concurrency);
+      parse_file_option(result, "compress", options.compress);
+      parse_file_option(result, "binary-format", options.binary_format);
       parse_file_option(result, "submit_async", options.submit_async);
 
       parse_file_option(result, "config-file", options.config_file);
@@ -452,7 +576,24 @@ void apply_config_file(RunnerOptions& options) {
       parse_file_option(result, "save-as-json", options.save_json);
       parse_file_option(result, "skip-logs", options.skip_logs);
       parse_file_option(result, "redirect-output", options.redirect_output);
+      parse_file_option(result, "capture-descriptors",
+                        options.capture_descriptors);
+      parse_file_option(result, "output-limit", options.output_limit);
       parse_file_option(result, "overwrite", options.overwrite_results);
+      parse_file_option(result, "consolidate", options.consolidate_results);
+      parse_file_option(result, "cache-directory", options.cache_directory);
+      parse_file_option(result, "code-version", options.code_version);
+      parse_file_option(result, "jobs", options.jobs);
+      parse_file_option(result, "longest-first", options.longest_first);
+      parse_file_option(result, "time-budget", options.time_budget);
+      parse_file_option(result, "shard-count", options.shard_count);
+      parse_file_option(result, "shard-index", options.shard_index);
+      parse_file_option(result, "isolate", options.isolate_testcases);
+      parse_file_option(result, "testcases-per-process",
+                        options.testcases_per_process);
+      parse_file_option(result, "prefetch", options.prefetch);
+      parse_file_option(result, "prefetch-memory", options.prefetch_memory);
+      parse_file_option(result, "testcase-file", options.testcase_file);
     }
   }
 }
@@ -522,6 +663,11 @@ void apply_runner_options(RunnerOptions& options) {
   for (auto& w : options.workflows) {
     if (!options.testcases.empty()) {
       w.testcases = options.testcases;
+      w.testcase_source = nullptr;
+    }
+    if (!options.testcase_file.empty()) {
+      w.testcases.clear();
+      w.testcase_source = touca::testcases_from_file(options.testcase_file);
     }
     if (!options.suite.empty()) {
       w.suite = options.suite;
@@ -533,6 +679,7 @@ void apply_runner_options(RunnerOptions& options) {
   options.suite.clear();
   options.version.clear();
   options.testcases.clear();
+  options.testcase_file.clear();
 }
 
 void apply_remote_options(RunnerOptions& options,
@@ -564,7 +711,7 @@ void apply_remote_options(RunnerOptions& options,
                      [&v](Workflow& w) { return v.suite == w.suite; });
     if (workflow != options.workflows.end()) {
       workflow->version = v.version;
-      if (workflow->testcases.empty()) {
+      if (workflow->testcases.empty() && !workflow->testcase_source) {
         workflow->testcases = v.testcases;
       }
     }
@@ -596,12 +743,49 @@ void validate_runner_options(const RunnerOptions& options) {
         "workflows.");
   }
   if (std::any_of(options.workflows.begin(), options.workflows.end(),
-                  [](const Workflow& w) { return w.testcases.empty(); })) {
+                  [](const Workflow& w) {
+                    return w.testcases.empty() && !w.testcase_source;
+                  })) {
     throw touca::detail::runtime_error(
         "Configuration option \"testcases\" is missing for one or more "
         "workflows.");
   }
 
+#ifdef _WIN32
+  if (options.isolate_testcases) {
+    throw touca::detail::runtime_error(
+        "Configuration option \"isolate\" is not supported on this "
+        "platform.");
+  }
+  if (options.capture_descriptors) {
+    throw touca::detail::runtime_error(
+        "Configuration option \"capture-descriptors\" is not supported on "
+        "this platform.");
+  }
+#endif
+  if (options.capture_descriptors && options.jobs != 1 &&
+      !options.isolate_testcases) {
+    throw touca::detail::runtime_error(
+        "Configuration option \"capture-descriptors\" requires option "
+        "\"isolate\" when option \"jobs\" is not 1.");
+  }
+
+  if (options.shard_count != 0 && options.shard_count <= options.shard_index) {
+    throw touca::detail::runtime_error(
+        "Configuration option \"shard-index\" must be less than option "
+        "\"shard-count\".");
+  }
+  if (options.shard_count == 0 && options.shard_index != 0) {
+    throw touca::detail::runtime_error(
+        "Configuration option \"shard-index\" requires option "
+        "\"shard-count\".");
+  }
+  if (options.shard_count != 0 && !options.save_binary) {
+    throw touca::detail::runtime_error(
+        "Configuration option \"shard-count\" requires option "
+        "\"save-as-binary\".");
+  }
+
   const auto& levels = {"debug", "info", "warning"};
   if (std::find(levels.begin(), levels.end(), options.log_level) ==
       levels.end()) {
@@ -628,4 +812,89 @@ void update_runner_options(int argc, char* argv[], RunnerOptions& options) {
 #endif  // TOUCA_INCLUDE_RUNNER
 
 }  // namespace detail
+
+#ifdef TOUCA_INCLUDE_RUNNER
+
+namespace {
+
+/**
+ * Checks whether a given name matches a given pattern in which `*` matches
+ * any sequence of characters and `?` matches any single character.
+ */
+bool match_pattern(const std::string& name, const std::string& pattern) {
+  std::size_t n = 0;
+  std::size_t p = 0;
+  auto star = std::string::npos;
+  std::size_t resume = 0;
+  while (n < name.size()) {
+    if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+      ++n;
+      ++p;
+    } else if (p < pattern.size() && pattern[p] == '*') {
+      star = p++;
+      resume = n;
+    } else if (star != std::string::npos) {
+      p = star + 1;
+      n = ++resume;
+    } else {
+      return false;
+    }
+  }
+  while (p < pattern.size() && pattern[p] == '*') {
+    ++p;
+  }
+  return p == pattern.size();
+}
+
+}  // namespace
+
+TestcaseSource testcases_from_file(const std::string& path) {
+  return [path]() -> TestcaseGenerator {
+    const auto file = std::make_shared<std::ifstream>(path);
+    if (!file->is_open()) {
+      throw touca::detail::runtime_error(
+          touca::detail::format("failed to read testcases from {}", path));
+    }
+    return [file](std::string& testcase) {
+      while (std::getline(*file, testcase)) {
+        if (!testcase.empty() && testcase.back() == '\r') {
+          testcase.pop_back();
+        }
+        if (!testcase.empty()) {
+          return true;
+        }
+      }
+      return false;
+    };
+  };
+}
+
+TestcaseSource testcases_from_directory(const std::string& directory,
+                                        const std::string& pattern) {
+  return [directory, pattern]() -> TestcaseGenerator {
+    std::error_code ec;
+    const auto it = std::make_shared<touca::filesystem::directory_iterator>(
+        directory, ec);
+    if (ec) {
+      throw touca::detail::runtime_error(touca::detail::format(
+          "failed to read testcases from {}", directory));
+    }
+    return [it, pattern](std::string& testcase) {
+      for (; *it != touca::filesystem::directory_iterator(); ++*it) {
+        const auto& entry = **it;
+        const auto& name = entry.path().filename().string();
+        if (touca::filesystem::is_regular_file(entry.path()) &&
+            match_pattern(name, pattern)) {
+          testcase = name;
+          ++*it;
+          return true;
+        }
+      }
+      return false;
+    };
+  };
+}
+
+#endif  // TOUCA_INCLUDE_RUNNER
+
 }  // namespace touca
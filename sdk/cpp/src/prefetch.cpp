@@ -0,0 +1,136 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/runner/detail/prefetch.hpp"
+
+#include <algorithm>
+
+namespace touca {
+namespace detail {
+
+Prefetcher::Prefetcher(const Loader& loader, const std::size_t threads,
+                       const std::size_t budget)
+    : _loader(loader), _budget(budget) {
+  _threads.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    _threads.emplace_back(&Prefetcher::work, this);
+  }
+}
+
+Prefetcher::~Prefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stopped = true;
+  }
+  _cv.notify_all();
+  for (auto& thread : _threads) {
+    thread.join();
+  }
+}
+
+void Prefetcher::schedule(const std::string& testcase) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_entries.count(testcase)) {
+      return;
+    }
+    _entries[testcase] = Entry{State::Queued, {}, nullptr};
+    _queue.push_back(testcase);
+  }
+  _cv.notify_all();
+}
+
+TestcaseInput Prefetcher::take(const std::string& testcase) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  auto it = _entries.find(testcase);
+  if (it == _entries.end() || it->second.state == State::Queued) {
+    if (it != _entries.end()) {
+      cancel(testcase);
+      _entries.erase(it);
+    }
+    lock.unlock();
+    return _loader(testcase);
+  }
+  _cv.wait(lock, [&]() {
+    return _entries.at(testcase).state == State::Loaded;
+  });
+  it = _entries.find(testcase);
+  const auto entry = std::move(it->second);
+  _entries.erase(it);
+  _memory -= entry.input.size;
+  lock.unlock();
+  _cv.notify_all();
+  if (entry.error) {
+    std::rethrow_exception(entry.error);
+  }
+  return entry.input;
+}
+
+void Prefetcher::discard(const std::string& testcase) {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto it = _entries.find(testcase);
+    if (it == _entries.end()) {
+      return;
+    }
+    switch (it->second.state) {
+      case State::Queued:
+        cancel(testcase);
+        _entries.erase(it);
+        return;
+      case State::Loading:
+        it->second.state = State::Discarded;
+        return;
+      case State::Loaded:
+        _memory -= it->second.input.size;
+        _entries.erase(it);
+        break;
+      case State::Discarded:
+        return;
+    }
+  }
+  _cv.notify_all();
+}
+
+void Prefetcher::work() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _cv.wait(lock, [this]() {
+      return _stopped ||
+             (!_queue.empty() && (_budget == 0 || _memory < _budget));
+    });
+    if (_stopped) {
+      return;
+    }
+    const auto testcase = std::move(_queue.front());
+    _queue.pop_front();
+    _entries.at(testcase).state = State::Loading;
+    lock.unlock();
+
+    Entry entry{State::Loaded, {}, nullptr};
+    try {
+      entry.input = _loader(testcase);
+    } catch (...) {
+      entry.error = std::current_exception();
+    }
+
+    lock.lock();
+    const auto it = _entries.find(testcase);
+    if (it->second.state == State::Discarded) {
+      _entries.erase(it);
+      continue;
+    }
+    _memory += entry.input.size;
+    it->second = std::move(entry);
+    _cv.notify_all();
+  }
+}
+
+void Prefetcher::cancel(const std::string& testcase) {
+  const auto it = std::find(_queue.begin(), _queue.end(), testcase);
+  if (it != _queue.end()) {
+    _queue.erase(it);
+  }
+}
+
+}  // namespace detail
+}  // namespace touca
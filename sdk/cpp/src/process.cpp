@@ -0,0 +1,338 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/runner/detail/process.hpp"
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+#include "touca/core/config.hpp"
+#include "touca/core/filesystem.hpp"
+
+namespace touca {
+namespace detail {
+
+#ifndef _WIN32
+
+namespace {
+
+bool write_all(const int fd, const char* data, std::size_t size) {
+  while (size != 0) {
+    const auto count = ::write(fd, data, size);
+    if (count == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    data += count;
+    size -= static_cast<std::size_t>(count);
+  }
+  return true;
+}
+
+bool read_all(const int fd, char* data, std::size_t size) {
+  while (size != 0) {
+    const auto count = ::read(fd, data, size);
+    if (count == -1 && errno == EINTR) {
+      continue;
+    }
+    if (count <= 0) {
+      return false;
+    }
+    data += count;
+    size -= static_cast<std::size_t>(count);
+  }
+  return true;
+}
+
+template <typename T>
+void put(std::string& out, const T value) {
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+template <typename T>
+bool get(const int fd, T& value) {
+  std::array<unsigned char, sizeof(T)> bytes;
+  if (!read_all(fd, reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+    return false;
+  }
+  value = 0;
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    value |= static_cast<T>(bytes[i]) << (8 * i);
+  }
+  return true;
+}
+
+/**
+ * Messages are made of the number of their fields, followed by the size
+ * and content of each field.
+ */
+bool write_message(const int fd, const ProcessPool::Message& message) {
+  std::string out;
+  put<std::uint32_t>(out, static_cast<std::uint32_t>(message.size()));
+  for (const auto& field : message) {
+    put<std::uint64_t>(out, field.size());
+    out.append(field);
+  }
+  return write_all(fd, out.data(), out.size());
+}
+
+bool read_message(const int fd, ProcessPool::Message& message) {
+  std::uint32_t count = 0;
+  if (!get(fd, count)) {
+    return false;
+  }
+  message.assign(count, std::string());
+  for (auto& field : message) {
+    std::uint64_t size = 0;
+    if (!get(fd, size)) {
+      return false;
+    }
+    field.resize(static_cast<std::size_t>(size));
+    if (size != 0 && !read_all(fd, &field[0], field.size())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string describe_exit(const int status) {
+  if (WIFSIGNALED(status)) {
+    return touca::detail::format("worker process was terminated by signal {}",
+                                 WTERMSIG(status));
+  }
+  return touca::detail::format("worker process exited with code {}",
+                               WEXITSTATUS(status));
+}
+
+}  // namespace
+
+struct ProcessPool::Worker {
+  pid_t pid;
+  int input;   // write end of the pipe that passes tasks to the child
+  int output;  // read end of the pipe that passes replies to the parent
+  bool busy;
+  std::size_t task;
+  std::size_t done;
+};
+
+ProcessPool::ProcessPool(const std::size_t size, const Handler& handler,
+                         const std::size_t tasks_per_worker,
+                         const std::function<void()>& before_fork)
+    : _size(std::max<std::size_t>(size, 1)),
+      _handler(handler),
+      _tasks_per_worker(tasks_per_worker),
+      _before_fork(before_fork) {
+  // a child process that exits while we pass it a task should not end
+  // this process. we learn about it when we wait for its reply.
+  _sigpipe = std::signal(SIGPIPE, SIG_IGN);
+}
+
+ProcessPool::~ProcessPool() {
+  for (const auto& worker : _workers) {
+    if (worker->busy) {
+      ::kill(worker->pid, SIGKILL);
+    }
+    ::close(worker->input);
+  }
+  for (const auto& worker : _workers) {
+    ::close(worker->output);
+    ::waitpid(worker->pid, nullptr, 0);
+  }
+  std::signal(SIGPIPE, _sigpipe);
+}
+
+bool ProcessPool::idle() const {
+  std::size_t count = 0;
+  for (const auto& worker : _workers) {
+    if (worker->busy) {
+      ++count;
+    }
+  }
+  return count < _size;
+}
+
+bool ProcessPool::busy() const {
+  for (const auto& worker : _workers) {
+    if (worker->busy) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ProcessPool::submit(const std::size_t task, const Message& message) {
+  auto it = std::find_if(
+      _workers.begin(), _workers.end(),
+      [](const std::unique_ptr<Worker>& worker) { return !worker->busy; });
+  if (it == _workers.end()) {
+    spawn();
+    it = std::prev(_workers.end());
+  }
+  auto& worker = **it;
+  worker.busy = true;
+  worker.task = task;
+  // if the child process has exited, its reply pipe is closed as well and
+  // `receive` reports the task as failed.
+  write_message(worker.input, message);
+}
+
+ProcessPool::Reply ProcessPool::receive() {
+  std::vector<struct pollfd> fds;
+  std::vector<std::size_t> indices;
+  for (std::size_t i = 0; i < _workers.size(); ++i) {
+    if (_workers[i]->busy) {
+      fds.push_back({_workers[i]->output, POLLIN, 0});
+      indices.push_back(i);
+    }
+  }
+  if (fds.empty()) {
+    throw touca::detail::runtime_error("no task awaits a reply");
+  }
+  while (::poll(fds.data(), fds.size(), -1) == -1) {
+    if (errno != EINTR) {
+      throw touca::detail::runtime_error(touca::detail::format(
+          "failed to wait for worker processes: {}", std::strerror(errno)));
+    }
+  }
+  const auto it = std::find_if(
+      fds.begin(), fds.end(),
+      [](const struct pollfd& fd) { return fd.revents != 0; });
+  const auto index = indices.at(std::distance(fds.begin(), it));
+  auto& worker = *_workers.at(index);
+  Reply reply{worker.task, {}, {}};
+  worker.busy = false;
+  if (!read_message(worker.output, reply.message)) {
+    reply.message.clear();
+    reply.error = stop(index);
+  } else if (++worker.done == _tasks_per_worker) {
+    stop(index);
+  }
+  return reply;
+}
+
+void ProcessPool::spawn() {
+  if (_before_fork) {
+    _before_fork();
+  }
+  std::array<int, 2> input;
+  std::array<int, 2> output;
+  if (::pipe(input.data()) == -1) {
+    throw touca::detail::runtime_error("failed to start worker process");
+  }
+  if (::pipe(output.data()) == -1) {
+    ::close(input[0]);
+    ::close(input[1]);
+    throw touca::detail::runtime_error("failed to start worker process");
+  }
+  // content buffered before the child process starts would otherwise be
+  // written once by each process.
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+  const auto pid = ::fork();
+  if (pid == -1) {
+    for (const auto fd : {input[0], input[1], output[0], output[1]}) {
+      ::close(fd);
+    }
+    throw touca::detail::runtime_error("failed to start worker process");
+  }
+  if (pid != 0) {
+    ::close(input[0]);
+    ::close(output[1]);
+    _workers.push_back(touca::detail::make_unique<Worker>(
+        Worker{pid, input[1], output[0], false, 0, 0}));
+    return;
+  }
+
+  // in the child process, keep only our own ends of our own pipes, so that
+  // other child processes see when the parent closes their pipes.
+  ::close(input[1]);
+  ::close(output[0]);
+  for (const auto& worker : _workers) {
+    ::close(worker->input);
+    ::close(worker->output);
+  }
+  std::signal(SIGPIPE, _sigpipe);
+  try {
+    Message message;
+    while (read_message(input[0], message)) {
+      const auto& reply = _handler(message);
+      std::cout.flush();
+      std::cerr.flush();
+      std::fflush(nullptr);
+      if (!write_message(output[1], reply)) {
+        break;
+      }
+    }
+  } catch (...) {
+    ::_exit(EXIT_FAILURE);
+  }
+  // leave without running destructors or exit handlers, which are meant
+  // for the parent process.
+  ::_exit(EXIT_SUCCESS);
+}
+
+std::string ProcessPool::stop(const std::size_t index) {
+  const auto& worker = *_workers.at(index);
+  ::close(worker.input);
+  ::close(worker.output);
+  int status = 0;
+  while (::waitpid(worker.pid, &status, 0) == -1 && errno == EINTR) {
+  }
+  _workers.erase(_workers.begin() + index);
+  return describe_exit(status);
+}
+
+#else
+
+struct ProcessPool::Worker {};
+
+ProcessPool::ProcessPool(const std::size_t size, const Handler& handler,
+                         const std::size_t tasks_per_worker,
+                         const std::function<void()>& before_fork)
+    : _size(size),
+      _handler(handler),
+      _tasks_per_worker(tasks_per_worker),
+      _before_fork(before_fork) {
+  throw touca::detail::runtime_error(
+      "running testcases in separate processes is not supported on this "
+      "platform");
+}
+
+ProcessPool::~ProcessPool() {}
+
+bool ProcessPool::idle() const { return false; }
+
+bool ProcessPool::busy() const { return false; }
+
+void ProcessPool::submit(const std::size_t, const Message&) {}
+
+ProcessPool::Reply ProcessPool::receive() {
+  throw touca::detail::runtime_error("no task awaits a reply");
+}
+
+void ProcessPool::spawn() {}
+
+std::string ProcessPool::stop(const std::size_t) { return {}; }
+
+#endif
+
+}  // namespace detail
+}  // namespace touca
@@ -0,0 +1,304 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/reader.hpp"
+
+#include <cstring>
+#include <unordered_set>
+
+#include "flatbuffers/flatbuffers.h"
+#include "touca/core/compression.hpp"
+#include "touca/core/deserialize.hpp"
+#include "touca/impl/schema.hpp"
+
+namespace touca {
+
+namespace {
+
+/**
+ * The index of a result file is stored after its `Messages` buffer,
+ * followed by the size of the index and a magic number.
+ */
+constexpr char index_magic[] = "TCIX";
+constexpr std::size_t footer_size = sizeof(std::uint32_t) + 4;
+
+/** shared strings of views of testcases that are not part of a file */
+const touca::detail::StringTable no_strings;
+
+const char* key_of(const fbs::Result* result,
+                   const touca::detail::StringTable& strings) {
+  return strings.get(result->key(), result->key_ref());
+}
+
+const char* key_of(const fbs::Metric* metric,
+                   const touca::detail::StringTable& strings) {
+  return strings.get(metric->key(), metric->key_ref());
+}
+
+const fbs::Result* find_result(const fbs::Message* message,
+                               const fbs::IndexEntry* entry,
+                               const touca::detail::StringTable& strings,
+                               const std::string& key) {
+  if (entry && entry->keys()) {
+    const auto& item = entry->keys()->LookupByKey(key.c_str());
+    if (!item) {
+      return nullptr;
+    }
+    const auto& results = message->results()->entries();
+    if (item->position() < results->size()) {
+      const auto& result = results->Get(item->position());
+      if (std::strcmp(key_of(result, strings), key.c_str()) == 0) {
+        return result;
+      }
+    }
+  }
+  for (const auto&& result : *message->results()->entries()) {
+    if (std::strcmp(key_of(result, strings), key.c_str()) == 0) {
+      return result;
+    }
+  }
+  return nullptr;
+}
+
+const fbs::Metric* find_metric(const fbs::Message* message,
+                               const touca::detail::StringTable& strings,
+                               const std::string& key) {
+  for (const auto&& metric : *message->metrics()->entries()) {
+    if (std::strcmp(key_of(metric, strings), key.c_str()) == 0) {
+      return metric;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TestcaseView::TestcaseView(const fbs::Message* message,
+                           const fbs::IndexEntry* entry,
+                           const touca::detail::StringTable* strings)
+    : _message(message),
+      _entry(entry),
+      _strings(strings ? strings : &no_strings) {}
+
+std::string TestcaseView::name() const {
+  return _message->metadata()->testcase()->str();
+}
+
+Testcase::Metadata TestcaseView::metadata() const {
+  return deserialize_metadata(_message);
+}
+
+std::vector<std::string> TestcaseView::result_keys() const {
+  std::vector<std::string> keys;
+  const auto& entries = _message->results()->entries();
+  keys.reserve(entries->size());
+  for (const auto&& result : *entries) {
+    keys.emplace_back(key_of(result, *_strings));
+  }
+  return keys;
+}
+
+bool TestcaseView::has_result(const std::string& key) const {
+  return find_result(_message, _entry, *_strings, key) != nullptr;
+}
+
+ResultEntry TestcaseView::result(const std::string& key) const {
+  const auto& result = find_result(_message, _entry, *_strings, key);
+  if (!result) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("result `{}` not found", key));
+  }
+  const auto& value = deserialize_value(result->value(), *_strings);
+  if (value.type() == touca::detail::internal_type::unknown) {
+    throw touca::detail::runtime_error("failed to parse results map entry");
+  }
+  return {value, result->typ() == fbs::ResultType::Assert
+                     ? ResultCategory::Assert
+                     : ResultCategory::Check};
+}
+
+std::vector<std::string> TestcaseView::metric_keys() const {
+  std::vector<std::string> keys;
+  const auto& entries = _message->metrics()->entries();
+  keys.reserve(entries->size());
+  for (const auto&& metric : *entries) {
+    keys.emplace_back(key_of(metric, *_strings));
+  }
+  return keys;
+}
+
+bool TestcaseView::has_metric(const std::string& key) const {
+  return find_metric(_message, *_strings, key) != nullptr;
+}
+
+touca::detail::number_signed_t TestcaseView::metric(
+    const std::string& key) const {
+  const auto& metric = find_metric(_message, *_strings, key);
+  if (!metric) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("metric `{}` not found", key));
+  }
+  if (metric->value()->value_type() != fbs::Type::Int) {
+    throw touca::detail::runtime_error("failed to parse metrics map entry");
+  }
+  return deserialize_scalar<touca::detail::number_signed_t>(metric->value());
+}
+
+Testcase TestcaseView::decode() const {
+  return deserialize_testcase(_message, *_strings);
+}
+
+ResultFile::ResultFile(const touca::filesystem::path& path)
+    : _path(path.string()),
+      _file(_path),
+      _data(_file.data()),
+      _size(_file.size()) {
+  if (touca::detail::is_compressed(_data, _size)) {
+    _content = touca::detail::decompress(_data, _size);
+    _data = _content.data();
+    _size = _content.size();
+  }
+  if (!flatbuffers::Verifier(_data, _size).VerifyBuffer<fbs::Messages>()) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("result file invalid: {}", _path));
+  }
+  _strings = touca::detail::StringTable(fbs::GetMessages(_data));
+  _verified.resize(size(), 0);
+  load_footer();
+}
+
+void ResultFile::load_footer() {
+  const auto& data = _data;
+  const auto& size = _size;
+  if (size < footer_size ||
+      std::memcmp(data + size - 4, index_magic, 4) != 0) {
+    return;
+  }
+  const auto& length = flatbuffers::ReadScalar<std::uint32_t>(
+      data + size - footer_size);
+  if (size - footer_size < length) {
+    return;
+  }
+  // an index that fails verification is ignored rather than rejected,
+  // since lookups can still be performed by scanning the file.
+  const auto& ptr = data + size - footer_size - length;
+  if (flatbuffers::Verifier(ptr, length).VerifyBuffer<fbs::Index>()) {
+    _footer = flatbuffers::GetRoot<fbs::Index>(ptr);
+  }
+}
+
+std::size_t ResultFile::size() const {
+  return fbs::GetMessages(_data)->messages()->size();
+}
+
+TestcaseView ResultFile::at(const std::size_t index) const {
+  if (size() <= index) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("testcase index {} out of range", index));
+  }
+  const auto& buffer = fbs::GetMessages(_data)->messages()->Get(
+      static_cast<flatbuffers::uoffset_t>(index));
+  if (!_verified[index]) {
+    if (!flatbuffers::Verifier(buffer->buf()->data(), buffer->buf()->size())
+             .VerifyBuffer<fbs::Message>()) {
+      throw touca::detail::runtime_error(
+          touca::detail::format("result file invalid: {}", _path));
+    }
+    _verified[index] = 1;
+  }
+  return TestcaseView(buffer->buf_nested_root(), nullptr, &_strings);
+}
+
+bool ResultFile::has_testcase(const std::string& name) const {
+  if (_footer && _footer->testcases()) {
+    return _footer->testcases()->LookupByKey(name.c_str()) != nullptr;
+  }
+  return index().count(name) != 0;
+}
+
+TestcaseView ResultFile::testcase(const std::string& name) const {
+  if (_footer && _footer->testcases()) {
+    const auto& entry = _footer->testcases()->LookupByKey(name.c_str());
+    if (!entry) {
+      throw touca::detail::runtime_error(
+          touca::detail::format("testcase `{}` not found", name));
+    }
+    const auto& offset = entry->offset();
+    const auto& length = entry->size();
+    if (_size < offset || _size - offset < length) {
+      throw touca::detail::runtime_error(
+          touca::detail::format("result file invalid: {}", _path));
+    }
+    const auto& ptr = _data + offset;
+    if (!flatbuffers::Verifier(ptr, static_cast<std::size_t>(length))
+             .VerifyBuffer<fbs::Message>()) {
+      throw touca::detail::runtime_error(
+          touca::detail::format("result file invalid: {}", _path));
+    }
+    return TestcaseView(flatbuffers::GetRoot<fbs::Message>(ptr), entry,
+                        &_strings);
+  }
+  const auto& it = index().find(name);
+  if (it == index().end()) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("testcase `{}` not found", name));
+  }
+  return at(it->second);
+}
+
+const std::unordered_map<std::string, std::size_t>& ResultFile::index()
+    const {
+  if (!_indexed) {
+    for (std::size_t i = 0; i < size(); ++i) {
+      _index.emplace(at(i).name(), i);
+    }
+    _indexed = true;
+  }
+  return _index;
+}
+
+void append_index(std::vector<std::uint8_t>& content) {
+  const auto& index = make_index(content.data(), content.size());
+  content.insert(content.end(), index.begin(), index.end());
+}
+
+std::vector<std::uint8_t> make_index(const std::uint8_t* data,
+                                     const std::size_t size) {
+  flatbuffers::FlatBufferBuilder builder;
+  std::vector<flatbuffers::Offset<fbs::IndexEntry>> entries;
+  std::unordered_set<std::string> names;
+  const auto& root = fbs::GetMessages(data);
+  const touca::detail::StringTable strings(root);
+  const auto& messages = root->messages();
+  for (const auto&& item : *messages) {
+    const auto& buffer = item->buf();
+    const auto& message = item->buf_nested_root();
+    const auto& name = message->metadata()->testcase()->str();
+    // readers keep the first testcase with a given name
+    if (!names.insert(name).second) {
+      continue;
+    }
+    std::vector<flatbuffers::Offset<fbs::IndexKey>> keys;
+    const auto& results = message->results()->entries();
+    for (flatbuffers::uoffset_t i = 0; i < results->size(); ++i) {
+      keys.push_back(fbs::CreateIndexKeyDirect(
+          builder, key_of(results->Get(i), strings), i));
+    }
+    const auto& offset =
+        static_cast<std::uint64_t>(buffer->data() - data);
+    entries.push_back(fbs::CreateIndexEntryDirect(
+        builder, name.c_str(), offset, buffer->size(), &keys));
+  }
+  builder.Finish(fbs::CreateIndexDirect(builder, &entries));
+
+  const auto& length = builder.GetSize();
+  std::vector<std::uint8_t> index(((size + 7) & ~std::size_t(7)) - size, 0);
+  const auto& ptr = builder.GetBufferPointer();
+  index.insert(index.end(), ptr, ptr + length);
+  std::uint8_t footer[footer_size];
+  flatbuffers::WriteScalar<std::uint32_t>(footer, length);
+  std::memcpy(footer + sizeof(std::uint32_t), index_magic, 4);
+  index.insert(index.end(), footer, footer + footer_size);
+  return index;
+}
+
+}  // namespace touca
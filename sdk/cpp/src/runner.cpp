@@ -2,24 +2,45 @@
 
 #include "touca/runner/runner.hpp"
 
+#ifndef _WIN32
+#include <poll.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "fmt/color.h"
 #include "fmt/ostream.h"
 #include "fmt/printf.h"
 #include "touca/core/config.hpp"
+#include "touca/core/deserialize.hpp"
 #include "touca/core/filesystem.hpp"
+#include "touca/core/parallel.hpp"
 #include "touca/core/transport.hpp"
+#include "touca/core/writer.hpp"
 #include "touca/runner/detail/helpers.hpp"
+#include "touca/runner/detail/process.hpp"
 #include "touca/touca.hpp"
 
 namespace touca {
@@ -27,12 +48,437 @@ namespace detail {
 
 using Status = Post::Status;
 
+/**
+ * Maximum number of finished testcases whose results may wait to be saved
+ * and submitted while the runner moves on to the next testcase.
+ */
+constexpr std::size_t result_queue_capacity = 16;
+
+/**
+ * Number of testcases that each worker may run ahead of the first testcase
+ * whose outcome is not yet reported, when testcases run at the same time.
+ */
+constexpr std::size_t outcomes_per_job = 4;
+
+namespace {
+
+/**
+ * Buffers of the `OutputCapturer` started by the current thread, while an
+ * `OutputRouter` routes output of each thread separately.
+ */
+thread_local std::streambuf* routed_out = nullptr;
+thread_local std::streambuf* routed_err = nullptr;
+std::atomic<bool> routing(false);
+
+/**
+ * Calls a given function when it goes out of scope, unless dismissed
+ * beforehand.
+ */
+class ScopeExit {
+ public:
+  explicit ScopeExit(std::function<void()> func) : _func(std::move(func)) {}
+  ~ScopeExit() {
+    if (_func) {
+      _func();
+    }
+  }
+  void dismiss() { _func = nullptr; }
+
+ private:
+  ScopeExit(const ScopeExit&) = delete;
+  ScopeExit& operator=(const ScopeExit&) = delete;
+  std::function<void()> _func;
+};
+
+/**
+ * Makes a generator of the testcases of a given workflow, so that testcases
+ * of a workflow with a testcase source are pulled one at a time instead of
+ * being listed upfront. Testcases that are listed more than once are handed
+ * out once, since the results and the timing of a testcase are kept by its
+ * name. Skipped repeats are reported to a given logger, if any.
+ */
+TestcaseGenerator list_testcases(const Workflow& workflow,
+                                 const Logger* logger = nullptr) {
+  TestcaseGenerator generator;
+  if (workflow.testcase_source) {
+    generator = workflow.testcase_source();
+  } else {
+    const auto* testcases = &workflow.testcases;
+    std::size_t index = 0;
+    generator = [testcases, index](std::string& testcase) mutable {
+      if (index == testcases->size()) {
+        return false;
+      }
+      testcase = testcases->at(index++);
+      return true;
+    };
+  }
+  std::unordered_set<std::string> listed;
+  return [generator, logger, listed](std::string& testcase) mutable {
+    while (generator(testcase)) {
+      if (listed.insert(testcase).second) {
+        return true;
+      }
+      if (logger) {
+        logger->warn(touca::detail::format(
+            "skipped testcase {}: listed more than once", testcase));
+      }
+    }
+    return false;
+  };
+}
+
+/**
+ * Wraps a generator of testcases so that, by the time a testcase is handed
+ * out, the input of up to `count` testcases after it is scheduled to be
+ * loaded ahead of time.
+ */
+TestcaseGenerator prefetch_testcases(const TestcaseGenerator& generator,
+                                     Prefetcher& prefetcher,
+                                     const std::size_t count) {
+  std::deque<std::string> upcoming;
+  auto exhausted = false;
+  return [generator, &prefetcher, count, upcoming,
+          exhausted](std::string& testcase) mutable {
+    std::string next;
+    while (!exhausted && upcoming.size() <= count) {
+      exhausted = !generator(next);
+      if (!exhausted) {
+        prefetcher.schedule(next);
+        upcoming.push_back(next);
+      }
+    }
+    if (upcoming.empty()) {
+      return false;
+    }
+    testcase = std::move(upcoming.front());
+    upcoming.pop_front();
+    return true;
+  };
+}
+
+/**
+ * Reads durations of testcases in previous runs, in milliseconds, from a
+ * file with one line per testcase, made of the duration and the name of
+ * the testcase separated by a tab.
+ */
+std::unordered_map<std::string, long long> load_durations(
+    const touca::filesystem::path& path) {
+  std::unordered_map<std::string, long long> durations;
+  std::ifstream file(path.string());
+  std::string line;
+  while (std::getline(file, line)) {
+    const auto pos = line.find('\t');
+    if (pos == std::string::npos) {
+      continue;
+    }
+    try {
+      durations[line.substr(pos + 1)] = std::stoll(line.substr(0, pos));
+    } catch (const std::exception&) {
+      continue;
+    }
+  }
+  return durations;
+}
+
+void save_durations(
+    const touca::filesystem::path& path,
+    const std::unordered_map<std::string, long long>& durations) {
+  // write into a separate file first so that an interrupted run does not
+  // leave an incomplete file behind.
+  const auto& tmp_path = touca::filesystem::path(path.string() + ".tmp");
+  {
+    std::ofstream file(tmp_path.string(), std::ios::trunc);
+    for (const auto& kvp : durations) {
+      file << kvp.second << '\t' << kvp.first << '\n';
+    }
+  }
+  touca::filesystem::rename(tmp_path, path);
+}
+
+/**
+ * Orders testcases by their expected duration, longest first, if instructed
+ * to do so, and lists testcases that are not expected to fit in a given
+ * budget of milliseconds on a given number of workers. Testcases with no
+ * known duration are expected to take as long as an average testcase.
+ */
+std::unordered_set<std::string> schedule_testcases(
+    std::vector<std::string>& testcases,
+    const std::unordered_map<std::string, long long>& durations,
+    const bool longest_first, const long long budget,
+    const std::size_t jobs) {
+  long long known = 0;
+  long long count = 0;
+  for (const auto& testcase : testcases) {
+    const auto it = durations.find(testcase);
+    if (it != durations.end()) {
+      known += it->second;
+      ++count;
+    }
+  }
+  const auto average = count != 0 ? known / count : 0;
+  const auto expected = [&durations, average](const std::string& testcase) {
+    const auto it = durations.find(testcase);
+    return it != durations.end() ? it->second : average;
+  };
+
+  // to run as many testcases as possible, keep the shortest testcases
+  // until the budget of all workers is spent.
+  std::unordered_set<std::string> excluded;
+  if (budget != 0) {
+    std::vector<std::string> shortest(testcases);
+    std::stable_sort(shortest.begin(), shortest.end(),
+                     [&expected](const std::string& a, const std::string& b) {
+                       return expected(a) < expected(b);
+                     });
+    const auto capacity = budget * static_cast<long long>(jobs);
+    long long total = 0;
+    for (const auto& testcase : shortest) {
+      total += expected(testcase);
+      if (capacity < total) {
+        excluded.insert(testcase);
+      }
+    }
+  }
+  if (longest_first) {
+    std::stable_sort(testcases.begin(), testcases.end(),
+                     [&expected](const std::string& a, const std::string& b) {
+                       return expected(b) < expected(a);
+                     });
+  }
+  return excluded;
+}
+
+/**
+ * 64-bit FNV-1a hash of the name of a given testcase. Unlike `std::hash`,
+ * its value is the same on every platform and in every run, so that
+ * separate machines agree on the shard of each testcase.
+ */
+std::uint64_t hash_testcase(const std::string& testcase) {
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (const auto ch : testcase) {
+    hash ^= static_cast<unsigned char>(ch);
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+/**
+ * Makes a copy of a given workflow limited to the testcases that belong to
+ * a given shard. Testcases pulled from a testcase source are filtered as
+ * they are pulled.
+ */
+Workflow select_shard(const Workflow& workflow, const unsigned index,
+                      const unsigned count) {
+  const auto in_shard = [index, count](const std::string& testcase) {
+    return hash_testcase(testcase) % count == index;
+  };
+  Workflow shard(workflow);
+  shard.testcases.clear();
+  std::copy_if(workflow.testcases.begin(), workflow.testcases.end(),
+               std::back_inserter(shard.testcases), in_shard);
+  if (workflow.testcase_source) {
+    const auto source = workflow.testcase_source;
+    shard.testcase_source = [source, in_shard]() -> TestcaseGenerator {
+      const auto generator = source();
+      return [generator, in_shard](std::string& testcase) {
+        while (generator(testcase)) {
+          if (in_shard(testcase)) {
+            return true;
+          }
+        }
+        return false;
+      };
+    };
+  }
+  return shard;
+}
+
+}  // namespace
+
 struct {
   RunnerOptions options;
   std::vector<std::pair<std::unique_ptr<Sink>, Sink::Level>> sinks;
 } _meta;
 
-OutputCapturer::OutputCapturer() {}
+/**
+ * Keeps captured content of a stream in memory or streams it into a file
+ * that is created when the first content is captured.
+ */
+struct OutputCapturer::Buffer : public std::streambuf {
+  Buffer(const std::size_t limit, const touca::filesystem::path& path)
+      : _limit(limit), _path(path) {}
+
+  /** Appends a note of how much content was discarded, if any. */
+  void finish() {
+    if (_discarded != 0) {
+      const auto& note = touca::detail::format(
+          "\n[{} more bytes of output were discarded]\n", _discarded);
+      _discarded = 0;
+      write(note.data(), note.size());
+    }
+    if (_file.is_open()) {
+      _file.close();
+    }
+  }
+
+  std::string str() const { return _content; }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+      return traits_type::not_eof(ch);
+    }
+    const auto c = traits_type::to_char_type(ch);
+    return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+  }
+
+  std::streamsize xsputn(const char* data, std::streamsize size) override {
+    auto count = static_cast<std::size_t>(size);
+    if (_limit != 0 && _size + count > _limit) {
+      _discarded += _size + count - _limit;
+      count = _limit - _size;
+    }
+    write(data, count);
+    _size += count;
+    return size;
+  }
+
+ private:
+  void write(const char* data, const std::size_t size) {
+    if (size == 0) {
+      return;
+    }
+    if (!_path.empty() && !_file.is_open()) {
+      _file.open(_path.string(), std::ios::binary | std::ios::trunc);
+      // if the file cannot be created, keep content in memory instead.
+      if (!_file) {
+        _path.clear();
+      }
+    }
+    if (_file.is_open()) {
+      _file.write(data, static_cast<std::streamsize>(size));
+    } else {
+      _content.append(data, size);
+    }
+  }
+
+  const std::size_t _limit;
+  touca::filesystem::path _path;
+  std::ofstream _file;
+  std::string _content;
+  std::size_t _size = 0;
+  std::size_t _discarded = 0;
+};
+
+#ifndef _WIN32
+
+/**
+ * Points file descriptors 1 and 2 to pipes, and drains the pipes on a
+ * separate thread so that the code under test never blocks on writing
+ * output, however much it prints.
+ */
+struct OutputCapturer::Redirect {
+  Redirect(Buffer& out, Buffer& err) {
+    flush_streams();
+    const std::array<Buffer*, 2> buffers = {{&out, &err}};
+    for (auto i = 0u; i < _channels.size(); ++i) {
+      std::array<int, 2> fds;
+      if (::pipe(fds.data()) == -1) {
+        restore(i);
+        throw touca::detail::runtime_error("failed to capture output");
+      }
+      _channels[i] = {static_cast<int>(i + 1), ::dup(i + 1), fds[0],
+                      buffers[i]};
+      ::dup2(fds[1], _channels[i].fd);
+      ::close(fds[1]);
+    }
+    _thread = std::thread(&Redirect::drain, this);
+  }
+
+  ~Redirect() {
+    flush_streams();
+    restore(_channels.size());
+    _thread.join();
+    for (const auto& channel : _channels) {
+      ::close(channel.pipe);
+    }
+  }
+
+ private:
+  struct Channel {
+    int fd;
+    int saved;
+    int pipe;
+    Buffer* buffer;
+  };
+
+  static void flush_streams() {
+    std::cout.flush();
+    std::cerr.flush();
+    std::fflush(stdout);
+    std::fflush(stderr);
+  }
+
+  /**
+   * Points the first given number of file descriptors back to where they
+   * pointed before, which closes the write end of their pipes.
+   */
+  void restore(const std::size_t count) {
+    for (auto i = 0u; i < count; ++i) {
+      ::dup2(_channels[i].saved, _channels[i].fd);
+      ::close(_channels[i].saved);
+    }
+  }
+
+  void drain() {
+    std::array<char, 4096> chunk;
+    std::vector<struct pollfd> fds;
+    for (const auto& channel : _channels) {
+      fds.push_back({channel.pipe, POLLIN, 0});
+    }
+    auto open = fds.size();
+    while (open != 0) {
+      if (::poll(fds.data(), fds.size(), -1) == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+        return;
+      }
+      for (auto i = 0u; i < fds.size(); ++i) {
+        if (fds[i].fd == -1 || fds[i].revents == 0) {
+          continue;
+        }
+        const auto count = ::read(fds[i].fd, chunk.data(), chunk.size());
+        if (count > 0) {
+          _channels[i].buffer->sputn(chunk.data(), count);
+        } else if (count == 0 || errno != EINTR) {
+          fds[i].fd = -1;
+          --open;
+        }
+      }
+    }
+  }
+
+  std::array<Channel, 2> _channels;
+  std::thread _thread;
+};
+
+#else
+
+struct OutputCapturer::Redirect {
+  Redirect(Buffer&, Buffer&) {
+    throw touca::detail::runtime_error(
+        "capturing output file descriptors is not supported on this "
+        "platform");
+  }
+};
+
+#endif
+
+OutputCapturer::OutputCapturer() : OutputCapturer(Options()) {}
+
+OutputCapturer::OutputCapturer(const Options& options) : _options(options) {}
 
 OutputCapturer::~OutputCapturer() {
   if (_capturing) {
@@ -41,26 +487,100 @@ OutputCapturer::~OutputCapturer() {
 }
 
 void OutputCapturer::start_capture() {
-  _buf_err.str("");
-  _buf_err.clear();
-  _err = std::cerr.rdbuf(_buf_err.rdbuf());
+  _buf_err = touca::detail::make_unique<Buffer>(_options.limit,
+                                                _options.err_file);
+  _buf_out = touca::detail::make_unique<Buffer>(_options.limit,
+                                                _options.out_file);
 
-  _buf_out.str("");
-  _buf_out.clear();
-  _out = std::cout.rdbuf(_buf_out.rdbuf());
+  _routed = false;
+  if (_options.descriptors) {
+    _redirect = touca::detail::make_unique<Redirect>(*_buf_out, *_buf_err);
+  } else if (routing) {
+    _routed = true;
+    routed_err = _buf_err.get();
+    routed_out = _buf_out.get();
+  } else {
+    _err = std::cerr.rdbuf(_buf_err.get());
+    _out = std::cout.rdbuf(_buf_out.get());
+  }
 
   _capturing = true;
 }
 
 void OutputCapturer::stop_capture() {
-  std::cerr.rdbuf(_err);
-  std::cout.rdbuf(_out);
+  if (_redirect) {
+    _redirect.reset();
+  } else if (_routed) {
+    routed_err = nullptr;
+    routed_out = nullptr;
+  } else {
+    std::cerr.rdbuf(_err);
+    std::cout.rdbuf(_out);
+  }
+  _buf_err->finish();
+  _buf_out->finish();
   _capturing = false;
 }
 
-std::string OutputCapturer::cerr() const { return _buf_err.str(); }
+std::string OutputCapturer::cerr() const {
+  return _buf_err ? _buf_err->str() : std::string();
+}
+
+std::string OutputCapturer::cout() const {
+  return _buf_out ? _buf_out->str() : std::string();
+}
+
+struct OutputRouter::Buffer : public std::streambuf {
+  Buffer(std::ostream& stream, std::streambuf* (*target)())
+      : _stream(stream), _target(target) {
+    _fallback = _stream.rdbuf(this);
+  }
 
-std::string OutputCapturer::cout() const { return _buf_out.str(); }
+  ~Buffer() { _stream.rdbuf(_fallback); }
+
+ protected:
+  int_type overflow(int_type ch) override {
+    if (traits_type::eq_int_type(ch, traits_type::eof())) {
+      return traits_type::not_eof(ch);
+    }
+    const auto c = traits_type::to_char_type(ch);
+    return xsputn(&c, 1) == 1 ? ch : traits_type::eof();
+  }
+
+  std::streamsize xsputn(const char* data, std::streamsize size) override {
+    const auto target = _target();
+    if (target) {
+      return target->sputn(data, size);
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _fallback->sputn(data, size);
+  }
+
+  int sync() override {
+    const auto target = _target();
+    if (target) {
+      return target->pubsync();
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _fallback->pubsync();
+  }
+
+ private:
+  std::ostream& _stream;
+  std::streambuf* (*_target)();
+  std::streambuf* _fallback;
+  std::mutex _mutex;
+};
+
+OutputRouter::OutputRouter()
+    : _out(touca::detail::make_unique<Buffer>(
+          std::cout, []() -> std::streambuf* { return routed_out; })),
+      _err(touca::detail::make_unique<Buffer>(
+          std::cerr, []() -> std::streambuf* { return routed_err; })) {
+  routing = true;
+}
+
+OutputRouter::~OutputRouter() { routing = false; }
 
 void Logger::debug(const std::string& msg) const {
   publish(Sink::Level::Debug, msg);
@@ -76,10 +596,12 @@ void Logger::error(const std::string& msg) const {
 }
 
 void Logger::add_sink(std::unique_ptr<Sink> sink, const Sink::Level level) {
+  std::lock_guard<std::mutex> lock(_mutex);
   _sinks.push_back(std::make_pair(std::move(sink), level));
 }
 
 void Logger::publish(const Sink::Level level, const std::string& msg) const {
+  std::lock_guard<std::mutex> lock(_mutex);
   for (const auto& kvp : _sinks) {
     if (kvp.second <= level) {
       kvp.first->log(level, msg);
@@ -153,19 +675,131 @@ unsigned long Statistics::count(Status value) const {
   return _v.count(value) ? _v.at(value) : 0u;
 }
 
+unsigned long Statistics::total() const {
+  unsigned long sum = 0u;
+  for (const auto& kvp : _v) {
+    sum += kvp.second;
+  }
+  return sum;
+}
+
 void Timer::tic(const std::string& key) {
+  std::lock_guard<std::mutex> lock(_mutex);
   _tics[key] = std::chrono::system_clock::now();
 }
 
 void Timer::toc(const std::string& key) {
+  std::lock_guard<std::mutex> lock(_mutex);
   _tocs[key] = std::chrono::system_clock::now();
 }
 
 long long Timer::count(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(_mutex);
   const auto& dur = _tocs.at(key) - _tics.at(key);
   return std::chrono::duration_cast<std::chrono::milliseconds>(dur).count();
 }
 
+void Timer::erase(const std::string& key) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  _tics.erase(key);
+  _tocs.erase(key);
+}
+
+ResultQueue::ResultQueue(const std::size_t capacity,
+                         const std::function<void(const Result&)> report)
+    : _capacity(std::max<std::size_t>(capacity, 1)), _report(report) {
+  _thread = std::thread(&ResultQueue::work, this);
+}
+
+ResultQueue::~ResultQueue() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+  }
+  _cv.notify_all();
+  _thread.join();
+}
+
+void ResultQueue::push(const Result& result, const Task& task) {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (_items.size() >= _capacity) {
+    if (_items.front().done) {
+      report_front(lock);
+    } else {
+      _cv.wait(lock);
+    }
+  }
+  _items.push_back(Item{result, task, false, false});
+  lock.unlock();
+  _cv.notify_all();
+}
+
+void ResultQueue::poll() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_items.empty() && _items.front().done) {
+    report_front(lock);
+  }
+}
+
+void ResultQueue::drain() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (!_items.empty()) {
+    if (_items.front().done) {
+      report_front(lock);
+    } else {
+      _cv.wait(lock);
+    }
+  }
+}
+
+void ResultQueue::report_front(std::unique_lock<std::mutex>& lock) {
+  const auto result = std::move(_items.front().result);
+  _items.pop_front();
+  lock.unlock();
+  _report(result);
+  lock.lock();
+}
+
+void ResultQueue::work() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    const auto it =
+        std::find_if(_items.begin(), _items.end(),
+                     [](const Item& item) { return !item.started; });
+    if (it == _items.end()) {
+      if (_stop) {
+        return;
+      }
+      _cv.wait(lock);
+      continue;
+    }
+    // items are only removed from the queue once they are done, and adding
+    // items to a deque keeps references to existing items valid.
+    auto& item = *it;
+    item.started = true;
+    auto status = item.result.status;
+    std::vector<std::string> errors;
+    lock.unlock();
+    if (item.task) {
+      try {
+        status = item.task();
+      } catch (const std::exception& ex) {
+        status = Status::Fail;
+        errors.emplace_back(ex.what());
+      } catch (...) {
+        status = Status::Fail;
+        errors.emplace_back("unknown exception");
+      }
+    }
+    lock.lock();
+    item.result.status = status;
+    item.result.errors.insert(item.result.errors.end(), errors.begin(),
+                              errors.end());
+    item.done = true;
+    _cv.notify_all();
+  }
+}
+
 void Printer::print_app_header() { print("\nTouca Test Runner\n"); }
 
 void Printer::print_app_footer() { print("\n✨   Ran all test suites.\n\n"); }
@@ -182,7 +816,8 @@ void Printer::print_error(const std::string& msg) {
 void Printer::print_progress(const unsigned index, const Status status,
                              const std::string& testcase, const Timer& timer,
                              const std::vector<std::string>& errors) {
-  const auto& row_pad = std::floor(std::log10(testcase_count)) + 1;
+  const auto& row_pad =
+      testcase_count ? std::floor(std::log10(testcase_count)) + 1 : 1;
   const auto& badge_color = fmt::bg(std::get<0>(_states.at(status)));
   const auto& badge_text = std::get<1>(_states.at(status));
 
@@ -208,7 +843,8 @@ void Printer::print_progress(const unsigned index, const Status status,
 
 void Printer::print_footer(const Statistics& stats, Timer& timer,
                            const Workflow workflow,
-                           const RunnerOptions& options) {
+                           const RunnerOptions& options,
+                           const long long worker_setup_duration) {
   const auto duration = timer.count("__workflow__") / 1000.0;
   const auto report = [&](const Status state, const fmt::terminal_color color,
                           const std::string& name) {
@@ -223,8 +859,19 @@ void Printer::print_footer(const Statistics& stats, Timer& timer,
   report(Status::Fail, fmt::terminal_color::red, "failed");
   report(Status::Pass, fmt::terminal_color::green, "perfect");
   report(Status::Diff, fmt::terminal_color::yellow, "different");
-  print("{} total\n", static_cast<unsigned int>(workflow.testcases.size()));
+  print("{} total\n", stats.total());
   print("Time:       {:.2f} s\n", duration);
+  if (workflow.setup || workflow.worker_setup) {
+    print("Setup:      {:.2f} s",
+          workflow.setup ? timer.count("__setup__") / 1000.0 : 0.0);
+    if (workflow.worker_setup) {
+      print(" (and {:.2f} s in workers)", worker_setup_duration / 1000.0);
+    }
+    print("\n");
+  }
+  if (workflow.teardown) {
+    print("Teardown:   {:.2f} s\n", timer.count("__teardown__") / 1000.0);
+  }
   if (!options.web_url.empty()) {
     print("Link:       {}/~/{}/{}/{}\n", options.web_url, options.team,
           workflow.suite, workflow.version);
@@ -245,6 +892,11 @@ void Runner::run_workflows() {
   printer.print_app_header();
   for (const auto& workflow : options.workflows) {
     try {
+      if (options.shard_count != 0) {
+        run_workflow(select_shard(workflow, options.shard_index,
+                                  options.shard_count));
+        continue;
+      }
       run_workflow(workflow);
     } catch (const std::exception& ex) {
       printer.print_error(
@@ -259,6 +911,16 @@ void Runner::run_workflow(const Workflow& workflow) {
   ClientOptions o(options);
   o.suite = workflow.suite;
   o.version = workflow.version;
+  // testcases that run at the same time are each declared on their own
+  // thread and should not affect one another.
+  const auto jobs =
+      workflow.testcase_source
+          ? touca::detail::thread_count(options.jobs)
+          : std::min(touca::detail::thread_count(options.jobs),
+                     workflow.testcases.size());
+  if (jobs > 1 && !options.isolate_testcases) {
+    o.concurrency = false;
+  }
   touca::detail::set_client_options(o);
 
   // always print warning and errors log events to console
@@ -270,6 +932,21 @@ void Runner::run_workflow(const Workflow& workflow) {
       workflow.version;
   touca::filesystem::create_directories(version_directory);
 
+  // if instructed to consolidate results, keep the results of all testcases
+  // in a single segment file instead of one directory per testcase.
+  store.reset();
+  if (options.consolidate_results) {
+    store = touca::detail::make_unique<ResultStore>(version_directory);
+  }
+
+  // if instructed to cache results, keep results of testcases of this suite
+  // in a separate store, across versions, keyed by their fingerprint.
+  cache.reset();
+  if (!options.cache_directory.empty() && workflow.fingerprint) {
+    cache = touca::detail::make_unique<ResultStore>(
+        touca::filesystem::path(options.cache_directory) / workflow.suite);
+  }
+
   // unless explicitly instructed not to do so, register a separate
   // file logger to write our events to a file in the output directory.
   if (!options.skip_logs) {
@@ -292,27 +969,420 @@ void Runner::run_workflow(const Workflow& workflow) {
         return std::max(sum, static_cast<unsigned int>(testcase.length()));
       });
 
+  // testcases pulled from a testcase source are not known upfront. their
+  // progress is reported without padding to the longest testcase name.
+  if (workflow.testcase_source) {
+    printer.testcase_count = 0;
+    printer.testcase_width = 0;
+  }
+
+  // unless testcases run in worker processes, which load the input of
+  // their own testcases, load the input of upcoming testcases ahead of
+  // time if instructed to do so.
+  prefetcher.reset();
+  if (workflow.loader && options.prefetch && !options.isolate_testcases) {
+    prefetcher = touca::detail::make_unique<Prefetcher>(
+        workflow.loader,
+        std::min<std::size_t>(options.prefetch,
+                              touca::detail::thread_count(0)),
+        std::size_t(options.prefetch_memory) * 1024 * 1024);
+  }
+
+  // if instructed to do so, order testcases by their duration in previous
+  // runs and leave out testcases that are not expected to fit in the time
+  // budget. testcases pulled from a testcase source are run in the order
+  // in which they are pulled.
+  const auto schedule = options.longest_first || options.time_budget != 0;
+  const auto& durations_file =
+      touca::filesystem::path(options.output_directory) / workflow.suite /
+      "touca.durations";
+  std::unordered_map<std::string, long long> durations;
+  const Workflow* scheduled = &workflow;
+  Workflow ordered;
+  excluded.clear();
+  if (schedule) {
+    durations = load_durations(durations_file);
+  }
+  if (schedule && !workflow.testcase_source) {
+    ordered = workflow;
+    excluded = schedule_testcases(ordered.testcases, durations,
+                                  options.longest_first,
+                                  options.time_budget * 1000LL, jobs);
+    scheduled = &ordered;
+  }
+
+  stats = Statistics();
+  reused.clear();
   printer.print_header(workflow.suite, workflow.version);
   timer.tic("__workflow__");
-  auto index = 0U;
-  for (const auto& testcase : workflow.testcases) {
-    run_testcase(workflow, testcase, index++);
+  // prepare resources shared by all testcases before any worker thread or
+  // process starts, so that worker processes start with a copy of them.
+  worker_setup_duration = 0;
+  if (workflow.setup) {
+    timer.tic("__setup__");
+    workflow.setup();
+    timer.toc("__setup__");
+    logger.info(touca::detail::format("ran workflow setup in {} ms",
+                                      timer.count("__setup__")));
+  }
+  // release resources prepared by setup even if running testcases fails.
+  // a failing teardown is then only logged, so that it does not hide the
+  // error that stopped the run.
+  ScopeExit teardown_on_error([this, &workflow]() {
+    if (!workflow.teardown) {
+      return;
+    }
+    try {
+      workflow.teardown();
+    } catch (const std::exception& ex) {
+      logger.error(
+          touca::detail::format("workflow teardown failed: {}", ex.what()));
+    } catch (...) {
+      logger.error("workflow teardown failed: unknown exception");
+    }
+  });
+  const auto& report = [this, schedule,
+                        &durations](const ResultQueue::Result& result) {
+    // testcases whose results are reused say nothing about how long they
+    // take to run and should not affect how testcases are scheduled.
+    const auto it = reused.find(result.testcase);
+    const auto executed = it == reused.end();
+    if (!executed) {
+      reused.erase(it);
+    }
+    stats.inc(result.status);
+    printer.print_progress(result.index, result.status, result.testcase,
+                           timer, result.errors);
+    if (result.status != Status::Skip) {
+      logger.info(
+          touca::detail::format("processed testcase: {}", result.testcase));
+      if (schedule && executed) {
+        durations[result.testcase] = timer.count(result.testcase);
+      }
+    }
+    // nothing reads the duration of a testcase once it is reported.
+    timer.erase(result.testcase);
+  };
+  ResultQueue results(result_queue_capacity, report);
+  deadline = options.time_budget != 0
+                 ? std::chrono::steady_clock::now() +
+                       std::chrono::seconds(options.time_budget)
+                 : std::chrono::steady_clock::time_point::max();
+  run_testcases(*scheduled, results, jobs);
+  prefetcher.reset();
+  results.drain();
+  if (schedule) {
+    save_durations(durations_file, durations);
+  }
+  if (options.shard_count != 0) {
+    const auto& shard_file =
+        version_directory / touca::detail::format("shard-{}-of-{}.bin",
+                                                  options.shard_index,
+                                                  options.shard_count);
+    // the result file of this shard is made of the results saved for each
+    // testcase, so that it includes testcases that were skipped since an
+    // earlier run of this shard, perhaps one that was interrupted, had
+    // already processed them.
+    const auto count = touca::detail::save_merged_testcases(
+        shard_file, [this, &workflow](MessagesMerger& merger) {
+          auto next_testcase = list_testcases(workflow);
+          std::string testcase;
+          while (next_testcase(testcase)) {
+            add_saved_results(merger, workflow, testcase);
+          }
+        });
+    logger.info(touca::detail::format("saved results of {} testcases to {}",
+                                      count, shard_file.string()));
+  }
+  if (workflow.worker_setup) {
+    logger.info(touca::detail::format("ran worker setup in {} ms",
+                                      worker_setup_duration.load()));
+  }
+  teardown_on_error.dismiss();
+  if (workflow.teardown) {
+    timer.tic("__teardown__");
+    workflow.teardown();
+    timer.toc("__teardown__");
+    logger.info(touca::detail::format("ran workflow teardown in {} ms",
+                                      timer.count("__teardown__")));
   }
   timer.toc("__workflow__");
-  printer.print_footer(stats, timer, workflow, options);
+  printer.print_footer(stats, timer, workflow, options,
+                       worker_setup_duration);
   if (!options.offline) {
     touca::seal();
   }
 }
 
-void Runner::run_testcase(const Workflow& workflow, const std::string& testcase,
-                          const unsigned index) {
-  std::vector<std::string> errors;
+void Runner::run_testcases(const Workflow& workflow, ResultQueue& results,
+                           const std::size_t jobs) {
+  if (options.isolate_testcases) {
+    run_isolated_testcases(workflow, results, jobs);
+    return;
+  }
+  auto next_testcase = list_testcases(workflow, &logger);
+  if (prefetcher) {
+    next_testcase =
+        prefetch_testcases(next_testcase, *prefetcher, options.prefetch);
+  }
+  if (jobs <= 1) {
+    std::string testcase;
+    if (!next_testcase(testcase)) {
+      return;
+    }
+    const auto& worker_error = setup_worker(workflow);
+    unsigned index = 0;
+    do {
+      hand_over(results,
+                run_testcase(workflow, testcase, index++, worker_error));
+    } while (next_testcase(testcase));
+    return;
+  }
+
+  // workers run testcases in any order but we hand over their outcomes in
+  // the order of testcases. to bound the number of outcomes waiting for a
+  // slow testcase, workers do not start testcases too far ahead of it.
+  // workers take turns pulling the next testcase, each reserving a slot
+  // for its outcome at the back of `outcomes`.
+  const auto window = jobs * outcomes_per_job;
+  std::deque<std::unique_ptr<Outcome>> outcomes;
+  std::size_t next = 0;
+  std::size_t handed = 0;
+  auto exhausted = false;
+  std::exception_ptr failure;
+  std::mutex mutex;
+  std::condition_variable cv;
+  const auto worker = [&]() {
+    const auto& worker_error = setup_worker(workflow);
+    std::string testcase;
+    while (true) {
+      std::size_t index;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return exhausted || next < handed + window; });
+        if (exhausted) {
+          return;
+        }
+        try {
+          exhausted = !next_testcase(testcase);
+        } catch (...) {
+          failure = std::current_exception();
+          exhausted = true;
+        }
+        if (exhausted) {
+          lock.unlock();
+          cv.notify_all();
+          return;
+        }
+        index = next++;
+        outcomes.emplace_back();
+      }
+      auto outcome = touca::detail::make_unique<Outcome>();
+      try {
+        *outcome = run_testcase(workflow, testcase,
+                                static_cast<unsigned>(index), worker_error);
+      } catch (const std::exception& ex) {
+        touca::detail::release_testcase(testcase);
+        outcome->result = {static_cast<unsigned>(index), testcase,
+                           Status::Fail, {ex.what()}};
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        outcomes.at(index - handed) = std::move(outcome);
+      }
+      cv.notify_all();
+    }
+  };
+
+  OutputRouter router;
+  std::vector<std::thread> pool;
+  pool.reserve(jobs);
+  for (std::size_t i = 0; i < jobs; ++i) {
+    pool.emplace_back(worker);
+  }
+  while (true) {
+    std::unique_ptr<Outcome> outcome;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      cv.wait(lock, [&]() {
+        return outcomes.empty() ? exhausted : outcomes.front() != nullptr;
+      });
+      if (outcomes.empty()) {
+        break;
+      }
+      outcome = std::move(outcomes.front());
+      outcomes.pop_front();
+      ++handed;
+    }
+    cv.notify_all();
+    hand_over(results, *outcome);
+  }
+  for (auto& thread : pool) {
+    thread.join();
+  }
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+}
+
+void Runner::run_isolated_testcases(const Workflow& workflow,
+                                    ResultQueue& results,
+                                    const std::size_t jobs) {
+  // each testcase runs in a worker process that sends back the captured
+  // output, test results in binary format, time spent in worker setup and
+  // errors of the testcase. worker processes are copies of this process
+  // made before worker setup, so they each run worker setup once.
+  auto worker_ready = false;
+  std::string worker_error;
+  const auto& handler = [&](const ProcessPool::Message& task) {
+    ProcessPool::Message reply = {{}, {}, {}, "0"};
+    if (!worker_ready) {
+      const auto before = worker_setup_duration.load();
+      worker_ready = true;
+      worker_error = setup_worker(workflow);
+      reply[3] = std::to_string(worker_setup_duration - before);
+    }
+    const auto& finished =
+        execute_testcase(workflow, task.at(0), task.at(1), worker_error);
+    reply[0] = finished->cout;
+    reply[1] = finished->cerr;
+    if (!finished->results.empty()) {
+      reply[2] = touca::detail::dump_testcases(finished->results,
+                                               DataFormat::FBS);
+    }
+    reply.insert(reply.end(), finished->errors.begin(),
+                 finished->errors.end());
+    return reply;
+  };
+  // a worker process only has a copy of the thread that starts it, so we
+  // wait for the result queue to save and submit pending results before
+  // each worker process is started. otherwise the worker process may get
+  // a copy of a lock that the background thread held at that point, such
+  // as the lock of the result store or of the logger.
+  ProcessPool pool(jobs, handler, options.testcases_per_process,
+                   [&results]() { results.drain(); });
+
+  // as when testcases run on multiple threads, we hand over outcomes in the
+  // order of testcases and do not start testcases too far ahead of the
+  // first testcase whose outcome is not yet handed over.
+  auto next_testcase = list_testcases(workflow, &logger);
+  const auto window = jobs * outcomes_per_job;
+  std::deque<std::unique_ptr<Outcome>> outcomes;
+  std::unordered_map<std::size_t, std::shared_ptr<FinishedTestcase>> running;
+  std::size_t next = 0;
+  std::size_t handed = 0;
+  auto exhausted = false;
+  std::string testcase;
+  while (!exhausted || !outcomes.empty()) {
+    while (!exhausted && outcomes.size() < window && pool.idle()) {
+      if (!next_testcase(testcase)) {
+        exhausted = true;
+        break;
+      }
+      const auto index = static_cast<unsigned>(next++);
+      const auto& case_directory = prepare_testcase(workflow, testcase);
+      if (case_directory.empty()) {
+        outcomes.emplace_back(touca::detail::make_unique<Outcome>(
+            Outcome{{index, testcase, Status::Skip, {}}, nullptr, false}));
+        continue;
+      }
+      const auto& cache_key = make_cache_key(workflow, testcase);
+      timer.tic(testcase);
+      const auto& cached =
+          find_cached_testcase(workflow, testcase, case_directory, cache_key);
+      if (cached) {
+        timer.toc(testcase);
+        outcomes.emplace_back(touca::detail::make_unique<Outcome>(
+            finish_testcase(index, cached)));
+        continue;
+      }
+      outcomes.emplace_back();
+      auto& finished = running[index];
+      finished = std::make_shared<FinishedTestcase>();
+      finished->testcase = testcase;
+      finished->directory = case_directory;
+      finished->cache_key = cache_key;
+      pool.submit(index, {testcase, case_directory.string()});
+    }
+    for (; !outcomes.empty() && outcomes.front(); ++handed) {
+      hand_over(results, *outcomes.front());
+      outcomes.pop_front();
+    }
+    if (!pool.busy()) {
+      continue;
+    }
+
+    const auto& reply = pool.receive();
+    const auto index = static_cast<unsigned>(reply.task);
+    auto finished = std::move(running.at(index));
+    running.erase(index);
+    timer.toc(finished->testcase);
+    if (!reply.error.empty()) {
+      finished->errors = {reply.error};
+    } else {
+      finished->cout = reply.message.at(0);
+      finished->cerr = reply.message.at(1);
+      worker_setup_duration += std::stoll(reply.message.at(3));
+      finished->errors.assign(reply.message.begin() + 4,
+                              reply.message.end());
+      try {
+        std::istringstream input(reply.message.at(2));
+        touca::for_each_testcase(input, [&finished](const Testcase& item) {
+          finished->results.push_back(item);
+        });
+      } catch (const std::exception& ex) {
+        finished->errors.emplace_back(ex.what());
+      }
+    }
+    outcomes.at(index - handed) =
+        touca::detail::make_unique<Outcome>(finish_testcase(index, finished));
+  }
+}
+
+Runner::Outcome Runner::run_testcase(const Workflow& workflow,
+                                     const std::string& testcase,
+                                     const unsigned index,
+                                     const std::string& worker_error) {
+  const auto& case_directory = prepare_testcase(workflow, testcase);
+  if (case_directory.empty()) {
+    if (prefetcher) {
+      prefetcher->discard(testcase);
+    }
+    return {{index, testcase, Status::Skip, {}}, nullptr, false};
+  }
+  const auto& cache_key = make_cache_key(workflow, testcase);
+  timer.tic(testcase);
+  auto finished =
+      find_cached_testcase(workflow, testcase, case_directory, cache_key);
+  if (finished) {
+    if (prefetcher) {
+      prefetcher->discard(testcase);
+    }
+  } else {
+    finished =
+        execute_testcase(workflow, testcase, case_directory, worker_error);
+    finished->cache_key = cache_key;
+  }
+  timer.toc(testcase);
+  return finish_testcase(index, finished);
+}
+
+touca::filesystem::path Runner::prepare_testcase(const Workflow& workflow,
+                                                 const std::string& testcase) {
   auto case_directory = touca::filesystem::path(options.output_directory) /
                         workflow.suite / workflow.version / testcase;
 
+  if (excluded.count(testcase) ||
+      deadline <= std::chrono::steady_clock::now()) {
+    logger.info(touca::detail::format(
+        "skipping testcase to stay within time budget: {}", testcase));
+    return {};
+  }
+
   // unless `overwrite` is specified, check whether to skip this testcase.
   if (options.overwrite_results ? false
+      : store && (options.save_binary || options.save_json)
+          ? store->contains(testcase, options.save_binary)
       : options.save_binary
           ? touca::filesystem::exists(case_directory / "touca.bin")
       : options.save_json
@@ -320,77 +1390,274 @@ void Runner::run_testcase(const Workflow& workflow, const std::string& testcase,
           : false) {
     logger.info(
         touca::detail::format("skipping processed testcase: {}", testcase));
-    stats.inc(Status::Skip);
-    printer.print_progress(index, Status::Skip, testcase, timer);
-    return;
+    return {};
   }
 
-  touca::declare_testcase(testcase);
-
   // remove result directory for this testcase if it already exists.
   // since subsequent operations may expect to write into this directory,
   // we wait a few milliseconds to ensure it is entirely removed from disk.
-  if (touca::filesystem::exists(case_directory.string())) {
-    touca::filesystem::remove_all(case_directory);
-    logger.debug(
-        touca::detail::format("removed result directory for {}", testcase));
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  // consolidated results need no such cleanup: a new record in the store
+  // supersedes any previous record of the same testcase.
+  if (!store) {
+    if (touca::filesystem::exists(case_directory.string())) {
+      touca::filesystem::remove_all(case_directory);
+      logger.debug(
+          touca::detail::format("removed result directory for {}", testcase));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    touca::filesystem::create_directories(case_directory);
   }
-  touca::filesystem::create_directories(case_directory);
 
   logger.info(touca::detail::format("processing testcase: {}", testcase));
-  timer.tic(testcase);
-  OutputCapturer capturer;
+  return case_directory;
+}
+
+std::string Runner::make_cache_key(const Workflow& workflow,
+                                   const std::string& testcase) const {
+  if (!cache) {
+    return {};
+  }
+  try {
+    const auto& fingerprint = workflow.fingerprint(testcase);
+    const auto& code_version =
+        options.code_version.empty() ? workflow.version : options.code_version;
+    return touca::detail::format("{}\n{}\n{}", code_version, testcase,
+                                 fingerprint);
+  } catch (const std::exception& ex) {
+    logger.warn(touca::detail::format(
+        "failed to compute fingerprint of testcase {}: {}", testcase,
+        ex.what()));
+  }
+  return {};
+}
+
+std::shared_ptr<Runner::FinishedTestcase> Runner::find_cached_testcase(
+    const Workflow& workflow, const std::string& testcase,
+    const touca::filesystem::path& directory, const std::string& key) const {
+  if (key.empty() || !cache->contains(key, true)) {
+    return nullptr;
+  }
+  const auto finished = std::make_shared<FinishedTestcase>();
+  finished->testcase = testcase;
+  finished->directory = directory;
+  finished->reused = true;
+  try {
+    const auto& record = cache->read(key);
+    // kept results are labeled with the version that produced them and
+    // should be labeled with the version that reuses them instead.
+    const auto& metadata =
+        Testcase(options.team, workflow.suite, workflow.version, testcase)
+            .metadata();
+    std::istringstream input(record.binary);
+    touca::for_each_testcase(
+        input, [&finished, &metadata](const Testcase& item) {
+          finished->results.push_back(item);
+          finished->results.back().setMetadata(metadata);
+        });
+    finished->cout = record.cout;
+    finished->cerr = record.cerr;
+  } catch (const std::exception& ex) {
+    logger.warn(touca::detail::format(
+        "failed to reuse kept results of testcase {}: {}", testcase,
+        ex.what()));
+    return nullptr;
+  }
+  logger.info(
+      touca::detail::format("reusing kept results of testcase: {}", testcase));
+  return finished;
+}
+
+std::string Runner::setup_worker(const Workflow& workflow) {
+  if (!workflow.worker_setup) {
+    return {};
+  }
+  std::string error;
+  const auto& tic = std::chrono::steady_clock::now();
+  try {
+    workflow.worker_setup();
+  } catch (const std::exception& ex) {
+    error = ex.what();
+  } catch (...) {
+    error = "unknown exception";
+  }
+  const auto& duration = std::chrono::steady_clock::now() - tic;
+  worker_setup_duration +=
+      std::chrono::duration_cast<std::chrono::milliseconds>(duration).count();
+  if (!error.empty()) {
+    return touca::detail::format("worker setup failed: {}", error);
+  }
+  return {};
+}
+
+std::shared_ptr<Runner::FinishedTestcase> Runner::execute_testcase(
+    const Workflow& workflow, const std::string& testcase,
+    const touca::filesystem::path& directory,
+    const std::string& worker_error) const {
+  const auto finished = std::make_shared<FinishedTestcase>();
+  finished->testcase = testcase;
+  finished->directory = directory;
+  touca::declare_testcase(testcase);
+
+  // unless results are consolidated, stream captured output directly into
+  // the result directory of this testcase instead of keeping it in memory.
+  OutputCapturer::Options capture;
+  capture.descriptors = options.capture_descriptors;
+  capture.limit = options.output_limit;
+  if (!store) {
+    capture.out_file = directory / "stdout.txt";
+    capture.err_file = directory / "stderr.txt";
+  }
+  OutputCapturer capturer(capture);
   if (options.redirect_output) {
     capturer.start_capture();
   }
 
   try {
-    workflow.callback(testcase);
+    if (!worker_error.empty()) {
+      if (prefetcher) {
+        prefetcher->discard(testcase);
+      }
+      finished->errors = {worker_error};
+    } else if (workflow.loader) {
+      auto input = prefetcher ? prefetcher->take(testcase)
+                              : workflow.loader(testcase);
+      if (workflow.input_callback) {
+        workflow.input_callback(testcase, input);
+      } else {
+        workflow.callback(testcase);
+      }
+    } else {
+      workflow.callback(testcase);
+    }
   } catch (const std::exception& ex) {
-    errors = {ex.what()};
+    finished->errors = {ex.what()};
   } catch (...) {
-    errors = {"unknown exception"};
+    finished->errors = {"unknown exception"};
   }
 
   if (options.redirect_output) {
     capturer.stop_capture();
   }
-  timer.toc(testcase);
-  Status status = errors.empty() ? Status::Sent : Status::Fail;
 
-  if (!capturer.cerr().empty()) {
-    const auto resultFile = case_directory / "stderr.txt";
-    touca::detail::save_text_file(resultFile.string(), capturer.cerr());
+  const auto released = touca::detail::release_testcase(testcase);
+  if (released) {
+    finished->results.push_back(std::move(*released));
   }
-  if (!capturer.cout().empty()) {
-    const auto resultFile = case_directory / "stdout.txt";
-    touca::detail::save_text_file(resultFile.string(), capturer.cout());
+  finished->cout = capturer.cout();
+  finished->cerr = capturer.cerr();
+  return finished;
+}
+
+Runner::Outcome Runner::finish_testcase(
+    const unsigned index, const std::shared_ptr<FinishedTestcase>& finished) {
+  // hand over the results of this testcase to be saved and submitted in
+  // the background while we run the next testcase.
+  return {{index, finished->testcase, Status::Fail, finished->errors},
+          [this, finished]() { return save_testcase(*finished); },
+          finished->reused};
+}
+
+void Runner::hand_over(ResultQueue& results, const Outcome& outcome) {
+  results.poll();
+  if (outcome.reused) {
+    reused.insert(outcome.result.testcase);
   }
-  if (errors.empty() && options.save_binary) {
-    const auto resultFile = case_directory / "touca.bin";
-    touca::save_binary(resultFile.string(), {testcase});
+  results.push(outcome.result, outcome.task);
+}
+
+Status Runner::save_testcase(const FinishedTestcase& finished) {
+  const auto& testcases = finished.results;
+  if (store) {
+    ResultRecord record;
+    record.cout = finished.cout;
+    record.cerr = finished.cerr;
+    if (finished.errors.empty() && options.save_binary) {
+      record.binary = touca::detail::dump_testcases(testcases, DataFormat::FBS);
+    }
+    if (finished.errors.empty() && options.save_json) {
+      record.json = touca::detail::dump_testcases(testcases, DataFormat::JSON);
+    }
+    store->append(finished.testcase, record);
+  } else {
+    if (!finished.cerr.empty()) {
+      const auto resultFile = finished.directory / "stderr.txt";
+      touca::detail::save_text_file(resultFile.string(), finished.cerr);
+    }
+    if (!finished.cout.empty()) {
+      const auto resultFile = finished.directory / "stdout.txt";
+      touca::detail::save_text_file(resultFile.string(), finished.cout);
+    }
+    if (finished.errors.empty() && options.save_binary) {
+      const auto resultFile = finished.directory / "touca.bin";
+      touca::detail::save_testcases(resultFile, testcases, DataFormat::FBS);
+    }
+    if (finished.errors.empty() && options.save_json) {
+      const auto resultFile = finished.directory / "touca.json";
+      touca::detail::save_testcases(resultFile, testcases, DataFormat::JSON);
+    }
   }
-  if (errors.empty() && options.save_json) {
-    const auto resultFile = case_directory / "touca.json";
-    touca::save_json(resultFile.string(), {testcase});
+  if (!finished.errors.empty()) {
+    return Status::Fail;
   }
-  if (errors.empty() && !options.offline) {
+  if (cache && !finished.cache_key.empty()) {
+    keep_testcase(finished);
+  }
+  if (!options.offline) {
     Post::Options opts;
     opts.submit_async = options.submit_async;
-    status = touca::post(opts);
+    return touca::detail::submit_testcases(testcases, opts);
+  }
+  return Status::Sent;
+}
+
+void Runner::add_saved_results(MessagesMerger& merger,
+                               const Workflow& workflow,
+                               const std::string& testcase) const {
+  if (store) {
+    if (store->contains(testcase, true)) {
+      const auto& binary = store->read(testcase).binary;
+      merger.add(reinterpret_cast<const std::uint8_t*>(binary.data()),
+                 binary.size());
+    }
+    return;
+  }
+  const auto& path = touca::filesystem::path(options.output_directory) /
+                     workflow.suite / workflow.version / testcase /
+                     "touca.bin";
+  if (touca::filesystem::exists(path)) {
+    const MappedFile file(path.string());
+    merger.add(file.data(), file.size());
   }
+}
 
-  stats.inc(status);
-  printer.print_progress(index, status, testcase, timer, errors);
-  touca::forget_testcase(testcase);
-  logger.info(touca::detail::format("processed testcase: {}", testcase));
+void Runner::keep_testcase(const FinishedTestcase& finished) const {
+  ResultRecord record;
+  record.binary =
+      touca::detail::dump_testcases(finished.results, DataFormat::FBS);
+  record.cout = finished.cout;
+  record.cerr = finished.cerr;
+  // unless results are consolidated, captured output is not kept in memory.
+  if (!store) {
+    const auto& out_file = finished.directory / "stdout.txt";
+    const auto& err_file = finished.directory / "stderr.txt";
+    if (record.cout.empty() && touca::filesystem::exists(out_file)) {
+      record.cout = touca::detail::load_text_file(out_file.string());
+    }
+    if (record.cerr.empty() && touca::filesystem::exists(err_file)) {
+      record.cerr = touca::detail::load_text_file(err_file.string());
+    }
+  }
+  cache->append(finished.cache_key, record);
 }
 
 void reset_test_runner() {
   _meta.options = RunnerOptions();
   _meta.sinks.clear();
 }
+
+void add_workflow(const Workflow& workflow) {
+  _meta.options.workflows.push_back(workflow);
+}
 }  // namespace detail
 
 void configure_runner(
@@ -409,7 +1676,7 @@ void workflow(const std::string& name,
   if (options_callback) {
     options_callback(workflow);
   }
-  touca::detail::_meta.options.workflows.push_back(workflow);
+  touca::detail::add_workflow(workflow);
 }
 
 void add_sink(std::unique_ptr<Sink> sink, const Sink::Level level) {
@@ -0,0 +1,281 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/runner/detail/store.hpp"
+
+#include <array>
+
+#include "touca/core/config.hpp"
+
+namespace touca {
+namespace detail {
+
+namespace {
+
+/**
+ * Identifies segment files and the revision of their layout. Records
+ * follow this header, each made of the size of the testcase name, a
+ * bitmask of the fields present in the record, the testcase name and
+ * the size and content of each present field.
+ */
+constexpr std::array<char, 8> segment_header = {'T', 'S', 'E', 'G',
+                                                '\x01', 0, 0, 0};
+
+constexpr std::uint32_t field_count = 4;
+
+enum Field : std::uint32_t {
+  Binary = 1u << 0,
+  Json = 1u << 1,
+  Cout = 1u << 2,
+  Cerr = 1u << 3
+};
+
+template <typename T>
+void put(std::string& out, const T value) {
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+template <typename T>
+bool get(std::istream& in, T& value) {
+  std::array<unsigned char, sizeof(T)> bytes;
+  if (!in.read(reinterpret_cast<char*>(bytes.data()), bytes.size())) {
+    return false;
+  }
+  value = 0;
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    value |= static_cast<T>(bytes[i]) << (8 * i);
+  }
+  return true;
+}
+
+std::array<const std::string*, field_count> list_fields(
+    const ResultRecord& record) {
+  return {{&record.binary, &record.json, &record.cout, &record.cerr}};
+}
+
+std::array<std::string*, field_count> list_fields(ResultRecord& record) {
+  return {{&record.binary, &record.json, &record.cout, &record.cerr}};
+}
+
+std::string encode_index_entry(const std::string& testcase,
+                               const std::uint64_t offset,
+                               const std::uint64_t size,
+                               const std::uint32_t fields) {
+  std::string out;
+  put<std::uint64_t>(out, offset);
+  put<std::uint64_t>(out, size);
+  put<std::uint32_t>(out, fields);
+  put<std::uint32_t>(out, static_cast<std::uint32_t>(testcase.size()));
+  out.append(testcase);
+  return out;
+}
+
+/**
+ * Reads the header of the record at the current position of the segment
+ * and skips over its fields. Returns false if the record is incomplete.
+ */
+bool skip_record(std::ifstream& in, const std::uint64_t segment_size,
+                 std::string& testcase, std::uint32_t& fields) {
+  std::uint32_t name_size = 0;
+  if (!get(in, name_size) || !get(in, fields)) {
+    return false;
+  }
+  testcase.resize(name_size);
+  if (!in.read(&testcase[0], name_size)) {
+    return false;
+  }
+  for (std::uint32_t i = 0; i < field_count; ++i) {
+    if (!(fields & (1u << i))) {
+      continue;
+    }
+    std::uint64_t size = 0;
+    if (!get(in, size)) {
+      return false;
+    }
+    const auto position = static_cast<std::uint64_t>(in.tellg());
+    if (segment_size - position < size) {
+      return false;
+    }
+    in.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+  }
+  return true;
+}
+
+}  // namespace
+
+ResultStore::ResultStore(const touca::filesystem::path& directory)
+    : _segment_path(directory / "touca.seg"),
+      _index_path(directory / "touca.idx") {
+  touca::filesystem::create_directories(directory);
+  if (!touca::filesystem::exists(_segment_path)) {
+    std::ofstream out(_segment_path.string(), std::ios::binary);
+    out.write(segment_header.data(), segment_header.size());
+    std::ofstream(_index_path.string(), std::ios::binary | std::ios::trunc);
+  }
+  load_index();
+  _segment.open(_segment_path.string(), std::ios::binary | std::ios::app);
+  _index.open(_index_path.string(), std::ios::binary | std::ios::app);
+  if (!_segment || !_index) {
+    throw touca::detail::runtime_error(touca::detail::format(
+        "failed to open result store in {}", directory.string()));
+  }
+}
+
+bool ResultStore::contains(const std::string& testcase,
+                           const bool binary) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  const auto it = _entries.find(testcase);
+  return it != _entries.end() &&
+         (it->second.fields & (binary ? Field::Binary : Field::Json));
+}
+
+void ResultStore::append(const std::string& testcase,
+                         const ResultRecord& record) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  std::string header;
+  std::uint32_t fields = 0;
+  const auto& values = list_fields(record);
+  for (std::uint32_t i = 0; i < field_count; ++i) {
+    if (!values[i]->empty()) {
+      fields |= 1u << i;
+    }
+  }
+  put<std::uint32_t>(header, static_cast<std::uint32_t>(testcase.size()));
+  put<std::uint32_t>(header, fields);
+  header.append(testcase);
+  _segment.write(header.data(), header.size());
+  std::uint64_t size = header.size();
+  for (std::uint32_t i = 0; i < field_count; ++i) {
+    if (!(fields & (1u << i))) {
+      continue;
+    }
+    std::string prefix;
+    put<std::uint64_t>(prefix, values[i]->size());
+    _segment.write(prefix.data(), prefix.size());
+    _segment.write(values[i]->data(), values[i]->size());
+    size += prefix.size() + values[i]->size();
+  }
+  if (!_segment.flush()) {
+    throw touca::detail::runtime_error(touca::detail::format(
+        "failed to write results of testcase {}", testcase));
+  }
+
+  const Entry entry{_segment_size, size, fields};
+  const auto& content =
+      encode_index_entry(testcase, entry.offset, entry.size, entry.fields);
+  _index.write(content.data(), content.size());
+  _index.flush();
+  _segment_size += size;
+  add_entry(testcase, entry);
+}
+
+ResultRecord ResultStore::read(const std::string& testcase) const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  const auto it = _entries.find(testcase);
+  if (it == _entries.end()) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("no results found for testcase {}", testcase));
+  }
+  std::ifstream in(_segment_path.string(), std::ios::binary);
+  in.seekg(static_cast<std::streamoff>(it->second.offset +
+                                       2 * sizeof(std::uint32_t) +
+                                       testcase.size()));
+  ResultRecord record;
+  const auto& values = list_fields(record);
+  for (std::uint32_t i = 0; i < field_count; ++i) {
+    if (!(it->second.fields & (1u << i))) {
+      continue;
+    }
+    std::uint64_t size = 0;
+    if (!get(in, size) || size > it->second.size) {
+      throw touca::detail::runtime_error(touca::detail::format(
+          "failed to read results of testcase {}", testcase));
+    }
+    values[i]->resize(static_cast<std::size_t>(size));
+    if (size != 0 &&
+        !in.read(&(*values[i])[0], static_cast<std::streamsize>(size))) {
+      throw touca::detail::runtime_error(touca::detail::format(
+          "failed to read results of testcase {}", testcase));
+    }
+  }
+  return record;
+}
+
+std::vector<std::string> ResultStore::testcases() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _order;
+}
+
+void ResultStore::load_index() {
+  const auto segment_size = static_cast<std::uint64_t>(
+      touca::filesystem::file_size(_segment_path));
+  std::ifstream segment(_segment_path.string(), std::ios::binary);
+  std::array<char, segment_header.size()> header;
+  if (!segment.read(header.data(), header.size()) || header != segment_header) {
+    throw touca::detail::runtime_error(touca::detail::format(
+        "file {} is not a result segment", _segment_path.string()));
+  }
+
+  // an index that ends exactly where the segment ends is trusted as is.
+  // anything else means a previous run was interrupted.
+  std::ifstream in(_index_path.string(), std::ios::binary);
+  std::uint64_t end = segment_header.size();
+  std::string testcase;
+  Entry entry;
+  std::uint32_t name_size = 0;
+  while (in && get(in, entry.offset)) {
+    if (!get(in, entry.size) || !get(in, entry.fields) ||
+        !get(in, name_size)) {
+      break;
+    }
+    testcase.resize(name_size);
+    if (!in.read(&testcase[0], name_size) || entry.offset != end) {
+      break;
+    }
+    end += entry.size;
+    add_entry(testcase, entry);
+  }
+  if (end == segment_size && in.eof()) {
+    _segment_size = segment_size;
+    return;
+  }
+  rebuild_index(segment_size);
+}
+
+void ResultStore::rebuild_index(const std::uint64_t segment_size) {
+  _entries.clear();
+  _order.clear();
+  std::ifstream in(_segment_path.string(), std::ios::binary);
+  in.seekg(segment_header.size());
+  std::uint64_t end = segment_header.size();
+  std::string testcase;
+  std::uint32_t fields = 0;
+  std::string content;
+  while (end < segment_size &&
+         skip_record(in, segment_size, testcase, fields)) {
+    const auto next = static_cast<std::uint64_t>(in.tellg());
+    const Entry entry{end, next - end, fields};
+    content.append(
+        encode_index_entry(testcase, entry.offset, entry.size, entry.fields));
+    add_entry(testcase, entry);
+    end = next;
+  }
+  in.close();
+  if (end != segment_size) {
+    touca::filesystem::resize_file(_segment_path, end);
+  }
+  std::ofstream out(_index_path.string(), std::ios::binary | std::ios::trunc);
+  out.write(content.data(), content.size());
+  _segment_size = end;
+}
+
+void ResultStore::add_entry(const std::string& testcase, const Entry& entry) {
+  if (_entries.count(testcase) == 0) {
+    _order.push_back(testcase);
+  }
+  _entries[testcase] = entry;
+}
+
+}  // namespace detail
+}  // namespace touca
@@ -0,0 +1,96 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/string_table.hpp"
+
+#include <utility>
+
+#include "flatbuffers/flatbuffers.h"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/types.hpp"
+#include "touca/impl/schema.hpp"
+
+namespace touca {
+namespace detail {
+
+bool StringPool::is_shareable(const std::string& value) {
+  return value.size() <= 64;
+}
+
+std::uint32_t StringPool::add(const std::string& value) {
+  const auto& it = _positions.find(value);
+  if (it != _positions.end()) {
+    return it->second;
+  }
+  if (_frozen) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("string \"{}\" is missing from pool", value));
+  }
+  const auto position = static_cast<std::uint32_t>(_strings.size());
+  _positions.emplace(value, position);
+  _strings.push_back(value);
+  return position;
+}
+
+std::uint32_t StringPool::add(const std::string& value,
+                              std::vector<std::uint32_t>* positions) {
+  const auto position = add(value);
+  if (positions) {
+    positions->push_back(position);
+  }
+  return position;
+}
+
+void StringPool::collect(const data_point& value,
+                         std::vector<std::uint32_t>* positions) {
+  switch (value.type()) {
+    case internal_type::string:
+      if (is_shareable(*value.as_string())) {
+        add(*value.as_string(), positions);
+      }
+      break;
+    case internal_type::array:
+      for (const auto& element : *value.as_array()) {
+        collect(element, positions);
+      }
+      break;
+    case internal_type::object: {
+      const auto& obj = detail::get<deep_copy_ptr<object>>(value._value);
+      for (const auto& member : *obj) {
+        collect(member.second, positions);
+        add(member.first, positions);
+      }
+      add(obj->get_name(), positions);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+StringTable::StringTable(std::vector<std::string> strings)
+    : _strings(std::move(strings)) {}
+
+StringTable::StringTable(const fbs::Messages* messages) {
+  if (!messages->strings()) {
+    return;
+  }
+  _strings.reserve(messages->strings()->size());
+  for (const auto&& value : *messages->strings()) {
+    _strings.emplace_back(value->str());
+  }
+}
+
+const char* StringTable::get(const flatbuffers::String* value,
+                             const std::uint32_t ref) const {
+  if (value) {
+    return value->c_str();
+  }
+  if (_strings.size() <= ref) {
+    throw touca::detail::runtime_error(
+        touca::detail::format("shared string {} not found", ref));
+  }
+  return _strings[ref].c_str();
+}
+
+}  // namespace detail
+}  // namespace touca
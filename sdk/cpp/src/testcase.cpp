@@ -2,17 +2,30 @@
 
 #include "touca/core/testcase.hpp"
 
+#include <utility>
+
 #include "flatbuffers/flatbuffers.h"
 #include "rapidjson/document.h"
 #include "rapidjson/rapidjson.h"
-#include "rapidjson/stringbuffer.h"
-#include "rapidjson/writer.h"
 #include "touca/core/filesystem.hpp"
+#include "touca/core/json_writer.hpp"
+#include "touca/core/string_table.hpp"
 #include "touca/core/types.hpp"
+#include "touca/core/writer.hpp"
 #include "touca/impl/schema.hpp"
 
 namespace touca {
 
+/**
+ * Serialized form of a testcase in one binary format, along with the
+ * positions of the shared strings that it refers to, which depend on the
+ * other testcases that it was serialized with.
+ */
+struct Testcase::Encoding {
+  std::vector<std::uint32_t> positions;
+  std::vector<std::uint8_t> bytes;
+};
+
 /**
  * Add an ISO 8601 timestamp that shows the time of creation of this testcase.
  * We use UTC time instead of local time to ensure that the times are correctly
@@ -65,7 +78,15 @@ rapidjson::Value Testcase::Overview::json(
 
 Testcase::Metadata Testcase::metadata() const { return _metadata; }
 
-void Testcase::setMetadata(const Metadata& metadata) { _metadata = metadata; }
+void Testcase::setMetadata(const Metadata& metadata) {
+  _metadata = metadata;
+  _encodings.fill(nullptr);
+}
+
+void Testcase::changed() {
+  _posted = false;
+  _encodings.fill(nullptr);
+}
 
 std::string Testcase::Metadata::describe() const {
   return touca::detail::format("{}/{}/{}/{}", teamslug, testsuite, version,
@@ -85,7 +106,7 @@ rapidjson::Value Testcase::Metadata::json(
 
 void Testcase::tic(const std::string& key) {
   _tics.emplace(key, std::chrono::system_clock::now());
-  _posted = false;
+  changed();
 }
 
 void Testcase::toc(const std::string& key) {
@@ -94,17 +115,17 @@ void Testcase::toc(const std::string& key) {
         "timer was never started for the given key");
   }
   _tocs[key] = std::chrono::system_clock::now();
-  _posted = false;
+  changed();
 }
 
 void Testcase::check(const std::string& key, const data_point& value) {
   _resultsMap.emplace(key, ResultEntry{value, ResultCategory::Check});
-  _posted = false;
+  changed();
 }
 
 void Testcase::assume(const std::string& key, const data_point& value) {
   _resultsMap.emplace(key, ResultEntry{value, ResultCategory::Assert});
-  _posted = false;
+  changed();
 }
 
 void Testcase::add_array_element(const std::string& key,
@@ -112,6 +133,7 @@ void Testcase::add_array_element(const std::string& key,
   if (!_resultsMap.count(key)) {
     _resultsMap.emplace(key,
                         ResultEntry{array().add(value), ResultCategory::Check});
+    changed();
     return;
   }
   auto& ivalue = _resultsMap.at(key);
@@ -119,13 +141,14 @@ void Testcase::add_array_element(const std::string& key,
     throw touca::detail::runtime_error("specified key has a different type");
   }
   ivalue.val.as_array()->push_back(value);
-  _posted = false;
+  changed();
 }
 
 void Testcase::add_hit_count(const std::string& key) {
   if (!_resultsMap.count(key)) {
     _resultsMap.emplace(key, ResultEntry{data_point::number_unsigned(1U),
                                          ResultCategory::Check});
+    changed();
     return;
   }
   auto& ivalue = _resultsMap.at(key);
@@ -133,7 +156,7 @@ void Testcase::add_hit_count(const std::string& key) {
     throw touca::detail::runtime_error("specified key has a different type");
   }
   ivalue.val.increment();
-  _posted = false;
+  changed();
 }
 
 void Testcase::add_metric(const std::string& key, const unsigned duration) {
@@ -142,7 +165,7 @@ void Testcase::add_metric(const std::string& key, const unsigned duration) {
   const auto& toc = chr::system_clock::time_point(chr::milliseconds(duration));
   _tics.emplace(key, tic);
   _tocs.emplace(key, toc);
-  _posted = false;
+  changed();
 }
 
 MetricsMap Testcase::metrics() const {
@@ -173,7 +196,8 @@ rapidjson::Value Testcase::json(
     }
     rapidjson::Value rjEntry(rapidjson::kObjectType);
     rjEntry.AddMember("key", entry.first, allocator);
-    rjEntry.AddMember("value", entry.second.val.to_string(), allocator);
+    rjEntry.AddMember("value", to_json(entry.second.val, allocator),
+                      allocator);
     rjResults.PushBack(rjEntry, allocator);
   }
   out.AddMember("results", rjResults, allocator);
@@ -185,7 +209,8 @@ rapidjson::Value Testcase::json(
     }
     rapidjson::Value rjEntry(rapidjson::kObjectType);
     rjEntry.AddMember("key", entry.first, allocator);
-    rjEntry.AddMember("value", entry.second.val.to_string(), allocator);
+    rjEntry.AddMember("value", to_json(entry.second.val, allocator),
+                      allocator);
     rjAssertions.PushBack(rjEntry, allocator);
   }
   out.AddMember("assertion", rjAssertions, allocator);
@@ -194,7 +219,8 @@ rapidjson::Value Testcase::json(
   for (const auto& entry : metrics()) {
     rapidjson::Value rjEntry(rapidjson::kObjectType);
     rjEntry.AddMember("key", entry.first, allocator);
-    rjEntry.AddMember("value", entry.second.value.to_string(), allocator);
+    rjEntry.AddMember("value", to_json(entry.second.value, allocator),
+                      allocator);
     rjMetrics.PushBack(rjEntry, allocator);
   }
   out.AddMember("metrics", rjMetrics, allocator);
@@ -202,8 +228,17 @@ rapidjson::Value Testcase::json(
   return out;
 }
 
-std::vector<uint8_t> Testcase::flatbuffers() const {
+std::vector<uint8_t> Testcase::flatbuffers(touca::detail::StringPool* strings,
+                                           const bool compact) const {
   flatbuffers::FlatBufferBuilder builder;
+  flatbuffers(builder, strings, compact);
+  const auto& ptr = builder.GetBufferPointer();
+  return {ptr, ptr + builder.GetSize()};
+}
+
+void Testcase::flatbuffers(flatbuffers::FlatBufferBuilder& builder,
+                           touca::detail::StringPool* strings,
+                           const bool compact) const {
   const auto& fbsMetadata = fbs::CreateMetadataDirect(
       builder, _metadata.testsuite.c_str(), _metadata.version.c_str(),
       _metadata.testcase.c_str(), _metadata.builtAt.c_str(),
@@ -214,11 +249,14 @@ std::vector<uint8_t> Testcase::flatbuffers() const {
   std::vector<flatbuffers::Offset<fbs::Result>> fbsResultEntries;
   for (const auto& result : _resultsMap) {
     const auto& key = result.first.c_str();
-    const auto& value = result.second.val.serialize(builder);
+    const auto& value = result.second.val.serialize(builder, strings, compact);
     const auto& type = result.second.typ == ResultCategory::Assert
                            ? fbs::ResultType::Assert
                            : fbs::ResultType::Check;
-    const auto& entry = fbs::CreateResultDirect(builder, key, value, type);
+    const auto& entry =
+        strings ? fbs::CreateResult(builder, 0, value, type,
+                                    strings->add(result.first))
+                : fbs::CreateResultDirect(builder, key, value, type);
     fbsResultEntries.push_back(entry);
   }
   const auto& fbsResults = fbs::CreateResultsDirect(builder, &fbsResultEntries);
@@ -228,8 +266,12 @@ std::vector<uint8_t> Testcase::flatbuffers() const {
   std::vector<flatbuffers::Offset<fbs::Metric>> fbsMetricEntries;
   for (const auto& metric : metrics()) {
     const auto& key = metric.first.c_str();
-    const auto& value = metric.second.value.serialize(builder);
-    const auto& entry = fbs::CreateMetricDirect(builder, key, value);
+    const auto& value =
+        metric.second.value.serialize(builder, nullptr, compact);
+    const auto& entry =
+        strings ? fbs::CreateMetric(builder, 0, value,
+                                    strings->add(metric.first))
+                : fbs::CreateMetricDirect(builder, key, value);
     fbsMetricEntries.push_back(entry);
   }
   const auto& fbsMetrics = fbs::CreateMetricsDirect(builder, &fbsMetricEntries);
@@ -243,9 +285,43 @@ std::vector<uint8_t> Testcase::flatbuffers() const {
   const auto& message = fbsMessage_builder.Finish();
 
   builder.Finish(message);
+}
 
+void Testcase::collect_strings(touca::detail::StringPool& strings,
+                               std::vector<std::uint32_t>* positions) const {
+  for (const auto& result : _resultsMap) {
+    strings.collect(result.second.val, positions);
+    strings.add(result.first, positions);
+  }
+  for (const auto& metric : metrics()) {
+    strings.add(metric.first, positions);
+  }
+}
+
+const std::vector<std::uint8_t>& Testcase::encode(
+    flatbuffers::FlatBufferBuilder& builder, const BinaryFormat format,
+    touca::detail::StringPool* strings) const {
+  if (format == BinaryFormat::V1) {
+    strings = nullptr;
+  } else if (!strings) {
+    throw touca::detail::runtime_error(
+        "binary format requires a pool of shared strings");
+  }
+  std::vector<std::uint32_t> positions;
+  if (strings) {
+    collect_strings(*strings, &positions);
+  }
+  auto& encoding = _encodings.at(static_cast<std::size_t>(format) - 1);
+  if (encoding && encoding->positions == positions) {
+    return encoding->bytes;
+  }
+  flatbuffers(builder, strings, format == BinaryFormat::V3);
   const auto& ptr = builder.GetBufferPointer();
-  return {ptr, ptr + builder.GetSize()};
+  auto fresh = std::make_shared<Encoding>();
+  fresh->positions = std::move(positions);
+  fresh->bytes.assign(ptr, ptr + builder.GetSize());
+  encoding = std::move(fresh);
+  return encoding->bytes;
 }
 
 Testcase::Overview Testcase::overview() const {
@@ -266,37 +342,28 @@ Testcase::Overview Testcase::overview() const {
 }
 
 void Testcase::clear() {
-  _posted = false;
+  changed();
   _resultsMap.clear();
   _tics.clear();
   _tocs.clear();
 }
 
 std::vector<uint8_t> Testcase::serialize(
-    const std::vector<Testcase>& testcases) {
-  flatbuffers::FlatBufferBuilder builder;
-  std::vector<flatbuffers::Offset<fbs::MessageBuffer>> messageBuffers;
-  for (const auto& tc : testcases) {
-    const auto& out = tc.flatbuffers();
-    messageBuffers.push_back(fbs::CreateMessageBufferDirect(builder, &out));
-  }
-  const auto& messages = fbs::CreateMessagesDirect(builder, &messageBuffers);
-  builder.Finish(messages);
-  const auto& ptr = builder.GetBufferPointer();
-  return {ptr, ptr + builder.GetSize()};
+    const std::vector<Testcase>& testcases, const BinaryFormat format,
+    const std::size_t concurrency) {
+  touca::detail::MessagesWriter writer;
+  writer.write(testcases, format, concurrency);
+  return {writer.data(), writer.data() + writer.size()};
 }
 
 std::string elements_map_to_json(const ElementsMap& elements_map) {
-  rapidjson::Document doc(rapidjson::kArrayType);
-  rapidjson::Document::AllocatorType& allocator = doc.GetAllocator();
+  std::string output;
+  touca::detail::JsonWriter writer(output);
   for (const auto& item : elements_map) {
-    doc.PushBack(item.second->json(allocator), allocator);
+    writer.write(*item.second);
   }
-  rapidjson::StringBuffer strbuf;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(strbuf);
-  writer.SetMaxDecimalPlaces(3);
-  doc.Accept(writer);
-  return strbuf.GetString();
+  writer.finish();
+  return output;
 }
 
 }  // namespace touca
@@ -87,5 +87,31 @@ void set_client_options(const ClientOptions& options) {
 const std::unique_ptr<Transport>& get_client_transport() {
   return instance.get_client_transport();
 }
+/** see ClientImpl::release_testcase */
+std::shared_ptr<Testcase> release_testcase(const std::string& name) {
+  return instance.release_testcase(name);
+}
+/** see ClientImpl::save */
+void save_testcases(const touca::filesystem::path& path,
+                    const std::vector<Testcase>& testcases,
+                    const DataFormat format) {
+  instance.save(path, testcases, format);
+}
+/** see ClientImpl::dump */
+std::string dump_testcases(const std::vector<Testcase>& testcases,
+                           const DataFormat format) {
+  return instance.dump(testcases, format);
+}
+/** see ClientImpl::save_merged */
+std::size_t save_merged_testcases(
+    const touca::filesystem::path& path,
+    const std::function<void(touca::detail::MessagesMerger&)>& add) {
+  return instance.save_merged(path, add);
+}
+/** see ClientImpl::submit */
+Post::Status submit_testcases(const std::vector<Testcase>& testcases,
+                              const Post::Options& options) {
+  return instance.submit(testcases, options);
+}
 }  // namespace detail
 }  // namespace touca
@@ -72,14 +72,16 @@ Response DefaultTransport::post(const std::string& route,
 }
 
 Response DefaultTransport::binary(const std::string& route,
-                                  const std::string& content,
+                                  const std::uint8_t* content,
+                                  const std::size_t size,
                                   const Transport::Headers& headers) const {
   httplib::Headers extra;
   for (const auto& header : headers) {
     extra.emplace(header);
   }
-  const auto& result = _cli->Post(_api_url.route(route).c_str(), extra, content,
-                                  "application/octet-stream");
+  const auto& result = _cli->Post(
+      _api_url.route(route).c_str(), extra,
+      reinterpret_cast<const char*>(content), size, "application/octet-stream");
   if (!result) {
     return {-1, touca::detail::format(
                     "failed to submit HTTP POST request to {}", route)};
@@ -11,97 +11,217 @@
 #include "rapidjson/rapidjson.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
+#include "touca/core/string_table.hpp"
 #include "touca/core/variant.hpp"
 #include "touca/impl/schema.hpp"
 
 namespace touca {
 namespace detail {
 
+/**
+ * The overloads below serialize scalar values into their own tables by
+ * default. Binary format v3 stores them inline in their `TypeWrapper`
+ * instead, which takes less than half the space and avoids a level of
+ * indirection when they are read.
+ */
+
 flatbuffers::Offset<fbs::TypeWrapper> serialize(
     flatbuffers::FlatBufferBuilder& builder,
-    const touca::detail::boolean_t value) {
+    const touca::detail::boolean_t value, const bool compact) {
+  if (compact) {
+    fbs::TypeWrapperBuilder wrapper(builder);
+    wrapper.add_bool_value(value);
+    wrapper.add_value_type(fbs::Type::Bool);
+    return wrapper.Finish();
+  }
   const auto& fbsNumber = fbs::CreateBool(builder, value);
   return fbs::CreateTypeWrapper(builder, fbs::Type::Bool, fbsNumber.Union());
 }
 
 flatbuffers::Offset<fbs::TypeWrapper> serialize(
     flatbuffers::FlatBufferBuilder& builder,
-    const touca::detail::number_double_t& value) {
+    const touca::detail::number_double_t& value, const bool compact) {
+  if (compact) {
+    fbs::TypeWrapperBuilder wrapper(builder);
+    wrapper.add_double_value(value);
+    wrapper.add_value_type(fbs::Type::Double);
+    return wrapper.Finish();
+  }
   const auto& fbsNumber = fbs::CreateDouble(builder, value);
   return fbs::CreateTypeWrapper(builder, fbs::Type::Double, fbsNumber.Union());
 }
 
 flatbuffers::Offset<fbs::TypeWrapper> serialize(
     flatbuffers::FlatBufferBuilder& builder,
-    const touca::detail::number_float_t& value) {
+    const touca::detail::number_float_t& value, const bool compact) {
+  if (compact) {
+    fbs::TypeWrapperBuilder wrapper(builder);
+    wrapper.add_float_value(value);
+    wrapper.add_value_type(fbs::Type::Float);
+    return wrapper.Finish();
+  }
   const auto& fbsNumber = fbs::CreateFloat(builder, value);
   return fbs::CreateTypeWrapper(builder, fbs::Type::Float, fbsNumber.Union());
 }
 
 flatbuffers::Offset<fbs::TypeWrapper> serialize(
     flatbuffers::FlatBufferBuilder& builder,
-    const touca::detail::number_signed_t& value) {
+    const touca::detail::number_signed_t& value, const bool compact) {
+  if (compact) {
+    fbs::TypeWrapperBuilder wrapper(builder);
+    wrapper.add_int_value(value);
+    wrapper.add_value_type(fbs::Type::Int);
+    return wrapper.Finish();
+  }
   const auto& fbsNumber = fbs::CreateInt(builder, value);
   return fbs::CreateTypeWrapper(builder, fbs::Type::Int, fbsNumber.Union());
 }
 
 flatbuffers::Offset<fbs::TypeWrapper> serialize(
     flatbuffers::FlatBufferBuilder& builder,
-    const touca::detail::number_unsigned_t& value) {
+    const touca::detail::number_unsigned_t& value, const bool compact) {
+  if (compact) {
+    fbs::TypeWrapperBuilder wrapper(builder);
+    wrapper.add_uint_value(value);
+    wrapper.add_value_type(fbs::Type::UInt);
+    return wrapper.Finish();
+  }
   const auto& fbsNumber = fbs::CreateUInt(builder, value);
   return fbs::CreateTypeWrapper(builder, fbs::Type::UInt, fbsNumber.Union());
 }
 
 flatbuffers::Offset<fbs::TypeWrapper> serialize(
     flatbuffers::FlatBufferBuilder& builder,
-    const touca::detail::string_t& value) {
-  const auto& fbsValue = fbs::CreateStringDirect(builder, value.c_str());
+    const touca::detail::string_t& value, StringPool* strings, const bool) {
+  const auto& fbsValue =
+      strings && StringPool::is_shareable(value)
+          ? fbs::CreateString(builder, 0, strings->add(value))
+          : fbs::CreateStringDirect(builder, value.c_str());
   return fbs::CreateTypeWrapper(builder, fbs::Type::String, fbsValue.Union());
 }
 
-flatbuffers::Offset<fbs::TypeWrapper> serialize(
+template <typename T, typename Getter>
+std::vector<T> collect(const array& elements, Getter getter) {
+  std::vector<T> values;
+  for (const auto& element : elements) {
+    values.push_back(static_cast<T>((element.*getter)()));
+  }
+  return values;
+}
+
+/**
+ * Serializes a non-empty array whose elements are all scalars of the same
+ * type into the typed vector that matches that type, as in binary format
+ * v3.
+ *
+ * @return null offset if the array cannot be serialized this way
+ */
+flatbuffers::Offset<fbs::Array> serialize_scalars(
     flatbuffers::FlatBufferBuilder& builder, const array& elements) {
+  if (elements.begin() == elements.end()) {
+    return 0;
+  }
+  const auto type = elements.begin()->type();
+  for (const auto& element : elements) {
+    if (element.type() != type) {
+      return 0;
+    }
+  }
+  switch (type) {
+    case internal_type::boolean: {
+      const auto& values =
+          collect<std::uint8_t>(elements, &data_point::as_boolean);
+      return fbs::CreateArrayDirect(builder, nullptr, &values);
+    }
+    case internal_type::number_signed: {
+      const auto& values =
+          collect<number_signed_t>(elements, &data_point::as_number_signed);
+      return fbs::CreateArrayDirect(builder, nullptr, nullptr, &values);
+    }
+    case internal_type::number_unsigned: {
+      const auto& values = collect<number_unsigned_t>(
+          elements, &data_point::as_number_unsigned);
+      return fbs::CreateArrayDirect(builder, nullptr, nullptr, nullptr,
+                                    &values);
+    }
+    case internal_type::number_float: {
+      const auto& values =
+          collect<number_float_t>(elements, &data_point::as_number_float);
+      return fbs::CreateArrayDirect(builder, nullptr, nullptr, nullptr,
+                                    nullptr, &values);
+    }
+    case internal_type::number_double: {
+      const auto& values =
+          collect<number_double_t>(elements, &data_point::as_number_double);
+      return fbs::CreateArrayDirect(builder, nullptr, nullptr, nullptr,
+                                    nullptr, nullptr, &values);
+    }
+    default:
+      return 0;
+  }
+}
+
+flatbuffers::Offset<fbs::TypeWrapper> serialize(
+    flatbuffers::FlatBufferBuilder& builder, const array& elements,
+    StringPool* strings, const bool compact) {
+  if (compact) {
+    const auto& fbsValue = serialize_scalars(builder, elements);
+    if (fbsValue.o) {
+      return fbs::CreateTypeWrapper(builder, fbs::Type::Array,
+                                    fbsValue.Union());
+    }
+  }
   std::vector<flatbuffers::Offset<fbs::TypeWrapper>> entries;
   for (const auto& element : elements) {
-    entries.push_back(element.serialize(builder));
+    entries.push_back(element.serialize(builder, strings, compact));
   }
   const auto& fbsValue = fbs::CreateArrayDirect(builder, &entries);
   return fbs::CreateTypeWrapper(builder, fbs::Type::Array, fbsValue.Union());
 }
 
 flatbuffers::Offset<fbs::TypeWrapper> serialize(
-    flatbuffers::FlatBufferBuilder& builder, const object& obj) {
+    flatbuffers::FlatBufferBuilder& builder, const object& obj,
+    StringPool* strings, const bool compact) {
   std::vector<flatbuffers::Offset<fbs::ObjectMember>> members;
   for (const auto& value : obj) {
-    members.push_back(fbs::CreateObjectMemberDirect(
-        builder, value.first.c_str(), value.second.serialize(builder)));
+    const auto& member = value.second.serialize(builder, strings, compact);
+    members.push_back(
+        strings ? fbs::CreateObjectMember(builder, 0, member,
+                                          strings->add(value.first))
+                : fbs::CreateObjectMemberDirect(builder, value.first.c_str(),
+                                                member));
   }
   const auto& fbsValue =
-      fbs::CreateObjectDirect(builder, obj.get_name().c_str(), &members);
+      strings ? fbs::CreateObjectDirect(builder, nullptr, &members,
+                                        strings->add(obj.get_name()))
+              : fbs::CreateObjectDirect(builder, obj.get_name().c_str(),
+                                        &members);
   return fbs::CreateTypeWrapper(builder, fbs::Type::Object, fbsValue.Union());
 }
 
 class data_point_serializer_visitor {
   flatbuffers::FlatBufferBuilder& _builder;
+  StringPool* _strings;
+  bool _compact;
 
  public:
-  explicit data_point_serializer_visitor(
-      flatbuffers::FlatBufferBuilder& builder)
-      : _builder(builder) {}
+  data_point_serializer_visitor(flatbuffers::FlatBufferBuilder& builder,
+                                StringPool* strings, const bool compact)
+      : _builder(builder), _strings(strings), _compact(compact) {}
 
   template <typename T>
   flatbuffers::Offset<fbs::TypeWrapper> operator()(const T& value) {
-    return serialize(_builder, value);
+    return serialize(_builder, value, _compact);
   }
 
   template <typename T>
   flatbuffers::Offset<fbs::TypeWrapper> operator()(
       const touca::detail::deep_copy_ptr<T>& ptr) {
-    return serialize(_builder, *ptr);
+    return serialize(_builder, *ptr, _strings, _compact);
   }
 
   flatbuffers::Offset<fbs::TypeWrapper> operator()(std::nullptr_t) {
-    return serialize(_builder, false);
+    return serialize(_builder, false, _compact);
   }
 };
 
@@ -179,9 +299,11 @@ void data_point::increment() noexcept {
 }
 
 flatbuffers::Offset<fbs::TypeWrapper> data_point::serialize(
-    flatbuffers::FlatBufferBuilder& builder) const {
+    flatbuffers::FlatBufferBuilder& builder,
+    touca::detail::StringPool* strings, const bool compact) const {
   return touca::detail::visit(
-      touca::detail::data_point_serializer_visitor(builder), _value);
+      touca::detail::data_point_serializer_visitor(builder, strings, compact),
+      _value);
 }
 
 std::string data_point::to_string() const {
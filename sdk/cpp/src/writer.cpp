@@ -0,0 +1,268 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/writer.hpp"
+
+#include <algorithm>
+
+#include "flatbuffers/flatbuffers.h"
+#include "touca/core/compression.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/parallel.hpp"
+#include "touca/core/reader.hpp"
+#include "touca/core/string_table.hpp"
+#include "touca/impl/schema.hpp"
+
+namespace touca {
+namespace detail {
+namespace {
+
+/**
+ * Smallest number of testcases for which serializing on another thread
+ * is worth the cost of starting it.
+ */
+constexpr std::size_t min_testcases_per_thread = 16;
+
+/**
+ * Number of chunks of testcases per thread, so that threads that finish
+ * early can pick up the remaining work when testcases differ in size.
+ */
+constexpr std::size_t chunks_per_thread = 4;
+
+/**
+ * Counts the copy of a testcase that was serialized into a given builder,
+ * if any, into the cached encoding of that testcase.
+ */
+void count_encoding(const flatbuffers::FlatBufferBuilder& builder,
+                    WriterStats& stats) {
+  if (builder.GetSize() != 0) {
+    ++stats.allocations;
+    stats.bytes_copied += builder.GetSize();
+  }
+}
+
+}  // namespace
+
+/**
+ * Allocator of the buffers of our flatbuffers builders that keeps count
+ * of allocations and of the bytes that are copied when a buffer grows.
+ */
+class MessagesWriter::CountingAllocator : public flatbuffers::Allocator {
+ public:
+  explicit CountingAllocator(WriterStats& stats) : _stats(stats) {}
+
+  std::uint8_t* allocate(size_t size) override {
+    ++_stats.allocations;
+    return new std::uint8_t[size];
+  }
+
+  void deallocate(std::uint8_t* p, size_t) override { delete[] p; }
+
+  std::uint8_t* reallocate_downward(std::uint8_t* old_p, size_t old_size,
+                                    size_t new_size, size_t in_use_back,
+                                    size_t in_use_front) override {
+    _stats.bytes_copied += in_use_back + in_use_front;
+    return flatbuffers::Allocator::reallocate_downward(
+        old_p, old_size, new_size, in_use_back, in_use_front);
+  }
+
+ private:
+  WriterStats& _stats;
+};
+
+/**
+ * Buffers of a thread that serializes ranges of testcases, which are
+ * reused from one call to `write` to the next.
+ */
+struct MessagesWriter::Chunk {
+  Chunk() : allocator(stats), builder(1024, &allocator) {}
+
+  WriterStats stats;
+  CountingAllocator allocator;
+  flatbuffers::FlatBufferBuilder builder;
+};
+
+MessagesWriter::MessagesWriter()
+    : _allocator(touca::detail::make_unique<CountingAllocator>(_stats)),
+      _output(touca::detail::make_unique<flatbuffers::FlatBufferBuilder>(
+          1024, _allocator.get())),
+      _scratch(touca::detail::make_unique<flatbuffers::FlatBufferBuilder>(
+          1024, _allocator.get())) {}
+
+MessagesWriter::~MessagesWriter() = default;
+
+void MessagesWriter::write(const std::vector<Testcase>& testcases,
+                           const BinaryFormat format,
+                           const std::size_t concurrency) {
+  auto& builder = *_output;
+  builder.Clear();
+  StringPool pool;
+  const auto& strings = format == BinaryFormat::V1 ? nullptr : &pool;
+  std::vector<flatbuffers::Offset<fbs::MessageBuffer>> messageBuffers;
+  messageBuffers.reserve(testcases.size());
+  const auto add_message = [&](const std::uint8_t* data,
+                               const std::size_t size) {
+    const auto& buffer = builder.CreateVector<std::uint8_t>(data, size);
+    _stats.bytes_copied += size;
+    messageBuffers.push_back(fbs::CreateMessageBuffer(builder, buffer));
+  };
+  const auto threads = std::min(thread_count(concurrency),
+                                testcases.size() / min_testcases_per_thread);
+  if (threads <= 1) {
+    for (const auto& tc : testcases) {
+      _scratch->Clear();
+      const auto& encoding = tc.encode(*_scratch, format, strings);
+      count_encoding(*_scratch, _stats);
+      add_message(encoding.data(), encoding.size());
+    }
+  } else {
+    // shared strings are collected upfront in the order in which they
+    // would have been added by serializing testcases one after another,
+    // so that their positions do not depend on the order in which threads
+    // get to them.
+    if (strings) {
+      for (const auto& tc : testcases) {
+        tc.collect_strings(pool);
+      }
+      pool.freeze();
+    }
+    for (const auto& encoding :
+         encode_chunks(testcases, format, strings, threads)) {
+      add_message(encoding->data(), encoding->size());
+    }
+  }
+  const auto& fbsMessages = builder.CreateVector(messageBuffers);
+
+  // shared strings are created last so that they are stored before the
+  // messages that refer to them, which lets readers consume the buffer
+  // forward-only.
+
+  flatbuffers::Offset<
+      flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+      fbsStrings;
+  if (strings) {
+    std::vector<flatbuffers::Offset<flatbuffers::String>> entries;
+    entries.reserve(pool.strings().size());
+    for (const auto& value : pool.strings()) {
+      entries.push_back(builder.CreateString(value));
+    }
+    fbsStrings = builder.CreateVector(entries);
+  }
+  builder.Finish(fbs::CreateMessages(builder, fbsMessages, fbsStrings));
+}
+
+std::vector<const std::vector<std::uint8_t>*> MessagesWriter::encode_chunks(
+    const std::vector<Testcase>& testcases, const BinaryFormat format,
+    StringPool* strings, const std::size_t threads) {
+  const auto count = std::min(threads * chunks_per_thread, testcases.size());
+  while (_chunks.size() < count) {
+    _chunks.push_back(touca::detail::make_unique<Chunk>());
+  }
+  const auto chunk_size = (testcases.size() + count - 1) / count;
+  std::vector<const std::vector<std::uint8_t>*> encodings(testcases.size());
+  parallel_for(count, threads, [&](const std::size_t index) {
+    auto& chunk = *_chunks[index];
+    const auto begin = index * chunk_size;
+    const auto end = std::min(begin + chunk_size, testcases.size());
+    for (auto i = begin; i < end; ++i) {
+      chunk.builder.Clear();
+      encodings[i] = &testcases[i].encode(chunk.builder, format, strings);
+      count_encoding(chunk.builder, chunk.stats);
+    }
+  });
+  return encodings;
+}
+
+const std::uint8_t* MessagesWriter::data() const {
+  return _output->GetBufferPointer();
+}
+
+std::size_t MessagesWriter::size() const { return _output->GetSize(); }
+
+WriterStats MessagesWriter::stats() const noexcept {
+  auto stats = _stats;
+  for (const auto& chunk : _chunks) {
+    stats.allocations += chunk->stats.allocations;
+    stats.bytes_copied += chunk->stats.bytes_copied;
+  }
+  return stats;
+}
+
+MessagesMerger::MessagesMerger(const BinaryFormat format)
+    : _format(format),
+      _output(touca::detail::make_unique<flatbuffers::FlatBufferBuilder>()),
+      _scratch(touca::detail::make_unique<flatbuffers::FlatBufferBuilder>()) {}
+
+MessagesMerger::~MessagesMerger() = default;
+
+void MessagesMerger::add(
+    const std::uint8_t* data, const std::size_t size,
+    const std::function<bool(const TestcaseView&)>& filter) {
+  std::vector<std::uint8_t> content;
+  if (is_compressed(data, size)) {
+    content = decompress(data, size);
+  }
+  const auto& ptr = content.empty() ? data : content.data();
+  const auto& length = content.empty() ? size : content.size();
+  if (!flatbuffers::Verifier(ptr, length).VerifyBuffer<fbs::Messages>()) {
+    throw touca::detail::runtime_error("result file invalid");
+  }
+  const auto& root = fbs::GetMessages(ptr);
+  const StringTable strings(root);
+  for (const auto&& item : *root->messages()) {
+    const auto& buffer = item->buf();
+    if (!buffer || !flatbuffers::Verifier(buffer->data(), buffer->size())
+                        .VerifyBuffer<fbs::Message>()) {
+      throw touca::detail::runtime_error("result file invalid");
+    }
+    const TestcaseView testcase(item->buf_nested_root(), nullptr, &strings);
+    if (filter && !filter(testcase)) {
+      continue;
+    }
+    // testcases of lists without shared strings are in binary format v1,
+    // so they only have the layout of the output if it is in binary format
+    // v1 as well.
+    auto message = buffer->data();
+    auto message_size = static_cast<std::size_t>(buffer->size());
+    if (strings.size() != 0 || _format != BinaryFormat::V1) {
+      _scratch->Clear();
+      testcase.decode().flatbuffers(
+          *_scratch, _format == BinaryFormat::V1 ? nullptr : &_pool,
+          _format == BinaryFormat::V3);
+      message = _scratch->GetBufferPointer();
+      message_size = _scratch->GetSize();
+    }
+    const auto& bytes =
+        _output->CreateVector<std::uint8_t>(message, message_size);
+    _buffers.push_back(fbs::CreateMessageBuffer(*_output, bytes).o);
+  }
+}
+
+void MessagesMerger::finish() {
+  std::vector<flatbuffers::Offset<fbs::MessageBuffer>> buffers;
+  buffers.reserve(_buffers.size());
+  for (const auto& offset : _buffers) {
+    buffers.emplace_back(offset);
+  }
+  const auto& fbsMessages = _output->CreateVector(buffers);
+  flatbuffers::Offset<
+      flatbuffers::Vector<flatbuffers::Offset<flatbuffers::String>>>
+      fbsStrings;
+  if (_format != BinaryFormat::V1) {
+    std::vector<flatbuffers::Offset<flatbuffers::String>> entries;
+    entries.reserve(_pool.strings().size());
+    for (const auto& value : _pool.strings()) {
+      entries.push_back(_output->CreateString(value));
+    }
+    fbsStrings = _output->CreateVector(entries);
+  }
+  _output->Finish(fbs::CreateMessages(*_output, fbsMessages, fbsStrings));
+}
+
+const std::uint8_t* MessagesMerger::data() const {
+  return _output->GetBufferPointer();
+}
+
+std::size_t MessagesMerger::size() const { return _output->GetSize(); }
+
+}  // namespace detail
+}  // namespace touca
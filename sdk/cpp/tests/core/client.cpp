@@ -81,7 +81,7 @@ TEST_CASE("using a configured client") {
     CHECK_NOTHROW(client.add_array_element("some-array-value", v1));
     const auto& content = save_and_read_back(client);
     const auto& expected =
-        R"("results":[{"key":"some-array-value","value":"[true]"},{"key":"some-other-value","value":"1"},{"key":"some-value","value":"true"}])";
+        R"("results":[{"key":"some-array-value","value":[true]},{"key":"some-other-value","value":1},{"key":"some-value","value":true}])";
     CHECK_THAT(content, Catch::Contains(expected));
   }
 
@@ -110,7 +110,7 @@ TEST_CASE("using a configured client") {
     CHECK(tc->metrics().count("b"));
     const auto& content = save_and_read_back(client);
     const auto& expected =
-        R"("results":[],"assertion":[],"metrics":[{"key":"b","value":"0"}])";
+        R"("results":[],"assertion":[],"metrics":[{"key":"b","value":0}])";
     CHECK_THAT(content, Catch::Contains(expected));
   }
 
@@ -126,6 +126,20 @@ TEST_CASE("using a configured client") {
     CHECK_THAT(content, Catch::Contains(R"([])"));
   }
 
+  SECTION("release_testcase") {
+    const auto& tc = client.declare_testcase("some-case");
+    client.start_timer("some-metric");
+    client.stop_timer("some-metric");
+    CHECK(client.release_testcase("some-case") == tc);
+    CHECK(client.release_testcase("some-case") == nullptr);
+    const auto& v1 = touca::data_point::boolean(true);
+    CHECK_NOTHROW(client.check("some-value", v1));
+    CHECK_NOTHROW(client.add_metric("other-metric", 1));
+    CHECK(tc->metrics().size() == 1);
+    const auto& content = save_and_read_back(client);
+    CHECK_THAT(content, Catch::Contains(R"([])"));
+  }
+
   /**
    * Calling post when client is locally configured should throw exception.
    */
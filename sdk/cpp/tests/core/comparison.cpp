@@ -164,4 +164,53 @@ TEST_CASE("Result File Operations") {
       CHECK_THAT(output, Catch::Contains(check3));
     }
   }
+
+  /**
+   * Compare two result files directly, without decoding their content.
+   */
+  SECTION("compare_files_without_decoding") {
+    client.declare_testcase("ccarter");
+    client.check("age", touca::data_point::number_signed(42));
+    client.check("height", touca::data_point::number_double(1.82));
+    client.assume("active", touca::data_point::boolean(true));
+    client.add_array_element("courses", touca::data_point::string("math"));
+    client.add_array_element("courses", touca::data_point::string("music"));
+    client.check("head", touca::object("creature").add("head", Head(2)));
+    client.add_metric("duration", 10);
+    TmpFile tmpFileA;
+    client.save(tmpFileA.path, {}, touca::DataFormat::FBS, true);
+
+    client.declare_testcase("ccarter");
+    client.forget_testcase("ccarter");
+    client.declare_testcase("ccarter");
+    client.check("age", touca::data_point::number_signed(43));
+    client.check("height", touca::data_point::string("1.82"));
+    client.assume("active", touca::data_point::boolean(true));
+    client.add_array_element("courses", touca::data_point::string("math"));
+    client.check("head", touca::object("creature").add("head", Head(3)));
+    client.add_metric("duration", 12);
+    TmpFile tmpFileB;
+    client.save(tmpFileB.path, {"aanderson", "ccarter"}, touca::DataFormat::FBS,
+                true);
+
+    const auto& expected = compare(touca::deserialize_file(tmpFileA.path),
+                                   touca::deserialize_file(tmpFileB.path));
+    const auto& actual = touca::compare_files(tmpFileA.path, tmpFileB.path);
+
+    CHECK(actual.fresh.size() == 1u);
+    CHECK(actual.missing.empty());
+    CHECK(actual.common.size() == 2u);
+    CHECK(actual.common.at("ccarter").overview().keysScore ==
+          expected.common.at("ccarter").overview().keysScore);
+    CHECK(actual.json() == expected.json());
+  }
+
+  SECTION("compare_files_with_invalid_file") {
+    TmpFile tmpFileA;
+    TmpFile tmpFileB;
+    client.save(tmpFileA.path, {"aanderson"}, touca::DataFormat::FBS, true);
+    tmpFileB.write("some invalid content");
+    CHECK_THROWS_AS(touca::compare_files(tmpFileA.path, tmpFileB.path),
+                    touca::detail::runtime_error);
+  }
 }
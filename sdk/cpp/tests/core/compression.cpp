@@ -0,0 +1,72 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/compression.hpp"
+
+#include "catch2/catch.hpp"
+#include "tests/core/shared.hpp"
+#include "touca/client/detail/client.hpp"
+#include "touca/core/deserialize.hpp"
+#include "touca/core/filesystem.hpp"
+
+TEST_CASE("compression") {
+  std::string text;
+  for (auto i = 0; i < 1000; ++i) {
+    text += "some-repetitive-key-" + std::to_string(i % 10);
+  }
+  const auto data = reinterpret_cast<const std::uint8_t*>(text.data());
+
+  if (!touca::detail::has_compression()) {
+    CHECK_THROWS_AS(touca::detail::compress(data, text.size()),
+                    touca::detail::runtime_error);
+    return;
+  }
+
+  SECTION("round trip") {
+    const auto& compressed = touca::detail::compress(data, text.size());
+    CHECK(touca::detail::is_compressed(compressed.data(), compressed.size()));
+    CHECK_FALSE(touca::detail::is_compressed(data, text.size()));
+    CHECK(compressed.size() < text.size() / 10);
+    const auto& output =
+        touca::detail::decompress(compressed.data(), compressed.size());
+    CHECK(std::string(output.begin(), output.end()) == text);
+  }
+
+  SECTION("truncated content") {
+    auto compressed = touca::detail::compress(data, text.size());
+    compressed.resize(compressed.size() / 2);
+    CHECK_THROWS_AS(
+        touca::detail::decompress(compressed.data(), compressed.size()),
+        touca::detail::runtime_error);
+  }
+
+  SECTION("result files") {
+    touca::ClientImpl client;
+    client.configure([](touca::ClientOptions& x) {
+      x.team = "acme";
+      x.suite = "students";
+      x.version = "1.0";
+      x.offline = true;
+      x.compress = true;
+    });
+    client.declare_testcase("alice");
+    client.check("firstname", touca::data_point::string("alice"));
+    client.declare_testcase("bob");
+    client.check("firstname", touca::data_point::string("bob"));
+    TmpFile file;
+    client.save(file.path, {}, touca::DataFormat::FBS, true);
+
+    const auto& content = touca::detail::load_text_file(
+        file.path.string(), std::ios::in | std::ios::binary);
+    CHECK(touca::detail::is_compressed(
+        reinterpret_cast<const std::uint8_t*>(content.data()),
+        content.size()));
+    const auto& testcases = touca::deserialize_file(file.path);
+    CHECK(testcases.size() == 2u);
+    CHECK(testcases.count("bob"));
+
+    std::size_t count = 0;
+    touca::for_each_testcase(file.path,
+                             [&count](const touca::Testcase&) { ++count; });
+    CHECK(count == 2u);
+  }
+}
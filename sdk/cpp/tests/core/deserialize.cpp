@@ -2,11 +2,15 @@
 
 #include "touca/core/deserialize.hpp"
 
+#include <fstream>
+#include <map>
+
 #include "catch2/catch.hpp"
 #include "tests/core/shared.hpp"
 #include "touca/client/detail/client.hpp"
 #include "touca/core/comparison.hpp"
 #include "touca/core/filesystem.hpp"
+#include "touca/core/reader.hpp"
 #include "touca/core/serializer.hpp"
 #include "touca/impl/schema.hpp"
 
@@ -324,4 +328,174 @@ TEST_CASE("Deserialize file") {
     CHECK(content.at("some-case")->overview().keysCount == 2);
     CHECK(content.at("some-other-case")->overview().keysCount == 1);
   }
+
+  SECTION("parallel") {
+    for (auto i = 0; i < 20; ++i) {
+      CHECK(client.declare_testcase("case-" + std::to_string(i)));
+      CHECK_NOTHROW(client.add_hit_count("key-" + std::to_string(i % 3)));
+    }
+    TmpFile file;
+    CHECK_NOTHROW(client.save(file.path, {}, touca::DataFormat::FBS, true));
+    const auto& expected = touca::deserialize_file(file.path);
+    const auto& actual = touca::deserialize_file(file.path, 4);
+    CHECK(touca::elements_map_to_json(actual) ==
+          touca::elements_map_to_json(expected));
+    CHECK_NOTHROW(touca::deserialize_file(file.path, 0));
+
+    TmpFile invalid;
+    invalid.write("some invalid content");
+    CHECK_THROWS_AS(touca::deserialize_file(invalid.path, 4),
+                    touca::detail::runtime_error);
+  }
+
+  SECTION("binary format v2") {
+    for (auto i = 0; i < 10; ++i) {
+      CHECK(client.declare_testcase("case-" + std::to_string(i)));
+      client.check("name", touca::data_point::string("shared-value"));
+      const std::string note(100, static_cast<char>('a' + i));
+      client.check("note", touca::data_point::string(note));
+      client.check("head", touca::object("creature").add("eyes", i));
+      client.add_array_element("tags", touca::data_point::string("tag"));
+      client.add_metric("duration", static_cast<unsigned>(i));
+    }
+    TmpFile file;
+    CHECK_NOTHROW(client.save(file.path, {}, touca::DataFormat::FBS, true));
+    const auto& expected = touca::deserialize_file(file.path);
+
+    std::vector<touca::Testcase> testcases;
+    for (auto i = 0; i < 10; ++i) {
+      testcases.push_back(*expected.at("case-" + std::to_string(i)));
+    }
+    const auto& content =
+        touca::Testcase::serialize(testcases, touca::BinaryFormat::V2);
+    CHECK(content.size() <
+          touca::Testcase::serialize(testcases, touca::BinaryFormat::V1)
+              .size());
+    TmpFile compact;
+    touca::detail::save_binary_file(compact.path.string(), content);
+
+    const auto& actual = touca::deserialize_file(compact.path, 2);
+    CHECK(touca::elements_map_to_json(actual) ==
+          touca::elements_map_to_json(expected));
+
+    // testcases are streamed in the order of their position in the file
+    std::map<std::string, std::shared_ptr<touca::Testcase>> streamed;
+    touca::for_each_testcase(
+        compact.path, [&streamed](const touca::Testcase& tc) {
+          streamed.emplace(tc.metadata().testcase,
+                           std::make_shared<touca::Testcase>(tc));
+        });
+    REQUIRE(streamed.size() == 10u);
+    touca::ElementsMap ordered;
+    for (const auto& testcase : testcases) {
+      const auto& name = testcase.metadata().testcase;
+      ordered.emplace(name, streamed.at(name));
+    }
+    CHECK(touca::elements_map_to_json(ordered) ==
+          touca::elements_map_to_json(expected));
+
+    const auto& cmp = touca::compare_files(file.path, compact.path);
+    CHECK(cmp.common.size() == 10u);
+    CHECK(cmp.common.at("case-3").overview().keysScore == 1.0);
+  }
+
+  SECTION("binary format v3") {
+    for (auto i = 0; i < 10; ++i) {
+      CHECK(client.declare_testcase("case-" + std::to_string(i)));
+      client.check("flag", touca::data_point::boolean(i % 2 == 0));
+      client.check("count", touca::data_point::number_signed(i - 5));
+      client.check("size", touca::data_point::number_unsigned(i * 100u));
+      client.check("ratio", touca::data_point::number_float(i / 4.0f));
+      client.check("score", touca::data_point::number_double(i * 1.5));
+      client.check("head", touca::object("creature").add("eyes", i));
+      const auto& tag = touca::data_point::string("tag");
+      client.check("mixed", touca::array().add(i).add(true).add(tag));
+      client.check("empty", touca::array());
+      for (auto j = 0; j < 5; ++j) {
+        client.add_array_element("ints", touca::data_point::number_signed(j));
+        client.add_array_element("bools",
+                                 touca::data_point::boolean(j % 2 != 0));
+        client.add_array_element("doubles",
+                                 touca::data_point::number_double(j * 0.5));
+      }
+      client.add_metric("duration", static_cast<unsigned>(i));
+    }
+    TmpFile file;
+    CHECK_NOTHROW(client.save(file.path, {}, touca::DataFormat::FBS, true));
+    const auto& expected = touca::deserialize_file(file.path);
+
+    std::vector<touca::Testcase> testcases;
+    for (auto i = 0; i < 10; ++i) {
+      testcases.push_back(*expected.at("case-" + std::to_string(i)));
+    }
+    const auto& content =
+        touca::Testcase::serialize(testcases, touca::BinaryFormat::V3);
+    CHECK(content.size() <
+          touca::Testcase::serialize(testcases, touca::BinaryFormat::V2)
+              .size());
+    TmpFile compact;
+    touca::detail::save_binary_file(compact.path.string(), content);
+
+    const auto& actual = touca::deserialize_file(compact.path);
+    CHECK(touca::elements_map_to_json(actual) ==
+          touca::elements_map_to_json(expected));
+
+    std::size_t count = 0;
+    touca::for_each_testcase(compact.path,
+                             [&count](const touca::Testcase&) { ++count; });
+    CHECK(count == 10u);
+
+    const touca::ResultFile result_file(compact.path);
+    CHECK(result_file.testcase("case-7").metric("duration") == 7);
+
+    const auto& cmp = touca::compare_files(file.path, compact.path);
+    REQUIRE(cmp.common.size() == 10u);
+    for (const auto& kvp : cmp.common) {
+      CHECK(kvp.second.overview().keysScore == 1.0);
+    }
+  }
+
+  SECTION("streaming") {
+    for (auto i = 0; i < 5; ++i) {
+      CHECK(client.declare_testcase("case-" + std::to_string(i)));
+      CHECK_NOTHROW(client.add_hit_count("key-" + std::to_string(i)));
+    }
+    TmpFile file;
+    CHECK_NOTHROW(client.save(file.path, {}, touca::DataFormat::FBS, true));
+    const auto& expected = touca::deserialize_file(file.path);
+
+    touca::ElementsMap actual;
+    std::ifstream input(file.path.string(), std::ios::binary);
+    touca::for_each_testcase(input, [&actual](const touca::Testcase& tc) {
+      actual.emplace(tc.metadata().testcase,
+                     std::make_shared<touca::Testcase>(tc));
+    });
+    REQUIRE(actual.size() == expected.size());
+    for (const auto& kvp : expected) {
+      REQUIRE(actual.count(kvp.first));
+      CHECK(compare(*kvp.second, *actual.at(kvp.first)).overview().keysScore ==
+            1.0);
+    }
+
+    TmpFile invalid;
+    invalid.write("some invalid content");
+    CHECK_THROWS_AS(
+        touca::for_each_testcase(invalid.path, [](const touca::Testcase&) {}),
+        touca::detail::runtime_error);
+
+    // a corrupt length of a nested buffer should fail without allocating
+    // memory for it.
+    auto content = touca::detail::load_text_file(file.path.string());
+    const auto& root = flatbuffers::GetRoot<touca::fbs::Messages>(
+        reinterpret_cast<const std::uint8_t*>(content.data()));
+    const auto& buf = root->messages()->Get(0)->buf();
+    const auto& prefix = reinterpret_cast<const char*>(buf) - content.data();
+    flatbuffers::WriteScalar<flatbuffers::uoffset_t>(&content[prefix],
+                                                     0xfffffff0);
+    TmpFile corrupt;
+    corrupt.write(content);
+    CHECK_THROWS_AS(
+        touca::for_each_testcase(corrupt.path, [](const touca::Testcase&) {}),
+        touca::detail::runtime_error);
+  }
 }
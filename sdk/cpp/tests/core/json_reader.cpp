@@ -0,0 +1,148 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/json_reader.hpp"
+
+#include <sstream>
+
+#include "catch2/catch.hpp"
+#include "tests/core/shared.hpp"
+#include "touca/core/json_writer.hpp"
+
+namespace {
+
+touca::Testcase make_testcase(const std::string& name) {
+  touca::ResultsMap results;
+  const auto& add = [&results](const std::string& key,
+                               const touca::data_point& value) {
+    results.emplace(key,
+                    touca::ResultEntry{value, touca::ResultCategory::Check});
+  };
+  add("flag", touca::data_point::boolean(false));
+  add("count", touca::data_point::number_signed(-42));
+  add("ratio", touca::data_point::number_double(0.25));
+  add("name", touca::data_point::string(name));
+  add("nothing", touca::data_point::null());
+  add("scores", touca::array().add(1).add(touca::array().add("a")));
+  add("head", touca::object("head")
+                  .add("eyes", 2)
+                  .add("hair", touca::object("hair").add("color", "red")));
+  results.emplace("valid", touca::ResultEntry{touca::data_point::boolean(true),
+                                              touca::ResultCategory::Assert});
+  const touca::Testcase::Metadata meta = {"acme", "students", "1.0", name,
+                                          "2023-01-01T00:00:00.000Z"};
+  return touca::Testcase(meta, results, {{"runtime", 10}});
+}
+
+std::vector<touca::Testcase> read(const std::string& content) {
+  std::vector<touca::Testcase> testcases;
+  std::istringstream input(content);
+  touca::for_each_json_testcase(input, [&](const touca::Testcase& testcase) {
+    testcases.push_back(testcase);
+  });
+  return testcases;
+}
+
+std::string write(const std::vector<touca::Testcase>& testcases,
+                  const touca::detail::JsonWriter::Layout layout) {
+  std::string output;
+  touca::detail::JsonWriter writer(output, layout);
+  for (const auto& testcase : testcases) {
+    writer.write(testcase);
+  }
+  writer.finish();
+  return output;
+}
+
+}  // namespace
+
+TEST_CASE("json reader") {
+  using Layout = touca::detail::JsonWriter::Layout;
+  const std::vector<touca::Testcase> testcases = {make_testcase("alice"),
+                                                  make_testcase("bob")};
+
+  SECTION("array") {
+    const auto& content = write(testcases, Layout::Array);
+    const auto& actual = read(content);
+    REQUIRE(actual.size() == 2u);
+    CHECK(actual[1].metadata().testcase == "bob");
+    CHECK(actual[1].metadata().builtAt == "2023-01-01T00:00:00.000Z");
+    CHECK(actual[1].overview().keysCount == 8);
+    CHECK(actual[1].metrics().at("runtime").value.as_metric() == 10);
+    CHECK(write(actual, Layout::Array) == content);
+  }
+
+  SECTION("lines") {
+    const auto& content = write(testcases, Layout::Lines);
+    const auto& actual = read(content);
+    REQUIRE(actual.size() == 2u);
+    CHECK(write(actual, Layout::Lines) == content);
+  }
+
+  SECTION("large input") {
+    std::vector<touca::Testcase> many;
+    for (auto i = 0; i < 1000; ++i) {
+      many.push_back(make_testcase("case-" + std::to_string(i)));
+    }
+    const auto& content = write(many, Layout::Lines);
+    CHECK(write(read(content), Layout::Lines) == content);
+  }
+
+  SECTION("file") {
+    TmpFile file;
+    touca::detail::save_json_file(file.path.string(), testcases);
+    std::size_t count = 0;
+    touca::for_each_json_testcase(
+        file.path, [&count](const touca::Testcase&) { ++count; });
+    CHECK(count == 2u);
+  }
+
+  SECTION("values written as strings") {
+    const auto& actual = read(
+        R"({"metadata":{"testcase":"alice"},)"
+        R"("results":[{"key":"count","value":"-42"},)"
+        R"({"key":"flag","value":"false"}],)"
+        R"("assertion":[{"key":"valid","value":"true"}],)"
+        R"("metrics":[{"key":"runtime","value":"10"}]})");
+    REQUIRE(actual.size() == 1u);
+    CHECK(actual[0].metrics().at("runtime").value.as_metric() == 10);
+    CHECK(actual[0].overview().keysCount == 3);
+  }
+
+  SECTION("unknown fields") {
+    const auto& actual = read(
+        R"({"metadata":{"testcase":"alice","extra":[1,{"a":2}]},)"
+        R"("extra":{"b":[3]},"results":[{"key":"a","note":"b","value":1}]})");
+    REQUIRE(actual.size() == 1u);
+    CHECK(actual[0].metadata().testcase == "alice");
+    CHECK(actual[0].overview().keysCount == 1);
+  }
+
+  SECTION("invalid input") {
+    CHECK_THROWS_AS(read(R"([{"metadata":)"), touca::detail::runtime_error);
+    CHECK_THROWS_AS(read(R"([1])"), touca::detail::runtime_error);
+    CHECK_THROWS_AS(read(R"({"results":[{"key":"a"}]})"),
+                    touca::detail::runtime_error);
+    CHECK_THROWS_AS(
+        read(R"({"results":[{"key":"a","value":{"x":{},"y":{}}}]})"),
+        touca::detail::runtime_error);
+    CHECK_THROWS_AS(read(R"({"metrics":[{"key":"a","value":-1}]})"),
+                    touca::detail::runtime_error);
+  }
+
+  SECTION("error offset") {
+    CHECK_THROWS_WITH(read(R"({"metadata":x})"),
+                      Catch::Contains("at offset 12:"));
+    std::vector<touca::Testcase> many;
+    for (auto i = 0; i < 1000; ++i) {
+      many.push_back(make_testcase("case-" + std::to_string(i)));
+    }
+    const auto& content = write(many, Layout::Lines);
+    TmpFile file;
+    file.write(content + "{x");
+    const auto& expected =
+        touca::detail::format("at offset {}:", content.size() + 1);
+    CHECK_THROWS_WITH(
+        touca::for_each_json_testcase(file.path, [](const touca::Testcase&) {}),
+        Catch::Contains(expected));
+  }
+}
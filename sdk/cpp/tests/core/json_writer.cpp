@@ -0,0 +1,103 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/json_writer.hpp"
+
+#include "catch2/catch.hpp"
+#include "tests/core/shared.hpp"
+
+namespace {
+
+touca::Testcase make_testcase(const std::string& name) {
+  touca::ResultsMap results;
+  results.emplace("flag", touca::ResultEntry{touca::data_point::boolean(true),
+                                             touca::ResultCategory::Check});
+  results.emplace("name", touca::ResultEntry{touca::data_point::string(name),
+                                             touca::ResultCategory::Check});
+  results.emplace("point",
+                  touca::ResultEntry{touca::object("point").add("x", 1).add(
+                                         "y", std::vector<int>{-2, 3}),
+                                     touca::ResultCategory::Check});
+  results.emplace("ratio",
+                  touca::ResultEntry{touca::data_point::number_double(0.5),
+                                     touca::ResultCategory::Assert});
+  const touca::Testcase::Metadata meta = {"acme", "students", "1.0", name,
+                                          "2023-01-01T00:00:00.000Z"};
+  return touca::Testcase(meta, results, {{"runtime", 10}});
+}
+
+std::string make_expected(const std::string& name) {
+  return touca::detail::format(
+      R"({{"metadata":{{"teamslug":"acme","testsuite":"students",)"
+      R"("version":"1.0","testcase":"{0}",)"
+      R"("builtAt":"2023-01-01T00:00:00.000Z"}},)"
+      R"("results":[{{"key":"flag","value":true}},)"
+      R"({{"key":"name","value":"{0}"}},)"
+      R"({{"key":"point","value":{{"point":{{"x":1,"y":[-2,3]}}}}}}],)"
+      R"("assertion":[{{"key":"ratio","value":0.5}}],)"
+      R"("metrics":[{{"key":"runtime","value":10}}]}})",
+      name);
+}
+
+}  // namespace
+
+TEST_CASE("json writer") {
+  SECTION("array") {
+    std::string output;
+    touca::detail::JsonWriter writer(output);
+    writer.write(make_testcase("alice"));
+    writer.write(make_testcase("bob"));
+    writer.finish();
+    CHECK(output == "[" + make_expected("alice") + "," +
+                        make_expected("bob") + "]");
+  }
+
+  SECTION("empty") {
+    std::string output;
+    touca::detail::JsonWriter writer(output);
+    writer.finish();
+    CHECK(output == "[]");
+  }
+
+  SECTION("lines") {
+    std::string output;
+    touca::detail::JsonWriter writer(output,
+                                     touca::detail::JsonWriter::Layout::Lines);
+    writer.write(make_testcase("alice"));
+    writer.write(make_testcase("bob"));
+    writer.finish();
+    CHECK(output == make_expected("alice") + "\n" + make_expected("bob") + "\n");
+  }
+
+  SECTION("not finished") {
+    std::string output;
+    {
+      touca::detail::JsonWriter writer(
+          output, touca::detail::JsonWriter::Layout::Lines);
+      writer.write(make_testcase("alice"));
+    }
+    CHECK(output == make_expected("alice") + "\n");
+  }
+
+  SECTION("same as testcase json") {
+    const auto& testcase = make_testcase("alice");
+    CHECK(make_json([&testcase](touca::RJAllocator& allocator) {
+            return testcase.json(allocator);
+          }) == make_expected("alice"));
+  }
+
+  SECTION("file") {
+    TmpFile file;
+    std::vector<touca::Testcase> testcases;
+    for (auto i = 0; i < 1000; ++i) {
+      testcases.push_back(make_testcase("case-" + std::to_string(i)));
+    }
+    touca::detail::save_json_file(file.path.string(), testcases);
+    std::string expected;
+    touca::detail::JsonWriter writer(expected);
+    for (const auto& testcase : testcases) {
+      writer.write(testcase);
+    }
+    writer.finish();
+    CHECK(touca::detail::load_text_file(file.path.string()) == expected);
+  }
+}
@@ -133,4 +133,17 @@ TEST_CASE("configure") {
     CHECK(client.configure(b) == true);
     CHECK(!opts.concurrency);
   }
+  SECTION("binary-format") {
+    CHECK(client.configure() == true);
+    CHECK(opts.binary_format == "v1");
+    auto a = [](touca::ClientOptions& x) { x.binary_format = "v2"; };
+    CHECK(client.configure(a) == true);
+    CHECK(opts.binary_format == "v2");
+    auto b = [](touca::ClientOptions& x) { x.binary_format = "v3"; };
+    CHECK(client.configure(b) == true);
+    CHECK(opts.binary_format == "v3");
+    auto c = [](touca::ClientOptions& x) { x.binary_format = "v4"; };
+    CHECK(client.configure(c) == false);
+    CHECK_THAT(client.configuration_error(), Catch::Contains("v4"));
+  }
 }
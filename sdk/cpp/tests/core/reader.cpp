@@ -0,0 +1,77 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/reader.hpp"
+
+#include "catch2/catch.hpp"
+#include "tests/core/shared.hpp"
+#include "touca/client/detail/client.hpp"
+
+TEST_CASE("Result File Reader") {
+  touca::ClientImpl client;
+  REQUIRE_NOTHROW(client.configure([](touca::ClientOptions& x) {
+    x.team = "acme";
+    x.suite = "students";
+    x.version = "1.0";
+    x.offline = true;
+  }));
+  client.declare_testcase("bbrown");
+  client.check("firstname", touca::data_point::string("bob"));
+  client.assume("active", touca::data_point::boolean(true));
+  client.add_metric("duration", 10);
+  client.declare_testcase("aanderson");
+  client.check("firstname", touca::data_point::string("alice"));
+
+  TmpFile file;
+  client.save(file.path, {"bbrown", "aanderson"}, touca::DataFormat::FBS,
+              true);
+
+  SECTION("lookup testcases") {
+    const touca::ResultFile reader(file.path);
+    CHECK(reader.size() == 2u);
+    CHECK(reader.at(0).name() == "bbrown");
+    CHECK(reader.at(1).name() == "aanderson");
+    CHECK(reader.has_testcase("aanderson"));
+    CHECK_FALSE(reader.has_testcase("ccarter"));
+    CHECK(reader.testcase("bbrown").metadata().testsuite == "students");
+    CHECK_THROWS_AS(reader.testcase("ccarter"), touca::detail::runtime_error);
+    CHECK_THROWS_AS(reader.at(2), touca::detail::runtime_error);
+  }
+
+  SECTION("lookup keys") {
+    const touca::ResultFile reader(file.path);
+    const auto& view = reader.testcase("bbrown");
+    CHECK(view.result_keys().size() == 2u);
+    CHECK(view.has_result("active"));
+    CHECK_FALSE(view.has_result("lastname"));
+    CHECK(view.result("firstname").val.to_string() == "bob");
+    CHECK(view.result("firstname").typ == touca::ResultCategory::Check);
+    CHECK(view.result("active").typ == touca::ResultCategory::Assert);
+    CHECK_THROWS_AS(view.result("lastname"), touca::detail::runtime_error);
+    CHECK(view.metric_keys() == std::vector<std::string>{"duration"});
+    CHECK(view.metric("duration") == 10);
+    CHECK(view.decode().overview().keysCount == 2);
+  }
+
+  SECTION("file without index") {
+    const touca::ResultFile indexed(file.path);
+    std::vector<touca::Testcase> testcases = {
+        indexed.at(0).decode(), indexed.at(1).decode()};
+    TmpFile plain;
+    touca::detail::save_binary_file(plain.path.string(),
+                                    touca::Testcase::serialize(testcases));
+    const touca::ResultFile reader(plain.path);
+    CHECK(reader.size() == 2u);
+    CHECK(reader.has_testcase("aanderson"));
+    CHECK(reader.testcase("bbrown").result("firstname").val.to_string() ==
+          "bob");
+    CHECK(touca::filesystem::file_size(plain.path) <
+          touca::filesystem::file_size(file.path));
+  }
+
+  SECTION("invalid file") {
+    TmpFile invalid;
+    invalid.write("some invalid content");
+    CHECK_THROWS_AS(touca::ResultFile(invalid.path),
+                    touca::detail::runtime_error);
+  }
+}
@@ -2,14 +2,23 @@
 
 #include "touca/runner/runner.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <set>
+#include <thread>
 
 #include "catch2/catch.hpp"
 #include "fmt/ostream.h"
 #include "fmt/printf.h"
 #include "tests/core/shared.hpp"
 #include "touca/core/config.hpp"
+#include "touca/core/deserialize.hpp"
 #include "touca/runner/detail/helpers.hpp"
+#include "touca/runner/detail/store.hpp"
 #include "touca/touca.hpp"
 
 const auto dummy_workflow = [](const std::string& testcase) {};
@@ -354,7 +363,7 @@ TEST_CASE("runner-simple-workflow-valid-use") {
         Catch::Contains(
             R"("teamslug":"some-team","testsuite":"some-suite","version":"1.0","testcase":"4")"));
     CHECK_THAT(fileJson,
-               Catch::Contains(R"({"key":"some-number","value":"1024"})"));
+               Catch::Contains(R"({"key":"some-number","value":1024})"));
     CHECK_THAT(fileJson,
                Catch::Contains(R"({"key":"some-string","value":"foo"})"));
     CHECK_THAT(fileJson, Catch::Contains(R"("assertion":[])"));
@@ -385,3 +394,556 @@ TEST_CASE("runner-redirect-output-disabled") {
   }
   touca::detail::reset_test_runner();
 }
+
+TEST_CASE("runner-consolidated-results") {
+  using fnames = std::vector<touca::filesystem::path>;
+  touca::workflow("simple_workflow", simple_workflow);
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  const std::vector<std::string> args = {
+      "--offline",     "--revision",      "1.0",
+      "--testcase",    "4,8,15,16,23,42", "--output-directory",
+      outputDir.path.string(),            "--config-file",
+      configFile.path.string(),           "--save-as-json",
+      "--consolidate", "--no-color"};
+  caller.call_with(args);
+
+  SECTION("directory-structure") {
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    fnames revisionFiles = ResultChecker(fnames({outputDir.path, "some-suite"}))
+                               .get_regular_files("1.0");
+    fnames revisionDirs = ResultChecker(fnames({outputDir.path, "some-suite"}))
+                              .get_directories("1.0");
+    CHECK_THAT(revisionFiles,
+               Catch::UnorderedEquals(fnames(
+                   {"Console.log", "touca.log", "touca.seg", "touca.idx"})));
+    CHECK(revisionDirs.empty());
+  }
+
+  SECTION("content") {
+    touca::detail::ResultStore store(outputDir.path / "some-suite" / "1.0");
+    CHECK(store.testcases().size() == 6u);
+    CHECK(store.contains("4", false));
+    CHECK_FALSE(store.contains("42", false));
+    const auto& record = store.read("8");
+    CHECK(record.cout == "simple message in output stream\n");
+    CHECK(record.cerr == "simple message in error stream\n");
+    CHECK_THAT(store.read("4").json,
+               Catch::Contains(R"({"key":"some-string","value":"foo"})"));
+  }
+
+  SECTION("second-run-without-overwrite") {
+    caller.call_with(args);
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("5.  SKIP   23"));
+    CHECK_THAT(caller.cout(), Catch::Contains("5 skipped, 1 failed, 6 total"));
+  }
+  touca::detail::reset_test_runner();
+}
+
+TEST_CASE("runner-result-queue") {
+  using touca::detail::ResultQueue;
+  using Status = touca::Post::Status;
+  std::vector<ResultQueue::Result> reported;
+  const auto report = [&reported](const ResultQueue::Result& result) {
+    reported.push_back(result);
+  };
+
+  SECTION("results are reported in order") {
+    ResultQueue queue(2, report);
+    for (auto i = 0u; i < 10u; ++i) {
+      queue.poll();
+      if (i % 3 == 0) {
+        queue.push({i, std::to_string(i), Status::Skip, {}}, nullptr);
+        continue;
+      }
+      queue.push({i, std::to_string(i), Status::Fail, {}}, [i]() -> Status {
+        if (i == 5) {
+          throw std::runtime_error("some-error");
+        }
+        return Status::Sent;
+      });
+    }
+    queue.drain();
+    REQUIRE(reported.size() == 10u);
+    for (auto i = 0u; i < 10u; ++i) {
+      CHECK(reported[i].index == i);
+    }
+    CHECK(reported[3].status == Status::Skip);
+    CHECK(reported[4].status == Status::Sent);
+    CHECK(reported[5].status == Status::Fail);
+    CHECK(reported[5].errors == std::vector<std::string>({"some-error"}));
+  }
+
+  SECTION("queued tasks finish before the queue is destroyed") {
+    auto count = 0;
+    {
+      ResultQueue queue(4, report);
+      for (auto i = 0u; i < 4u; ++i) {
+        queue.push({i, std::to_string(i), Status::Fail, {}}, [&count]() {
+          ++count;
+          return Status::Sent;
+        });
+      }
+    }
+    CHECK(count == 4);
+  }
+}
+
+TEST_CASE("runner-parallel-workflow") {
+  touca::workflow("simple_workflow", simple_workflow);
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--testcase", "4,8,15,16,23,42",
+                    "--save-as-json", "--jobs", "3", "--no-color"});
+
+  SECTION("progress") {
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    const auto& output = caller.cout();
+    CHECK(output.find("1.  SENT   4") < output.find("2.  SENT   8"));
+    CHECK(output.find("5.  SENT   23") < output.find("6.  FAIL   42"));
+    CHECK_THAT(output, Catch::Contains("5 submitted, 1 failed, 6 total"));
+    CHECK_THAT(output,
+               Catch::Not(Catch::Contains("simple message in output stream")));
+  }
+
+  SECTION("directory-content") {
+    const auto& caseDir = outputDir.path / "some-suite" / "1.0";
+    CHECK(touca::detail::load_text_file((caseDir / "8" / "stdout.txt")
+                                            .string()) ==
+          "simple message in output stream\n");
+    CHECK_THAT(
+        touca::detail::load_text_file((caseDir / "4" / "touca.json").string()),
+        Catch::Contains(R"({"key":"some-number","value":1024})"));
+    CHECK_FALSE(touca::filesystem::exists(caseDir / "15" / "stdout.txt"));
+  }
+  touca::detail::reset_test_runner();
+}
+
+TEST_CASE("runner-repeated-testcases") {
+  touca::workflow("simple_workflow", simple_workflow);
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--testcase", "4,8,4,15,8",
+                    "--jobs", "3", "--no-color"});
+
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  const auto& output = caller.cout();
+  CHECK_THAT(output, Catch::Contains("skipped testcase 4: listed more"));
+  CHECK_THAT(output, Catch::Contains("skipped testcase 8: listed more"));
+  CHECK_THAT(output, Catch::Contains("3 submitted, 3 total"));
+  touca::detail::reset_test_runner();
+}
+
+TEST_CASE("runner-testcase-file") {
+  touca::workflow("simple_workflow", simple_workflow);
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  TmpFile testcaseFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  testcaseFile.write("4\n8\n\n15\r\n16\n23\n42\n");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--testcase-file",
+                    testcaseFile.path.string(), "--save-as-json", "--jobs",
+                    "3", "--no-color"});
+
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  const auto& output = caller.cout();
+  CHECK(output.find("1.  SENT   4") < output.find("2.  SENT   8"));
+  CHECK(output.find("5.  SENT   23") < output.find("6.  FAIL   42"));
+  CHECK_THAT(output, Catch::Contains("5 submitted, 1 failed, 6 total"));
+  CHECK(touca::filesystem::is_directory(outputDir.path / "some-suite" /
+                                        "1.0" / "15"));
+  touca::detail::reset_test_runner();
+}
+
+#ifndef _WIN32
+TEST_CASE("runner-isolated-workflow") {
+  touca::workflow("crashing_workflow", [](const std::string& testcase) {
+    if (testcase == "16") {
+      std::raise(SIGKILL);
+    }
+    simple_workflow(testcase);
+  });
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--testcase", "4,8,15,16,23,42",
+                    "--save-as-json", "--isolate", "--jobs", "2",
+                    "--no-color"});
+
+  SECTION("progress") {
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    const auto& output = caller.cout();
+    CHECK(output.find("3.  SENT   15") < output.find("4.  FAIL   16"));
+    CHECK(output.find("4.  FAIL   16") < output.find("5.  SENT   23"));
+    CHECK_THAT(output, Catch::Contains("terminated by signal"));
+    CHECK_THAT(output, Catch::Contains("4 submitted, 2 failed, 6 total"));
+  }
+
+  SECTION("directory-content") {
+    const auto& caseDir = outputDir.path / "some-suite" / "1.0";
+    CHECK(touca::detail::load_text_file((caseDir / "8" / "stdout.txt")
+                                            .string()) ==
+          "simple message in output stream\n");
+    CHECK_THAT(
+        touca::detail::load_text_file((caseDir / "4" / "touca.json").string()),
+        Catch::Contains(R"({"key":"some-number","value":1024})"));
+    CHECK_FALSE(touca::filesystem::exists(caseDir / "16" / "touca.json"));
+  }
+  touca::detail::reset_test_runner();
+}
+#endif
+
+#ifndef _WIN32
+TEST_CASE("runner-process-per-testcase") {
+  static auto resources = 0;
+  static auto calls = 0;
+  touca::workflow(
+      "forking_workflow",
+      [](const std::string& testcase) {
+        touca::check("resources", resources);
+        touca::check("calls", ++calls);
+      },
+      [](touca::WorkflowOptions& w) {
+        w.setup = []() { resources = 1024; };
+      });
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--testcase", "4,8,15,16",
+                    "--save-as-json", "--isolate", "--testcases-per-process",
+                    "1", "--no-color"});
+
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK_THAT(caller.cout(), Catch::Contains("4 submitted, 4 total"));
+  CHECK(resources == 1024);
+  CHECK(calls == 0);
+  const auto& caseDir = outputDir.path / "some-suite" / "1.0";
+  for (const auto& testcase : {"4", "16"}) {
+    const auto& content = touca::detail::load_text_file(
+        (caseDir / testcase / "touca.json").string());
+    CHECK_THAT(content, Catch::Contains(R"({"key":"calls","value":1})"));
+    CHECK_THAT(content,
+               Catch::Contains(R"({"key":"resources","value":1024})"));
+  }
+  touca::detail::reset_test_runner();
+}
+#endif
+
+TEST_CASE("runner-workflow-fixtures") {
+  struct Dataset {
+    explicit Dataset(const int size) : size(size) {}
+    int size;
+  };
+  static std::atomic<int> workers(0);
+  static auto teardowns = 0;
+  touca::workflow<Dataset>(
+      "fixture_workflow", []() { return Dataset(1024); },
+      [](const std::string& testcase, Dataset& dataset) {
+        touca::check("size", dataset.size);
+      },
+      [](touca::WorkflowOptions& w) {
+        w.worker_setup = []() { ++workers; };
+        w.teardown = []() { ++teardowns; };
+      });
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--testcase", "4,8,15,16",
+                    "--save-as-json", "--jobs", "2", "--no-color"});
+
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK(workers == 2);
+  CHECK(teardowns == 1);
+  CHECK_THAT(caller.cout(), Catch::Contains("4 submitted, 4 total"));
+  CHECK_THAT(caller.cout(), Catch::Contains("s in workers)"));
+  CHECK_THAT(caller.cout(), Catch::Contains("Teardown:"));
+  CHECK_THAT(touca::detail::load_text_file(
+                 (outputDir.path / "some-suite" / "1.0" / "8" / "touca.json")
+                     .string()),
+             Catch::Contains(R"({"key":"size","value":1024})"));
+  touca::detail::reset_test_runner();
+}
+
+TEST_CASE("runner-teardown-on-error") {
+  static auto teardowns = 0;
+  touca::workflow(
+      "failing_workflow",
+      [](const std::string& testcase) { touca::check("testcase", testcase); },
+      [](touca::WorkflowOptions& w) {
+        w.setup = []() {};
+        w.teardown = []() { ++teardowns; };
+        w.testcase_source = []() -> touca::TestcaseGenerator {
+          auto count = 0;
+          return [count](std::string& testcase) mutable {
+            if (++count == 3) {
+              throw std::runtime_error("source is unavailable");
+            }
+            testcase = std::to_string(count);
+            return true;
+          };
+        };
+      });
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--save-as-json",
+                    "--no-color"});
+
+  CHECK(teardowns == 1);
+  CHECK_THAT(caller.cout(), Catch::Contains("source is unavailable"));
+  CHECK_THAT(caller.cout(), !Catch::Contains("Teardown:"));
+  touca::detail::reset_test_runner();
+}
+
+TEST_CASE("runner-prefetch-input") {
+  static std::atomic<int> loads(0);
+  touca::workflow<std::string>(
+      "prefetch_workflow",
+      [](const std::string& testcase) -> std::string {
+        ++loads;
+        if (testcase == "15") {
+          throw std::runtime_error("missing input");
+        }
+        return "input of " + testcase;
+      },
+      [](const std::string& testcase, std::string& input) {
+        touca::check("input", input);
+      });
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--testcase", "4,8,15,16",
+                    "--save-as-json", "--prefetch", "2", "--prefetch-memory",
+                    "1", "--no-color"});
+
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK(loads == 4);
+  CHECK_THAT(caller.cout(), Catch::Contains("3 submitted, 1 failed, 4 total"));
+  CHECK_THAT(caller.cout(), Catch::Contains("missing input"));
+  CHECK_THAT(touca::detail::load_text_file(
+                 (outputDir.path / "some-suite" / "1.0" / "8" / "touca.json")
+                     .string()),
+             Catch::Contains(R"({"key":"input","value":"input of 8"})"));
+  touca::detail::reset_test_runner();
+}
+
+TEST_CASE("runner-result-cache") {
+  static auto calls = 0;
+  touca::workflow(
+      "cached_workflow",
+      [](const std::string& testcase) {
+        ++calls;
+        std::cout << "output of " << testcase << std::endl;
+        touca::check("testcase", testcase);
+      },
+      [](touca::WorkflowOptions& w) {
+        w.fingerprint = [](const std::string& testcase) {
+          return testcase == "15" ? std::to_string(calls) : "unchanged";
+        };
+      });
+  TmpFile outputDir;
+  TmpFile cacheDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  const auto& run = [&](const std::string& revision) {
+    MainCaller caller;
+    caller.call_with({"--offline", "--revision", revision,
+                      "--output-directory", outputDir.path.string(),
+                      "--config-file", configFile.path.string(), "--testcase",
+                      "4,8,15", "--save-as-json", "--cache-directory",
+                      cacheDir.path.string(), "--code-version", "abc",
+                      "--no-color"});
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    CHECK_THAT(caller.cout(), Catch::Contains("3 submitted, 3 total"));
+  };
+
+  run("1.0");
+  CHECK(calls == 3);
+  run("1.1");
+  CHECK(calls == 4);
+  const auto& caseDir = outputDir.path / "some-suite" / "1.1" / "8";
+  const auto& content =
+      touca::detail::load_text_file((caseDir / "touca.json").string());
+  CHECK_THAT(content, Catch::Contains(R"("version":"1.1")"));
+  CHECK_THAT(content, Catch::Contains(R"({"key":"testcase","value":"8"})"));
+  CHECK(touca::detail::load_text_file((caseDir / "stdout.txt").string()) ==
+        "output of 8\n");
+  touca::detail::reset_test_runner();
+}
+
+TEST_CASE("runner-duration-scheduling") {
+  touca::workflow(
+      "timed_workflow",
+      [](const std::string& testcase) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(
+            testcase == "15" ? 60 : testcase == "8" ? 30 : 0));
+      },
+      [](touca::WorkflowOptions& w) {
+        w.fingerprint = [](const std::string& testcase) { return testcase; };
+      });
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  const auto& run = [&](const std::vector<std::string>& extra) {
+    std::vector<std::string> args = {"--offline", "--revision", "1.0",
+                                     "--output-directory",
+                                     outputDir.path.string(), "--config-file",
+                                     configFile.path.string(), "--testcase",
+                                     "4,8,15", "--no-color"};
+    args.insert(args.end(), extra.begin(), extra.end());
+    MainCaller caller;
+    caller.call_with(args);
+    CHECK(caller.exit_code() == EXIT_SUCCESS);
+    return caller.cout();
+  };
+  const auto& durations_file =
+      outputDir.path / "some-suite" / "touca.durations";
+
+  SECTION("longest-first") {
+    const auto& first = run({"--longest-first"});
+    CHECK(first.find("1.  SENT   4") < first.find("3.  SENT   15"));
+    CHECK(touca::filesystem::exists(durations_file));
+    const auto& second = run({"--longest-first"});
+    CHECK(second.find("1.  SENT   15") < second.find("2.  SENT   8"));
+    CHECK(second.find("2.  SENT   8") < second.find("3.  SENT   4"));
+  }
+
+  SECTION("time-budget") {
+    touca::filesystem::create_directories(durations_file.parent_path());
+    std::ofstream(durations_file.string()) << "5000\t15\n10\t8\n10\t4\n";
+    const auto& output = run({"--time-budget", "1"});
+    CHECK_THAT(output, Catch::Contains("2 submitted, 1 skipped, 3 total"));
+  }
+
+  SECTION("reused results") {
+    TmpFile cacheDir;
+    run({"--longest-first", "--cache-directory", cacheDir.path.string()});
+    std::ofstream(durations_file.string()) << "7\t15\n7\t8\n7\t4\n";
+    run({"--longest-first", "--cache-directory", cacheDir.path.string()});
+    const auto& content =
+        touca::detail::load_text_file(durations_file.string());
+    CHECK_THAT(content, Catch::Contains("7\t15\n"));
+    CHECK_THAT(content, Catch::Contains("7\t8\n"));
+  }
+  touca::detail::reset_test_runner();
+}
+
+TEST_CASE("runner-sharding") {
+  touca::workflow("sharded_workflow", [](const std::string& testcase) {
+    touca::check("testcase", testcase);
+  });
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  const auto& run = [&](const std::string& index) {
+    MainCaller caller;
+    caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                      outputDir.path.string(), "--config-file",
+                      configFile.path.string(), "--testcase", "a,b,c,d,e,f",
+                      "--shard-count", "2", "--shard-index", index,
+                      "--save-as-binary", "--no-color"});
+    return caller.exit_code();
+  };
+  const auto& read_shard = [&](const std::string& name) {
+    std::set<std::string> testcases;
+    touca::for_each_testcase(
+        outputDir.path / "some-suite" / "1.0" / name,
+        [&testcases](const touca::Testcase& testcase) {
+          testcases.insert(testcase.metadata().testcase);
+        });
+    return testcases;
+  };
+
+  SECTION("testcases are split by a stable hash of their name") {
+    CHECK(run("0") == EXIT_SUCCESS);
+    CHECK(run("1") == EXIT_SUCCESS);
+    CHECK(read_shard("shard-0-of-2.bin") ==
+          std::set<std::string>({"a", "c", "e"}));
+    CHECK(read_shard("shard-1-of-2.bin") ==
+          std::set<std::string>({"b", "d", "f"}));
+  }
+
+  SECTION("testcases processed by an earlier run") {
+    const auto& shard_file =
+        outputDir.path / "some-suite" / "1.0" / "shard-0-of-2.bin";
+    CHECK(run("0") == EXIT_SUCCESS);
+    touca::filesystem::remove(shard_file);
+    CHECK(run("0") == EXIT_SUCCESS);
+    CHECK(read_shard("shard-0-of-2.bin") ==
+          std::set<std::string>({"a", "c", "e"}));
+  }
+
+  SECTION("invalid shard index") {
+    CHECK(run("2") == EXIT_FAILURE);
+  }
+  touca::detail::reset_test_runner();
+}
+
+#ifndef _WIN32
+TEST_CASE("runner-capture-descriptors") {
+  touca::workflow("printing_workflow", [](const std::string& testcase) {
+    std::printf("printed by %s\n", testcase.c_str());
+    std::fprintf(stderr, "%s\n", std::string(100, 'x').c_str());
+  });
+  MainCaller caller;
+  TmpFile outputDir;
+  TmpFile configFile;
+  configFile.write(
+      R"({ "touca": { "api-url": "https://api.touca.io/@/some-team/some-suite" } })");
+  caller.call_with({"--offline", "--revision", "1.0", "--output-directory",
+                    outputDir.path.string(), "--config-file",
+                    configFile.path.string(), "--testcase", "4,8",
+                    "--capture-descriptors", "--output-limit", "64",
+                    "--no-color"});
+
+  CHECK(caller.exit_code() == EXIT_SUCCESS);
+  CHECK_THAT(caller.cout(), Catch::Contains("2 submitted, 2 total"));
+  const auto& caseDir = outputDir.path / "some-suite" / "1.0" / "8";
+  CHECK(touca::detail::load_text_file((caseDir / "stdout.txt").string()) ==
+        "printed by 8\n");
+  CHECK(touca::detail::load_text_file((caseDir / "stderr.txt").string()) ==
+        std::string(64, 'x') + "\n[37 more bytes of output were discarded]\n");
+  touca::detail::reset_test_runner();
+}
+#endif
@@ -0,0 +1,112 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/runner/detail/store.hpp"
+
+#include <fstream>
+
+#include "catch2/catch.hpp"
+#include "tests/core/shared.hpp"
+
+namespace {
+
+touca::detail::ResultRecord make_record(const std::string& json,
+                                        const std::string& cout = "") {
+  touca::detail::ResultRecord record;
+  record.json = json;
+  record.cout = cout;
+  return record;
+}
+
+}  // namespace
+
+TEST_CASE("result store") {
+  using touca::detail::ResultStore;
+  TmpFile dir;
+
+  SECTION("empty") {
+    ResultStore store(dir.path);
+    CHECK(store.testcases().empty());
+    CHECK_FALSE(store.contains("alice", false));
+    CHECK_THROWS_AS(store.read("alice"), touca::detail::runtime_error);
+    CHECK(touca::filesystem::exists(dir.path / "touca.seg"));
+    CHECK(touca::filesystem::exists(dir.path / "touca.idx"));
+  }
+
+  SECTION("append and read back") {
+    {
+      ResultStore store(dir.path);
+      touca::detail::ResultRecord record;
+      record.binary = std::string("\x00\x01\x02", 3);
+      record.cerr = "some error";
+      store.append("alice", record);
+      store.append("bob", make_record(R"({"a":1})"));
+      CHECK(store.contains("alice", true));
+      CHECK_FALSE(store.contains("alice", false));
+      CHECK(store.contains("bob", false));
+      CHECK(store.read("alice").binary == std::string("\x00\x01\x02", 3));
+    }
+    ResultStore store(dir.path);
+    CHECK(store.testcases() == std::vector<std::string>({"alice", "bob"}));
+    const auto& record = store.read("alice");
+    CHECK(record.binary == std::string("\x00\x01\x02", 3));
+    CHECK(record.json.empty());
+    CHECK(record.cout.empty());
+    CHECK(record.cerr == "some error");
+    CHECK(store.read("bob").json == R"({"a":1})");
+  }
+
+  SECTION("most recent record wins") {
+    {
+      ResultStore store(dir.path);
+      store.append("alice", make_record("first"));
+      store.append("bob", make_record("second"));
+      store.append("alice", make_record("", "third"));
+    }
+    ResultStore store(dir.path);
+    CHECK(store.testcases() == std::vector<std::string>({"alice", "bob"}));
+    CHECK_FALSE(store.contains("alice", false));
+    CHECK(store.read("alice").cout == "third");
+  }
+
+  SECTION("missing index") {
+    {
+      ResultStore store(dir.path);
+      store.append("alice", make_record("first"));
+      store.append("bob", make_record("second"));
+    }
+    touca::filesystem::remove(dir.path / "touca.idx");
+    ResultStore store(dir.path);
+    CHECK(store.testcases() == std::vector<std::string>({"alice", "bob"}));
+    CHECK(store.read("bob").json == "second");
+  }
+
+  SECTION("incomplete record") {
+    {
+      ResultStore store(dir.path);
+      store.append("alice", make_record("first"));
+    }
+    const auto size = touca::filesystem::file_size(dir.path / "touca.seg");
+    {
+      std::ofstream out((dir.path / "touca.seg").string(),
+                        std::ios::binary | std::ios::app);
+      out.write("\x05\x00\x00\x00\x02", 5);
+    }
+    {
+      ResultStore store(dir.path);
+      CHECK(store.testcases() == std::vector<std::string>({"alice"}));
+      CHECK(touca::filesystem::file_size(dir.path / "touca.seg") == size);
+      store.append("bob", make_record("second"));
+    }
+    ResultStore store(dir.path);
+    CHECK(store.read("alice").json == "first");
+    CHECK(store.read("bob").json == "second");
+  }
+
+  SECTION("invalid segment") {
+    touca::filesystem::create_directories(dir.path);
+    std::ofstream out((dir.path / "touca.seg").string());
+    out << "invalid";
+    out.close();
+    CHECK_THROWS_AS(ResultStore(dir.path), touca::detail::runtime_error);
+  }
+}
@@ -0,0 +1,41 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/string_table.hpp"
+
+#include "catch2/catch.hpp"
+#include "touca/core/filesystem.hpp"
+#include "touca/core/types.hpp"
+
+TEST_CASE("string table") {
+  SECTION("pool") {
+    touca::detail::StringPool pool;
+    CHECK(pool.add("some-key") == 0u);
+    CHECK(pool.add("some-other-key") == 1u);
+    CHECK(pool.add("some-key") == 0u);
+    CHECK(pool.strings().size() == 2u);
+    CHECK(touca::detail::StringPool::is_shareable("some-value"));
+    CHECK_FALSE(touca::detail::StringPool::is_shareable(std::string(65, 'a')));
+  }
+
+  SECTION("collect") {
+    touca::detail::StringPool pool;
+    touca::array names;
+    names.add(std::string("alice")).add(std::string(65, 'b'));
+    pool.collect(touca::object("student").add("names", names).add("age", 21));
+    const std::vector<std::string> expected = {"age", "alice", "names",
+                                               "student"};
+    CHECK(pool.strings() == expected);
+    pool.freeze();
+    CHECK(pool.add("names") == 2u);
+    CHECK_THROWS_AS(pool.add("grade"), touca::detail::runtime_error);
+  }
+
+  SECTION("lookup") {
+    const touca::detail::StringTable table({"some-key", "some-other-key"});
+    CHECK(table.size() == 2u);
+    CHECK(std::string(table.get(nullptr, 1)) == "some-other-key");
+    CHECK_THROWS_AS(table.get(nullptr, 2), touca::detail::runtime_error);
+    CHECK_THROWS_AS(touca::detail::StringTable().get(nullptr, 0),
+                    touca::detail::runtime_error);
+  }
+}
@@ -5,7 +5,9 @@
 #include <array>
 
 #include "catch2/catch.hpp"
+#include "flatbuffers/flatbuffers.h"
 #include "tests/core/shared.hpp"
+#include "touca/core/string_table.hpp"
 
 using touca::data_point;
 using touca::detail::internal_type;
@@ -37,7 +39,7 @@ TEST_CASE("Testcase") {
       testcase.add_hit_count("some-other-key");
       testcase.add_hit_count("some-key");
       const auto expected =
-          R"("results":[{"key":"some-key","value":"2"},{"key":"some-other-key","value":"1"}])";
+          R"("results":[{"key":"some-key","value":2},{"key":"some-other-key","value":1}])";
       const auto output = make_json([&testcase](touca::RJAllocator& allocator) {
         return testcase.json(allocator);
       });
@@ -72,7 +74,7 @@ TEST_CASE("Testcase") {
         testcase.add_array_element("some-key", value);
       }
       const auto expected =
-          R"("results":[{"key":"some-key","value":"[0,1,2]"}])";
+          R"("results":[{"key":"some-key","value":[0,1,2]}])";
       const auto output = make_json([&testcase](touca::RJAllocator& allocator) {
         return testcase.json(allocator);
       });
@@ -113,10 +115,10 @@ TEST_CASE("Testcase") {
     });
 
     const auto check1 =
-        R"("results":[{"key":"some-array","value":"[true]"},{"key":"some-key","value":"true"},{"key":"some-new-key","value":"1"}])";
+        R"("results":[{"key":"some-array","value":[true]},{"key":"some-key","value":true},{"key":"some-new-key","value":1}])";
     const auto check2 =
-        R"("assertion":[{"key":"some-other-key","value":"true"}])";
-    const auto check3 = R"("metrics":[{"key":"some-metric","value":"0"}])";
+        R"("assertion":[{"key":"some-other-key","value":true}])";
+    const auto check3 = R"("metrics":[{"key":"some-metric","value":0}])";
     const auto check4 = R"("results":[],"assertion":[],"metrics":[])";
     CHECK_THAT(before, Catch::Contains(check1));
     CHECK_THAT(before, Catch::Contains(check2));
@@ -188,4 +190,32 @@ TEST_CASE("Testcase") {
       CHECK(internal_type::number_signed == metric.value.type());
     }
   }
+
+  SECTION("encode") {
+    testcase.check("some-key", data_point::number_signed(1));
+    flatbuffers::FlatBufferBuilder builder;
+    const auto& first = testcase.encode(builder, touca::BinaryFormat::V1);
+    CHECK(first == testcase.flatbuffers());
+    builder.Clear();
+    CHECK(&testcase.encode(builder, touca::BinaryFormat::V1) == &first);
+    CHECK(builder.GetSize() == 0u);
+
+    const auto copy = testcase;
+    testcase.check("some-other-key", data_point::boolean(true));
+    CHECK(&copy.encode(builder, touca::BinaryFormat::V1) == &first);
+    CHECK(testcase.encode(builder, touca::BinaryFormat::V1) ==
+          testcase.flatbuffers());
+
+    CHECK_THROWS_AS(testcase.encode(builder, touca::BinaryFormat::V2),
+                    touca::detail::runtime_error);
+    touca::detail::StringPool pool;
+    builder.Clear();
+    const auto& pooled =
+        testcase.encode(builder, touca::BinaryFormat::V2, &pool);
+    touca::detail::StringPool other;
+    other.add("some-string");
+    builder.Clear();
+    CHECK(&testcase.encode(builder, touca::BinaryFormat::V2, &other) !=
+          &pooled);
+  }
 }
@@ -0,0 +1,209 @@
+// Copyright 2023 Touca, Inc. Subject to Apache-2.0 License.
+
+#include "touca/core/writer.hpp"
+
+#include "catch2/catch.hpp"
+#include "flatbuffers/flatbuffers.h"
+#include "touca/core/deserialize.hpp"
+#include "touca/core/reader.hpp"
+#include "touca/impl/schema.hpp"
+
+TEST_CASE("messages writer") {
+  std::vector<touca::Testcase> testcases;
+  for (auto i = 0; i < 20; ++i) {
+    touca::Testcase testcase("acme", "students", "1.0",
+                             "case-" + std::to_string(i));
+    for (auto j = 0; j < 20; ++j) {
+      testcase.check("key-" + std::to_string(j),
+                     touca::data_point::string(std::to_string(i * j)));
+    }
+    testcases.push_back(testcase);
+  }
+
+  SECTION("output") {
+    touca::detail::MessagesWriter writer;
+    writer.write(testcases);
+    CHECK(std::vector<std::uint8_t>(writer.data(),
+                                    writer.data() + writer.size()) ==
+          touca::Testcase::serialize(testcases));
+    flatbuffers::Verifier verifier(writer.data(), writer.size());
+    REQUIRE(verifier.VerifyBuffer<touca::fbs::Messages>());
+    const auto& messages = touca::fbs::GetMessages(writer.data())->messages();
+    REQUIRE(messages->size() == 20u);
+    const auto& testcase =
+        touca::deserialize_testcase(messages->Get(7)->buf_nested_root());
+    CHECK(testcase.metadata().testcase == "case-7");
+    CHECK(testcase.overview().keysCount == 20);
+  }
+
+  SECTION("parallel") {
+    // enough testcases for each thread to get more than one chunk
+    while (testcases.size() < 200) {
+      testcases.push_back(testcases[testcases.size() % 20]);
+    }
+    for (const auto format :
+         {touca::BinaryFormat::V1, touca::BinaryFormat::V2,
+          touca::BinaryFormat::V3}) {
+      touca::detail::MessagesWriter sequential;
+      sequential.write(testcases, format);
+      // copies of testcases share their encodings until they are changed
+      auto copies = testcases;
+      for (auto& testcase : copies) {
+        testcase.setMetadata(testcase.metadata());
+      }
+      touca::detail::MessagesWriter parallel;
+      parallel.write(copies, format, 4);
+      parallel.write(copies, format, 4);
+      CHECK(std::vector<std::uint8_t>(parallel.data(),
+                                      parallel.data() + parallel.size()) ==
+            std::vector<std::uint8_t>(sequential.data(),
+                                      sequential.data() + sequential.size()));
+    }
+  }
+
+  SECTION("buffers are reused") {
+    touca::detail::MessagesWriter writer;
+    writer.write(testcases, touca::BinaryFormat::V2);
+    CHECK(0u < writer.stats().allocations);
+    const auto before = writer.stats();
+    writer.write(testcases, touca::BinaryFormat::V2);
+    const auto after = writer.stats();
+
+    // writing the same content again reuses the encodings of testcases
+    // and fits in the buffers allocated for the first call, so each
+    // message is copied only once, into the output buffer.
+    std::uint64_t message_bytes = 0;
+    for (const auto&& item :
+         *touca::fbs::GetMessages(writer.data())->messages()) {
+      message_bytes += item->buf()->size();
+    }
+    CHECK(after.allocations == before.allocations);
+    CHECK(after.bytes_copied - before.bytes_copied == message_bytes);
+  }
+
+  SECTION("fresh encodings are copied twice") {
+    touca::detail::MessagesWriter writer;
+    writer.write(testcases, touca::BinaryFormat::V2);
+    // invalidates the encoding of a testcase without changing its content
+    // and with it the size of any buffer.
+    testcases[3].setMetadata(testcases[3].metadata());
+    const auto before = writer.stats();
+    writer.write(testcases, touca::BinaryFormat::V2);
+    const auto after = writer.stats();
+
+    // the changed testcase is copied into its new encoding and then into
+    // the output buffer. other testcases are only copied into the output.
+    const auto& messages = *touca::fbs::GetMessages(writer.data())->messages();
+    std::uint64_t message_bytes = 0;
+    for (const auto&& item : messages) {
+      message_bytes += item->buf()->size();
+    }
+    CHECK(after.allocations - before.allocations == 1u);
+    CHECK(after.bytes_copied - before.bytes_copied ==
+          message_bytes + messages.Get(3)->buf()->size());
+  }
+
+  SECTION("changed testcases are encoded again") {
+    touca::detail::MessagesWriter writer;
+    writer.write(testcases, touca::BinaryFormat::V2);
+    testcases[3].check("new-key", touca::data_point::boolean(true));
+    writer.write(testcases, touca::BinaryFormat::V2);
+    CHECK(std::vector<std::uint8_t>(writer.data(),
+                                    writer.data() + writer.size()) ==
+          touca::Testcase::serialize(testcases, touca::BinaryFormat::V2));
+    const auto& messages = touca::fbs::GetMessages(writer.data());
+    const auto& testcase = touca::deserialize_testcase(
+        messages->messages()->Get(3)->buf_nested_root(),
+        touca::detail::StringTable(messages));
+    CHECK(testcase.overview().keysCount == 21);
+  }
+}
+
+TEST_CASE("messages merger") {
+  std::vector<touca::Testcase> testcases;
+  for (auto i = 0; i < 20; ++i) {
+    touca::Testcase testcase("acme", "students", "1.0",
+                             "case-" + std::to_string(i));
+    for (auto j = 0; j < 5; ++j) {
+      testcase.check("key-" + std::to_string(j),
+                     touca::data_point::string(std::to_string(i * j)));
+    }
+    testcases.push_back(testcase);
+  }
+  const std::vector<touca::Testcase> first(testcases.begin(),
+                                           testcases.begin() + 10);
+  const std::vector<touca::Testcase> second(testcases.begin() + 10,
+                                            testcases.end());
+  const auto& v1 = touca::Testcase::serialize(first);
+  const auto& v2 =
+      touca::Testcase::serialize(second, touca::BinaryFormat::V2);
+  const auto& read = [](const touca::detail::MessagesMerger& merger) {
+    std::vector<touca::Testcase> items;
+    flatbuffers::Verifier verifier(merger.data(), merger.size());
+    REQUIRE(verifier.VerifyBuffer<touca::fbs::Messages>());
+    const auto& messages = touca::fbs::GetMessages(merger.data());
+    for (const auto&& item : *messages->messages()) {
+      items.push_back(touca::deserialize_testcase(
+          item->buf_nested_root(), touca::detail::StringTable(messages)));
+    }
+    return items;
+  };
+
+  SECTION("testcases without shared strings are copied") {
+    touca::detail::MessagesMerger merger;
+    merger.add(v1.data(), v1.size());
+    merger.finish();
+    CHECK(merger.count() == 10u);
+    CHECK(std::vector<std::uint8_t>(merger.data(),
+                                    merger.data() + merger.size()) == v1);
+  }
+
+  SECTION("testcases with shared strings are encoded again") {
+    for (const auto format :
+         {touca::BinaryFormat::V1, touca::BinaryFormat::V2,
+          touca::BinaryFormat::V3}) {
+      touca::detail::MessagesMerger merger(format);
+      merger.add(v1.data(), v1.size());
+      merger.add(v2.data(), v2.size());
+      merger.finish();
+      const auto& items = read(merger);
+      REQUIRE(items.size() == 20u);
+      CHECK(items[15].metadata().testcase == "case-15");
+      CHECK(items[15].overview().keysCount == 5);
+      CHECK(items[15].flatbuffers() == testcases[15].flatbuffers());
+    }
+  }
+
+  SECTION("testcases are stored in the format of the output") {
+    for (const auto format :
+         {touca::BinaryFormat::V1, touca::BinaryFormat::V2,
+          touca::BinaryFormat::V3}) {
+      touca::detail::MessagesMerger merger(format);
+      merger.add(v1.data(), v1.size());
+      merger.finish();
+      REQUIRE(read(merger).size() == 10u);
+      const auto& messages = touca::fbs::GetMessages(merger.data());
+      const auto& shared = messages->strings();
+      CHECK((shared && shared->size() != 0) ==
+            (format != touca::BinaryFormat::V1));
+      for (const auto&& item : *messages->messages()) {
+        const auto& results = item->buf_nested_root()->results()->entries();
+        for (const auto&& result : *results) {
+          CHECK((result->key() != nullptr) ==
+                (format == touca::BinaryFormat::V1));
+        }
+      }
+    }
+  }
+
+  SECTION("filter") {
+    touca::detail::MessagesMerger merger;
+    merger.add(v2.data(), v2.size(), [](const touca::TestcaseView& testcase) {
+      return testcase.name() != "case-13";
+    });
+    merger.finish();
+    const auto& items = read(merger);
+    REQUIRE(items.size() == 9u);
+    CHECK(items[3].metadata().testcase == "case-14");
+  }
+}